@@ -0,0 +1,107 @@
+#ifndef BUFFER_ADDRESS_INDEX_H
+#define BUFFER_ADDRESS_INDEX_H
+
+#include <list>
+#include <vector>
+#include <algorithm>
+
+#include "Types.h"
+
+// Sorted index over the [start, end] address ranges of buffers kept in a std::list.
+// The list keeps owning the buffers, so pointers to them stay valid, and its order
+// still decides which buffer wins when several match: the one closest to the front.
+// The index is rebuilt lazily after invalidate(), which the owner must call whenever
+// it adds or removes buffers or changes their addresses.
+template <class Buffer, u32 Buffer::*Start, u32 Buffer::*End>
+class BufferAddressIndex
+{
+public:
+	typedef std::list<Buffer> Buffers;
+	typedef typename Buffers::iterator Iterator;
+
+	void invalidate() { m_valid = false; }
+
+	// First buffer starting exactly at _address
+	Iterator find(Buffers & _list, u32 _address)
+	{
+		_update(_list);
+		auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), _address,
+			[](const Entry & _entry, u32 _addr) { return _entry.start < _addr; });
+		if (iter != m_entries.end() && iter->start == _address)
+			return iter->buffer;
+		return _list.end();
+	}
+
+	// First buffer whose range contains _address
+	Iterator findContaining(Buffers & _list, u32 _address)
+	{
+		_update(_list);
+		const Entry * pFound = nullptr;
+		for (size_t i = _upperBound(_address); i > 0 && m_entries[i - 1].maxEnd >= _address; --i) {
+			const Entry & entry = m_entries[i - 1];
+			if (entry.end >= _address && (pFound == nullptr || entry.order < pFound->order))
+				pFound = &entry;
+		}
+		return pFound != nullptr ? pFound->buffer : _list.end();
+	}
+
+	// All buffers whose range intersects [_start, _end], from the back of the list to the front
+	void findOverlapping(Buffers & _list, u32 _start, u32 _end, std::vector<Iterator> & _result)
+	{
+		_update(_list);
+		m_found.clear();
+		for (size_t i = _upperBound(_end); i > 0 && m_entries[i - 1].maxEnd >= _start; --i) {
+			if (m_entries[i - 1].end >= _start)
+				m_found.push_back(&m_entries[i - 1]);
+		}
+		std::sort(m_found.begin(), m_found.end(),
+			[](const Entry * _lhs, const Entry * _rhs) { return _lhs->order > _rhs->order; });
+		_result.clear();
+		for (const Entry * pEntry : m_found)
+			_result.push_back(pEntry->buffer);
+	}
+
+private:
+	struct Entry
+	{
+		u32 start;
+		u32 end;
+		u32 maxEnd; // max end of this and all preceding entries
+		u32 order;  // position in the list
+		Iterator buffer;
+	};
+
+	size_t _upperBound(u32 _address) const
+	{
+		return std::upper_bound(m_entries.begin(), m_entries.end(), _address,
+			[](u32 _addr, const Entry & _entry) { return _addr < _entry.start; }) - m_entries.begin();
+	}
+
+	void _update(Buffers & _list)
+	{
+		if (m_valid)
+			return;
+
+		m_entries.clear();
+		u32 order = 0;
+		for (auto iter = _list.begin(); iter != _list.end(); ++iter)
+			m_entries.push_back({ (*iter).*Start, (*iter).*End, 0, order++, iter });
+
+		std::sort(m_entries.begin(), m_entries.end(), [](const Entry & _lhs, const Entry & _rhs) {
+			return _lhs.start < _rhs.start || (_lhs.start == _rhs.start && _lhs.order < _rhs.order);
+		});
+
+		u32 maxEnd = 0;
+		for (Entry & entry : m_entries) {
+			maxEnd = std::max(maxEnd, entry.end);
+			entry.maxEnd = maxEnd;
+		}
+		m_valid = true;
+	}
+
+	std::vector<Entry> m_entries;
+	std::vector<const Entry*> m_found;
+	bool m_valid = false;
+};
+
+#endif // BUFFER_ADDRESS_INDEX_H
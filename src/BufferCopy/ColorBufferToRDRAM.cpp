@@ -36,6 +36,8 @@ ColorBufferToRDRAM::ColorBufferToRDRAM()
 	, m_frameCount(-1)
 	, m_startAddress(-1)
 	, m_lastBufferWidth(-1)
+	, m_pReadTexture(nullptr)
+	, m_pPackTexture(nullptr)
 {
 	m_allowedRealWidths[0] = 320;
 	m_allowedRealWidths[1] = 480;
@@ -49,6 +51,9 @@ ColorBufferToRDRAM::~ColorBufferToRDRAM()
 void ColorBufferToRDRAM::init()
 {
 	m_FBO = gfxContext.createFramebuffer();
+	m_packProgram.reset(gfxContext.createColorBufferPackShader());
+	if (m_packProgram)
+		m_packFBO = gfxContext.createFramebuffer();
 }
 
 void ColorBufferToRDRAM::destroy() {
@@ -58,6 +63,12 @@ void ColorBufferToRDRAM::destroy() {
 		gfxContext.deleteFramebuffer(m_FBO);
 		m_FBO.reset();
 	}
+
+	if (m_packFBO.isNotNull()) {
+		gfxContext.deleteFramebuffer(m_packFBO);
+		m_packFBO.reset();
+	}
+	m_packProgram.reset();
 }
 
 void ColorBufferToRDRAM::_initFBTexture(void)
@@ -115,16 +126,79 @@ void ColorBufferToRDRAM::_initFBTexture(void)
 	gfxContext.bindFramebuffer(graphics::bufferTarget::DRAW_FRAMEBUFFER, graphics::ObjectHandle::defaultFramebuffer);
 
 	m_bufferReader.reset(gfxContext.createColorBufferReader(m_pTexture));
+
+	if (m_packProgram)
+		_initPackTexture();
+}
+
+void ColorBufferToRDRAM::_initPackTexture(void)
+{
+	// One texel per RDRAM dword. 32bit buffers need the most of them: one per pixel.
+	m_pPackTexture = textureCache().addFrameBufferTexture(false);
+	m_pPackTexture->format = G_IM_FMT_RGBA;
+	m_pPackTexture->size = 2;
+	m_pPackTexture->clampS = 1;
+	m_pPackTexture->clampT = 1;
+	m_pPackTexture->frameBufferTexture = CachedTexture::fbOneSample;
+	m_pPackTexture->maskS = 0;
+	m_pPackTexture->maskT = 0;
+	m_pPackTexture->mirrorS = 0;
+	m_pPackTexture->mirrorT = 0;
+	m_pPackTexture->realWidth = m_pTexture->realWidth;
+	m_pPackTexture->realHeight = m_pTexture->realHeight;
+	m_pPackTexture->textureBytes = m_pPackTexture->realWidth * m_pPackTexture->realHeight * 4;
+
+	{
+		Context::InitTextureParams params;
+		params.handle = m_pPackTexture->name;
+		params.width = m_pPackTexture->realWidth;
+		params.height = m_pPackTexture->realHeight;
+		params.internalFormat = internalcolorFormat::RGBA8;
+		params.format = colorFormat::RGBA;
+		params.dataType = datatype::UNSIGNED_BYTE;
+		gfxContext.init2DTexture(params);
+	}
+	{
+		Context::TexParameters params;
+		params.handle = m_pPackTexture->name;
+		params.target = textureTarget::TEXTURE_2D;
+		params.textureUnitIndex = textureIndices::Tex[0];
+		params.minFilter = textureParameters::FILTER_NEAREST;
+		params.magFilter = textureParameters::FILTER_NEAREST;
+		gfxContext.setTextureParameters(params);
+	}
+	{
+		Context::FrameBufferRenderTarget bufTarget;
+		bufTarget.bufferHandle = m_packFBO;
+		bufTarget.bufferTarget = bufferTarget::DRAW_FRAMEBUFFER;
+		bufTarget.attachment = bufferAttachment::COLOR_ATTACHMENT0;
+		bufTarget.textureTarget = textureTarget::TEXTURE_2D;
+		bufTarget.textureHandle = m_pPackTexture->name;
+		gfxContext.addFrameBufferRenderTarget(bufTarget);
+	}
+
+	assert(!gfxContext.isFramebufferError());
+
+	gfxContext.bindFramebuffer(graphics::bufferTarget::DRAW_FRAMEBUFFER, graphics::ObjectHandle::defaultFramebuffer);
+
+	m_packReader.reset(gfxContext.createColorBufferReader(m_pPackTexture));
 }
 
 void ColorBufferToRDRAM::_destroyFBTexure(void)
 {
 	m_bufferReader.reset();
+	m_packReader.reset();
 
 	if (m_pTexture != nullptr) {
 		textureCache().removeFrameBufferTexture(m_pTexture);
 		m_pTexture = nullptr;
 	}
+
+	if (m_pPackTexture != nullptr) {
+		textureCache().removeFrameBufferTexture(m_pPackTexture);
+		m_pPackTexture = nullptr;
+	}
+	m_pReadTexture = nullptr;
 }
 
 bool ColorBufferToRDRAM::_prepareCopy(u32& _startAddress)
@@ -219,8 +293,12 @@ bool ColorBufferToRDRAM::_prepareCopy(u32& _startAddress)
 		wnd.getDrawer().blitOrCopyTexturedRect(blitParams);
 
 		gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, m_FBO);
+		m_pReadTexture = m_pTexture;
 	} else {
 		gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, readBuffer);
+		m_pReadTexture = config.video.multisampling != 0 ?
+			m_pCurFrameBuffer->m_pResolveTexture :
+			m_pCurFrameBuffer->m_pTexture;
 	}
 
 	m_frameCount = curFrame;
@@ -261,6 +339,9 @@ void ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
 	const u32 y1 = (_endAddress - m_pCurFrameBuffer->m_startAddress) / stride;
 	const u32 height = std::min(max_height, 1u + y1 - y0);
 
+	if (_copyPacked(_startAddress, _endAddress, y0, height, _sync))
+		return;
+
 	const u8* pPixels = m_bufferReader->readPixels(x0, y0, width, height, m_pCurFrameBuffer->m_size, _sync);
 	frameBufferList().setCurrentDrawBuffer();
 	if (pPixels == nullptr)
@@ -304,6 +385,96 @@ void ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
 	gDP.changed |= CHANGED_SCISSOR;
 }
 
+// Write packed RDRAM words, keeping RDRAM content where the buffer has empty pixels.
+static
+void _mergePacked32(const u32 * _src, u32 * _dst, u32 _count)
+{
+	for (u32 i = 0; i < _count; ++i) {
+		if (_src[i] != 0)
+			_dst[i] = _src[i];
+	}
+}
+
+static
+void _mergePacked16(const u32 * _src, u32 * _dst, u32 _count)
+{
+	for (u32 i = 0; i < _count; ++i) {
+		const u32 c = _src[i];
+		const u32 mask = ((c & 0xFFFF0000) != 0 ? 0xFFFF0000 : 0) | ((c & 0x0000FFFF) != 0 ? 0x0000FFFF : 0);
+		_dst[i] = (_dst[i] & ~mask) | c;
+	}
+}
+
+bool ColorBufferToRDRAM::_copyPacked(u32 _startAddress, u32 _endAddress, u32 _y0, u32 _height, bool _sync)
+{
+	if (!m_packProgram || m_pPackTexture == nullptr || m_pReadTexture == nullptr)
+		return false;
+
+	const u32 size = m_pCurFrameBuffer->m_size;
+	const u32 width = m_pCurFrameBuffer->m_width;
+	if (size < G_IM_SIZ_16b || (size == G_IM_SIZ_16b && (width & 1) != 0))
+		return false;
+	// Packed rows are written by whole RDRAM words. A range which starts or ends
+	// in the middle of a word is left to the per pixel path.
+	if (((_startAddress | _endAddress) & 3) != 0)
+		return false;
+
+	// Convert pixels to RDRAM words on GPU
+	const u32 packedWidth = size == G_IM_SIZ_32b ? width : width >> 1;
+	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, m_packFBO);
+	m_packProgram->setPackParams(size, _y0);
+
+	GraphicsDrawer::CopyRectParams copyParams;
+	copyParams.srcX1 = packedWidth;
+	copyParams.srcY1 = _height;
+	copyParams.srcWidth = m_pPackTexture->realWidth;
+	copyParams.srcHeight = m_pPackTexture->realHeight;
+	copyParams.dstX1 = packedWidth;
+	copyParams.dstY1 = _height;
+	copyParams.dstWidth = m_pPackTexture->realWidth;
+	copyParams.dstHeight = m_pPackTexture->realHeight;
+	copyParams.tex[0] = m_pReadTexture;
+	copyParams.filter = textureParameters::FILTER_NEAREST;
+	copyParams.combiner = m_packProgram.get();
+	dwnd().getDrawer().copyTexturedRect(copyParams);
+
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, m_packFBO);
+	u32 rowBytes = 0;
+	const u8* pPixels = m_packReader->readRawPixels(0, 0, packedWidth, _height, _sync, rowBytes);
+	frameBufferList().setCurrentDrawBuffer();
+	if (pPixels == nullptr)
+		return true;
+
+	// Rows of packed data are rows of the buffer in RDRAM, so just put them in place.
+	const bool overwrite = !FBInfo::fbInfo.isSupported() && config.frameBufferEmulation.copyFromRDRAM != 0;
+	const u32 stride = width << size >> 1;
+	u32 offset = _startAddress - (m_pCurFrameBuffer->m_startAddress + _y0 * stride);
+	u32 bytesLeft = _endAddress - _startAddress;
+	u8 * pDst = RDRAM + _startAddress;
+	for (u32 y = 0; y < _height && bytesLeft > 0; ++y) {
+		const u32 numBytes = std::min(stride - offset, bytesLeft);
+		const u8 * pSrc = pPixels + y * rowBytes + offset;
+		if (overwrite)
+			memcpy(pDst, pSrc, numBytes);
+		else if (size == G_IM_SIZ_32b)
+			_mergePacked32((const u32*)pSrc, (u32*)pDst, numBytes >> 2);
+		else
+			_mergePacked16((const u32*)pSrc, (u32*)pDst, numBytes >> 2);
+		pDst += numBytes;
+		bytesLeft -= numBytes;
+		offset = 0;
+	}
+
+	m_pCurFrameBuffer->m_copiedToRdram = true;
+	m_pCurFrameBuffer->copyRdram();
+	m_pCurFrameBuffer->m_cleared = false;
+
+	m_packReader->cleanUp();
+
+	gDP.changed |= CHANGED_SCISSOR;
+	return true;
+}
+
 u32 ColorBufferToRDRAM::_getRealWidth(u32 _viWidth)
 {
 	u32 index = 0;
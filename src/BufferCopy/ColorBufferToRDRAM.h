@@ -8,6 +8,7 @@
 
 namespace graphics {
 	class ColorBufferReader;
+	class BufferPackShaderProgram;
 }
 
 struct CachedTexture;
@@ -40,12 +41,16 @@ private:
 
 	void _initFBTexture(void);
 
+	void _initPackTexture(void);
+
 	void _destroyFBTexure(void);
 
 	bool _prepareCopy(u32& _startAddress);
 
 	void _copy(u32 _startAddress, u32 _endAddress, bool _sync);
 
+	bool _copyPacked(u32 _startAddress, u32 _endAddress, u32 _y0, u32 _height, bool _sync);
+
 	u32 _getRealWidth(u32 _viWidth);
 
 	// Convert pixel from video memory to N64 buffer format.
@@ -62,6 +67,13 @@ private:
 
 	std::array<u32, 3> m_allowedRealWidths;
 	std::unique_ptr<graphics::ColorBufferReader> m_bufferReader;
+
+	// GPU side conversion to RDRAM format
+	CachedTexture * m_pReadTexture;
+	CachedTexture * m_pPackTexture;
+	graphics::ObjectHandle m_packFBO;
+	std::unique_ptr<graphics::ColorBufferReader> m_packReader;
+	std::unique_ptr<graphics::BufferPackShaderProgram> m_packProgram;
 };
 
 void copyWhiteToRDRAM(FrameBuffer * _pBuffer);
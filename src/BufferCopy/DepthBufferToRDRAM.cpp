@@ -28,6 +28,7 @@ DepthBufferToRDRAM::DepthBufferToRDRAM()
 	, m_pColorTexture(nullptr)
 	, m_pDepthTexture(nullptr)
 	, m_pCurFrameBuffer(nullptr)
+	, m_pPackTexture(nullptr)
 {
 }
 
@@ -123,6 +124,58 @@ void DepthBufferToRDRAM::init()
 	assert(!gfxContext.isFramebufferError());
 	assert(!gfxContext.isError());
 	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
+
+	m_packProgram.reset(gfxContext.createDepthBufferPackShader());
+	if (m_packProgram)
+		_initPackTexture();
+}
+
+void DepthBufferToRDRAM::_initPackTexture()
+{
+	// One texel per RDRAM dword, that is per two depth values
+	m_pPackTexture = textureCache().addFrameBufferTexture(false);
+	m_pPackTexture->format = G_IM_FMT_RGBA;
+	m_pPackTexture->size = 2;
+	m_pPackTexture->clampS = 1;
+	m_pPackTexture->clampT = 1;
+	m_pPackTexture->frameBufferTexture = CachedTexture::fbOneSample;
+	m_pPackTexture->maskS = 0;
+	m_pPackTexture->maskT = 0;
+	m_pPackTexture->mirrorS = 0;
+	m_pPackTexture->mirrorT = 0;
+	m_pPackTexture->realWidth = DEPTH_TEX_WIDTH / 2;
+	m_pPackTexture->realHeight = DEPTH_TEX_HEIGHT;
+	m_pPackTexture->textureBytes = m_pPackTexture->realWidth * m_pPackTexture->realHeight * 4;
+
+	Context::InitTextureParams initParams;
+	initParams.handle = m_pPackTexture->name;
+	initParams.textureUnitIndex = textureIndices::Tex[0];
+	initParams.width = m_pPackTexture->realWidth;
+	initParams.height = m_pPackTexture->realHeight;
+	initParams.internalFormat = internalcolorFormat::RGBA8;
+	initParams.format = colorFormat::RGBA;
+	initParams.dataType = datatype::UNSIGNED_BYTE;
+	gfxContext.init2DTexture(initParams);
+
+	Context::TexParameters setParams;
+	setParams.handle = m_pPackTexture->name;
+	setParams.target = textureTarget::TEXTURE_2D;
+	setParams.textureUnitIndex = textureIndices::Tex[0];
+	setParams.minFilter = textureParameters::FILTER_NEAREST;
+	setParams.magFilter = textureParameters::FILTER_NEAREST;
+	gfxContext.setTextureParameters(setParams);
+
+	m_packFBO = gfxContext.createFramebuffer();
+	Context::FrameBufferRenderTarget bufTarget;
+	bufTarget.bufferHandle = m_packFBO;
+	bufTarget.bufferTarget = bufferTarget::DRAW_FRAMEBUFFER;
+	bufTarget.attachment = bufferAttachment::COLOR_ATTACHMENT0;
+	bufTarget.textureTarget = textureTarget::TEXTURE_2D;
+	bufTarget.textureHandle = m_pPackTexture->name;
+	gfxContext.addFrameBufferRenderTarget(bufTarget);
+
+	assert(!gfxContext.isFramebufferError());
+	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
 }
 
 void DepthBufferToRDRAM::destroy() {
@@ -139,6 +192,15 @@ void DepthBufferToRDRAM::destroy() {
 		textureCache().removeFrameBufferTexture(m_pDepthTexture);
 		m_pDepthTexture = nullptr;
 	}
+	if (m_packFBO.isNotNull()) {
+		gfxContext.deleteFramebuffer(m_packFBO);
+		m_packFBO.reset();
+	}
+	if (m_pPackTexture != nullptr) {
+		textureCache().removeFrameBufferTexture(m_pPackTexture);
+		m_pPackTexture = nullptr;
+	}
+	m_packProgram.reset();
 	m_pbuf.reset();
 }
 
@@ -237,6 +299,9 @@ bool DepthBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress)
 	const u32 y1 = (_endAddress - pDepthBuffer->m_address) / stride;
 	const u32 height = std::min(max_height, 1u + y1 - y0);
 
+	if (_copyPacked(_startAddress, _endAddress, y0, height))
+		return true;
+
 	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, m_FBO);
 
 	PixelBufferBinder<PixelReadBuffer> binder(m_pbuf.get());
@@ -274,6 +339,65 @@ bool DepthBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress)
 	return true;
 }
 
+bool DepthBufferToRDRAM::_copyPacked(u32 _startAddress, u32 _endAddress, u32 _y0, u32 _height)
+{
+	if (!m_packProgram)
+		return false;
+
+	const u32 width = m_pCurFrameBuffer->m_width;
+	if ((width & 1) != 0)
+		return false;
+	// Packed rows are written by whole RDRAM words. A range which starts or ends
+	// in the middle of a word is left to the per pixel path.
+	if (((_startAddress | _endAddress) & 3) != 0)
+		return false;
+
+	// Convert depth to RDRAM words on GPU
+	const u32 packedWidth = width >> 1;
+	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, m_packFBO);
+	m_packProgram->setPackParams(G_IM_SIZ_16b, _y0);
+
+	GraphicsDrawer::CopyRectParams copyParams;
+	copyParams.srcX1 = packedWidth;
+	copyParams.srcY1 = _height;
+	copyParams.srcWidth = m_pPackTexture->realWidth;
+	copyParams.srcHeight = m_pPackTexture->realHeight;
+	copyParams.dstX1 = packedWidth;
+	copyParams.dstY1 = _height;
+	copyParams.dstWidth = m_pPackTexture->realWidth;
+	copyParams.dstHeight = m_pPackTexture->realHeight;
+	copyParams.tex[0] = m_pDepthTexture;
+	copyParams.filter = textureParameters::FILTER_NEAREST;
+	copyParams.combiner = m_packProgram.get();
+	dwnd().getDrawer().copyTexturedRect(copyParams);
+
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, m_packFBO);
+
+	PixelBufferBinder<PixelReadBuffer> binder(m_pbuf.get());
+	const u32 stride = width << 1;
+	m_pbuf->readPixels(0, 0, packedWidth, _height, colorFormat::RGBA, datatype::UNSIGNED_BYTE);
+	const u8 * pixelData = (const u8*)m_pbuf->getDataRange(0, _height * stride);
+	frameBufferList().setCurrentDrawBuffer();
+	if (pixelData == nullptr)
+		return false;
+
+	// Read rows are tightly packed and lie the same way as in RDRAM
+	DepthBuffer * pDepthBuffer = m_pCurFrameBuffer->m_pDepthBuffer;
+	const u32 offset = _startAddress - (pDepthBuffer->m_address + _y0 * stride);
+	const u32 numBytes = std::min(_endAddress - _startAddress, _height * stride - offset);
+	memcpy(RDRAM + _startAddress, pixelData + offset, numBytes);
+
+	pDepthBuffer->m_cleared = false;
+	FrameBuffer * pBuffer = frameBufferList().findBuffer(pDepthBuffer->m_address);
+	if (pBuffer != nullptr)
+		pBuffer->m_cleared = false;
+
+	m_pbuf->closeReadBuffer();
+
+	gDP.changed |= CHANGED_SCISSOR;
+	return true;
+}
+
 bool DepthBufferToRDRAM::copyToRDRAM(u32 _address)
 {
 	if (config.frameBufferEmulation.copyDepthToRDRAM == Config::cdSoftwareRender)
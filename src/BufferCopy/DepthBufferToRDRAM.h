@@ -6,6 +6,7 @@
 
 namespace graphics {
 	class PixelReadBuffer;
+	class BufferPackShaderProgram;
 }
 
 struct CachedTexture;
@@ -28,6 +29,8 @@ private:
 
 	bool _prepareCopy(u32& _startAddress, bool _copyChunk);
 	bool _copy(u32 _startAddress, u32 _endAddress);
+	bool _copyPacked(u32 _startAddress, u32 _endAddress, u32 _y0, u32 _height);
+	void _initPackTexture();
 
 	// Convert pixel from video memory to N64 depth buffer format.
 	static u16 _FloatToUInt16(f32 _z);
@@ -38,6 +41,11 @@ private:
 	CachedTexture * m_pColorTexture;
 	CachedTexture * m_pDepthTexture;
 	FrameBuffer * m_pCurFrameBuffer;
+
+	// GPU side conversion to N64 depth format
+	graphics::ObjectHandle m_packFBO;
+	CachedTexture * m_pPackTexture;
+	std::unique_ptr<graphics::BufferPackShaderProgram> m_packProgram;
 };
 
 #endif // DepthBufferToRDRAM_H
@@ -115,11 +115,30 @@ bool _copyBufferFromRdram(u32 _address, u32* _dst, u32(*converter)(TSrc _c, bool
 	return summ != 0;
 }
 
-// Write only pixels provided with FBWrite
+// Get range of lines touched by pixels provided with FBWrite
+static
+bool _getDirtyLines(u32 _address, const std::vector<u32> & _vecAddress, u32 _szPixel, u32 _width, u32 _height, u32 & _y0, u32 & _y1)
+{
+	u32 minAddress = 0xFFFFFFFF;
+	u32 maxAddress = 0;
+	for (u32 address : _vecAddress) {
+		minAddress = std::min(minAddress, address);
+		maxAddress = std::max(maxAddress, address);
+	}
+	if (minAddress < _address) {
+		_y0 = _y1 = 0;
+		return false;
+	}
+	_y0 = (minAddress - _address) / _szPixel / _width;
+	_y1 = std::min((maxAddress - _address) / _szPixel / _width + 1, _height);
+	return _y0 < _y1;
+}
+
+// Write only pixels provided with FBWrite. Only lines [_y0, _y1) of _dst are touched.
 template <typename TSrc>
-bool _copyPixelsFromRdram(u32 _address, const std::vector<u32> & _vecAddress, u32* _dst, u32(*converter)(TSrc _c, bool _bCFB), u32 _xor, u32 _width, u32 _height, bool _fullAlpha)
+bool _copyPixelsFromRdram(u32 _address, const std::vector<u32> & _vecAddress, u32* _dst, u32(*converter)(TSrc _c, bool _bCFB), u32 _xor, u32 _width, u32 _y0, u32 _y1, bool _fullAlpha)
 {
-	memset(_dst, 0, _width*_height*sizeof(u32));
+	memset(_dst + _y0 * _width, 0, _width*(_y1 - _y0)*sizeof(u32));
 	TSrc * src = reinterpret_cast<TSrc*>(RDRAM + _address);
 	const u32 szPixel = sizeof(TSrc);
 	const size_t numPixels = _vecAddress.size();
@@ -127,13 +146,11 @@ bool _copyPixelsFromRdram(u32 _address, const std::vector<u32> & _vecAddress, u3
 	u32 summ = 0;
 	u32 idx, w, h;
 	for (size_t i = 0; i < numPixels; ++i) {
-		if (_vecAddress[i] < _address)
-			return false;
 		idx = (_vecAddress[i] - _address) / szPixel;
 		w = idx % _width;
 		h = idx / _width;
-		if (h > _height)
-			return false;
+		if (h >= _y1)
+			continue;
 		col = src[idx];
 		summ += col;
 		_dst[(w + h * _width) ^ _xor] = converter(col, _fullAlpha);
@@ -178,8 +195,13 @@ void RDRAMtoColorBuffer::_copyFromRDRAM(u32 _height, bool _fullAlpha)
 	const u32 height = _height;
 
 	const u32 x0 = 0;
-	const u32 y0 = 0;
-	const u32 y1 = y0 + height;
+	u32 y0 = 0;
+	u32 y1 = y0 + height;
+
+	// With FBWrite addresses only the lines written by CPU are updated
+	bool bDirty = true;
+	if (!m_vecAddress.empty())
+		bDirty = _getDirtyLines(address, m_vecAddress, 1 << m_pCurBuffer->m_size >> 1, width, height, y0, y1);
 
 	const bool bUseAlpha = !_fullAlpha && m_pCurBuffer->m_changed;
 
@@ -206,11 +228,13 @@ void RDRAMtoColorBuffer::_copyFromRDRAM(u32 _height, bool _fullAlpha)
 			bCopy = _copyBufferFromRdram<u16>(address, pDst, RGBA16ToABGR32, 1, x0, y0, width, height, _fullAlpha);
 		else
 			bCopy = _copyBufferFromRdram<u32>(address, pDst, RGBA32ToABGR32, 0, x0, y0, width, height, _fullAlpha);
+	} else if (!bDirty) {
+		bCopy = false;
 	} else {
 		if (m_pCurBuffer->m_size == G_IM_SIZ_16b)
-			bCopy = _copyPixelsFromRdram<u16>(address, m_vecAddress, pDst, RGBA16ToABGR32, 1, width, height, _fullAlpha);
+			bCopy = _copyPixelsFromRdram<u16>(address, m_vecAddress, pDst, RGBA16ToABGR32, 1, width, y0, y1, _fullAlpha);
 		else
-			bCopy = _copyPixelsFromRdram<u32>(address, m_vecAddress, pDst, RGBA32ToABGR32, 0, width, height, _fullAlpha);
+			bCopy = _copyPixelsFromRdram<u32>(address, m_vecAddress, pDst, RGBA32ToABGR32, 0, width, y0, y1, _fullAlpha);
 	}
 
 	//Convert integer format to float
@@ -218,7 +242,7 @@ void RDRAMtoColorBuffer::_copyFromRDRAM(u32 _height, bool _fullAlpha)
 		f32* floatData = reinterpret_cast<f32*>(m_pbuf);
 		u8* byteData = dstData.get();
 		const u32 widthPixels = width*4;
-		for (unsigned int heightIndex = 0; heightIndex < height; ++heightIndex) {
+		for (unsigned int heightIndex = y0; heightIndex < y1; ++heightIndex) {
 			for (unsigned int widthIndex = 0; widthIndex < widthPixels; ++widthIndex) {
 				u8& src = *(byteData + heightIndex*widthPixels + widthIndex);
 				float& dst = *(floatData + heightIndex*widthPixels + widthIndex);
@@ -244,14 +268,16 @@ void RDRAMtoColorBuffer::_copyFromRDRAM(u32 _height, bool _fullAlpha)
 	CombinerInfo::get().setPolygonMode(DrawingState::TexRect);
 	CombinerInfo::get().update();
 
+	const u32 pixelBytes = fbTexFormats.colorType == datatype::FLOAT ? 16 : 4;
 	Context::UpdateTextureDataParams updateParams;
 	updateParams.handle = m_pTexture->name;
 	updateParams.textureUnitIndex = textureIndices::Tex[0];
+	updateParams.y = y0;
 	updateParams.width = width;
-	updateParams.height = height;
+	updateParams.height = y1 - y0;
 	updateParams.format = fbTexFormats.colorFormat;
 	updateParams.dataType = fbTexFormats.colorType;
-	updateParams.data = m_pbuf;
+	updateParams.data = m_pbuf + y0 * width * pixelBytes;
 	gfxContext.update2DTexture(updateParams);
 
 	m_pTexture->scaleS = 1.0f / (float)m_pTexture->realWidth;
@@ -275,8 +301,8 @@ void RDRAMtoColorBuffer::_copyFromRDRAM(u32 _height, bool _fullAlpha)
 	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, m_pCurBuffer->m_FBO);
 
 	gfxContext.enable(enable::SCISSOR_TEST, false);
-	GraphicsDrawer::TexturedRectParams texRectParams((float)x0, (float)y0, (float)width, (float)height,
-										 1.0f, 1.0f, 0, 0,
+	GraphicsDrawer::TexturedRectParams texRectParams((float)x0, (float)y0, (float)width, (float)y1,
+										 1.0f, 1.0f, 0, s16(y0 << 5),
 										 false, true, false, m_pCurBuffer);
 	dwnd().getDrawer().drawTexturedRect(texRectParams);
 	gfxContext.enable(enable::SCISSOR_TEST, true);
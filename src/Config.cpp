@@ -38,6 +38,7 @@ void Config::resetToDefaults()
 	generalEmulation.correctTexrectCoords = tcDisable;
 	generalEmulation.enableNativeResTexrects = 0;
 	generalEmulation.enableLegacyBlending = 0;
+	generalEmulation.enableDListCache = 0;
 	generalEmulation.hacks = 0;
 #if defined(OS_ANDROID) || defined(OS_IOS)
 	generalEmulation.enableFragmentDepthWrite = 0;
@@ -52,6 +53,7 @@ void Config::resetToDefaults()
 	frameBufferEmulation.enable = 1;
 	frameBufferEmulation.copyDepthToRDRAM = cdSoftwareRender;
 	frameBufferEmulation.copyFromRDRAM = 0;
+	frameBufferEmulation.hashedValidityCheck = 0;
 	frameBufferEmulation.copyAuxToRDRAM = 0;
 	frameBufferEmulation.copyToRDRAM = ctDoubleBuffer;
 	frameBufferEmulation.N64DepthCompare = 0;
@@ -75,14 +77,17 @@ void Config::resetToDefaults()
 	textureFilter.txDeposterize = 0;
 	textureFilter.txFilterIgnoreBG = 0;
 	textureFilter.txCacheSize = 100 * gc_uMegabyte;
+	textureFilter.txHiresCacheSize = 0;
+	textureFilter.txDiskCacheSize = 0;
 
 	textureFilter.txHiresEnable = 0;
 	textureFilter.txHiresFullAlphaChannel = 1;
 	textureFilter.txHresAltCRC = 0;
 	textureFilter.txDump = 0;
+	textureFilter.txDumpCompressionLevel = 6;
 
 	textureFilter.txForce16bpp = 0;
-	textureFilter.txCacheCompression = 1;
+	textureFilter.txCacheCompression = tccLZ4;
 	textureFilter.txSaveCache = 1;
 
 	api().GetUserDataPath(textureFilter.txPath);
@@ -118,6 +123,8 @@ void Config::resetToDefaults()
 	onScreenDisplay.pos = posBottomLeft;
 
 	debug.dumpMode = 0;
+	debug.gbiTrace = gtDisable;
+	debug.captureFrames = 0;
 }
 
 bool isHWLightingAllowed()
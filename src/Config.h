@@ -5,7 +5,7 @@
 #include "Types.h"
 
 #define CONFIG_WITH_PROFILES 23U
-#define CONFIG_VERSION_CURRENT 24U
+#define CONFIG_VERSION_CURRENT 25U
 
 #define BILINEAR_3POINT   0
 #define BILINEAR_STANDARD 1
@@ -53,6 +53,7 @@ struct Config
 		u32 enableLegacyBlending;
 		u32 enableFragmentDepthWrite;
 		u32 enableBlitScreenWorkaround;
+		u32 enableDListCache;
 		u32 hacks;
 #if defined(OS_ANDROID) || defined(OS_IOS)
 		u32 forcePolygonOffset;
@@ -100,6 +101,7 @@ struct Config
 		u32 copyToRDRAM;
 		u32 copyDepthToRDRAM;
 		u32 copyFromRDRAM;
+		u32 hashedValidityCheck;	// Check RDRAM content of buffers by 128 byte block hashes instead of full copies. Saves memory, costs time.
 
 		// FBInfo
 		u32 fbInfoSupported;
@@ -120,6 +122,12 @@ struct Config
 		} overscanPAL, overscanNTSC;
 	} frameBufferEmulation;
 
+	enum TexCacheCompression {
+		tccNone = 0,
+		tccZlib = 1,
+		tccLZ4 = 2
+	};
+
 	struct
 	{
 		u32 txFilterMode;				// Texture filtering mode, eg Sharpen
@@ -127,14 +135,17 @@ struct Config
 		u32 txDeposterize;				// Deposterize texture before enhancement
 		u32 txFilterIgnoreBG;			// Do not apply filtering to backgrounds textures
 		u32 txCacheSize;				// Cache size in Mbytes
+		u32 txHiresCacheSize;			// Memory budget of hires textures in Mbytes, 0 - unlimited. Needs txDiskCacheSize
+		u32 txDiskCacheSize;			// Disk budget in Mbytes for textures evicted from memory, 0 - evicted textures are dropped
 
 		u32 txHiresEnable;				// Use high-resolution texture packs
 		u32 txHiresFullAlphaChannel;	// Use alpha channel fully
 		u32 txHresAltCRC;				// Use alternative method of paletted textures CRC calculation
 		u32 txDump;						// Dump textures
+		u32 txDumpCompressionLevel;		// zlib compression level of dumped textures, 0..9
 
 		u32 txForce16bpp;				// Force use 16bit color textures
-		u32 txCacheCompression;			// Zip textures cache
+		u32 txCacheCompression;			// Compress textures cache, see TexCacheCompression
 		u32 txSaveCache;				// Save texture cache to hard disk
 
 		wchar_t txPath[PLUGIN_PATH_SIZE]; // Path to texture packs
@@ -175,8 +186,16 @@ struct Config
 		u32 pos;
 	} onScreenDisplay;
 
+	enum GBITraceMode {
+		gtDisable = 0,
+		gtRecord,
+		gtReplay
+	};
+
 	struct {
 		u32 dumpMode;
+		u32 gbiTrace;
+		u32 captureFrames;
 	} debug;
 
 	void resetToDefaults();
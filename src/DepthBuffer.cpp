@@ -366,18 +366,24 @@ void DepthBuffer::bindDepthImageTexture(ObjectHandle _fbo)
 
 DepthBufferList::DepthBufferList() : m_pCurrent(nullptr), m_pzLUT(nullptr)
 {
-	m_pzLUT = new u16[0x40000];
-	for (int i = 0; i<0x40000; i++) {
-		u32 exponent = 0;
-		u32 testbit = 1 << 17;
-		while ((i & testbit) && (exponent < 7)) {
-			exponent++;
-			testbit = 1 << (17 - exponent);
-		}
+}
+
+const u16 * const DepthBufferList::getZLUT()
+{
+	if (m_pzLUT != nullptr)
+		return m_pzLUT;
 
-		const u32 mantissa = (i >> (6 - (6 < exponent ? 6 : exponent))) & 0x7ff;
-		m_pzLUT[i] = (u16)(((exponent << 11) | mantissa) << 2);
+	// The exponent is the number of leading ones of the 18-bit depth, up to 7.
+	// Fill the table range by range instead of counting the bits of each entry.
+	m_pzLUT = new u16[0x40000];
+	for (u32 exponent = 0; exponent < 8; ++exponent) {
+		const u32 start = exponent < 7 ? ((1U << exponent) - 1U) << (18 - exponent) : 0x3F800U;
+		const u32 end = exponent < 7 ? start + (1U << (17 - exponent)) : 0x40000U;
+		const u32 shift = 6 - (6 < exponent ? 6 : exponent);
+		for (u32 i = start; i < end; ++i)
+			m_pzLUT[i] = (u16)(((exponent << 11) | ((i >> shift) & 0x7ff)) << 2);
 	}
+	return m_pzLUT;
 }
 
 DepthBufferList::~DepthBufferList()
@@ -402,6 +408,7 @@ void DepthBufferList::destroy()
 {
 	m_pCurrent = nullptr;
 	m_list.clear();
+	m_index.invalidate();
 }
 
 void DepthBufferList::setCleared(bool _cleared)
@@ -412,20 +419,18 @@ void DepthBufferList::setCleared(bool _cleared)
 
 DepthBuffer * DepthBufferList::findBuffer(u32 _address)
 {
-	for (DepthBuffers::iterator iter = m_list.begin(); iter != m_list.end(); ++iter)
-		if (iter->m_address == _address)
-				return &(*iter);
-	return nullptr;
+	DepthBuffers::iterator iter = m_index.find(m_list, _address);
+	return iter != m_list.end() ? &(*iter) : nullptr;
 }
 
 void DepthBufferList::removeBuffer(u32 _address )
 {
-	for (DepthBuffers::iterator iter = m_list.begin(); iter != m_list.end(); ++iter)
-		if (iter->m_address == _address) {
-			frameBufferList().clearDepthBuffer(&(*iter));
-			m_list.erase(iter);
-			return;
-		}
+	DepthBuffers::iterator iter = m_index.find(m_list, _address);
+	if (iter == m_list.end())
+		return;
+	frameBufferList().clearDepthBuffer(&(*iter));
+	m_list.erase(iter);
+	m_index.invalidate();
 }
 
 void DepthBufferList::_createScreenSizeBuffer(u32 _address)
@@ -439,6 +444,7 @@ void DepthBufferList::_createScreenSizeBuffer(u32 _address)
 
 	buffer.m_address = _address;
 	buffer.m_width = pFrameBuffer->m_width;
+	m_index.invalidate();
 
 	buffer.initDepthBufferTexture(pFrameBuffer);
 
@@ -476,6 +482,7 @@ void DepthBufferList::saveBuffer(u32 _address)
 
 		buffer.m_address = _address;
 		buffer.m_width = pFrameBuffer != nullptr ? pFrameBuffer->m_width : VI.width;
+		m_index.invalidate();
 
 		buffer.initDepthBufferTexture(pFrameBuffer);
 
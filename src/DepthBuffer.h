@@ -2,6 +2,7 @@
 #define DEPTHBUFFER_H
 
 #include "Types.h"
+#include "BufferAddressIndex.h"
 #include "Textures.h"
 #include "Graphics/ObjectHandle.h"
 #include "Graphics/Parameter.h"
@@ -64,7 +65,7 @@ public:
 
 	static DepthBufferList & get();
 
-	const u16 * const getZLUT() const {return m_pzLUT;}
+	const u16 * const getZLUT();
 
 private:
 	DepthBufferList();
@@ -74,7 +75,9 @@ private:
 	void _createScreenSizeBuffer(u32 _address);
 
 	typedef std::list<DepthBuffer> DepthBuffers;
+	typedef BufferAddressIndex<DepthBuffer, &DepthBuffer::m_address, &DepthBuffer::m_address> DepthBufferIndex;
 	DepthBuffers m_list;
+	DepthBufferIndex m_index;
 	DepthBuffer *m_pCurrent;
 	u16 * m_pzLUT;
 };
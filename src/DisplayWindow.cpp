@@ -7,6 +7,7 @@
 #include "DisplayWindow.h"
 #include "PluginAPI.h"
 #include "FrameBuffer.h"
+#include "Log.h"
 
 void DisplayWindow::start()
 {
@@ -21,6 +22,8 @@ void DisplayWindow::start()
 
 void DisplayWindow::stop()
 {
+	m_capture.destroy();
+	m_screenReadback.destroy();
 	m_drawer._destroyData();
 	gfxContext.destroy();
 	_stop();
@@ -33,8 +36,24 @@ void DisplayWindow::restart()
 
 void DisplayWindow::swapBuffers()
 {
+	const graphics::ObjectHandle screen = graphics::ObjectHandle::defaultFramebuffer;
+	if (m_bCaptureScreen) {
+		m_capture.capture(FrameCapture::ckScreenshot, screen, 0, m_heightOffset, m_screenWidth, m_screenHeight);
+		m_bCaptureScreen = false;
+	}
+	if (config.debug.captureFrames != 0)
+		m_capture.capture(FrameCapture::ckFrame, screen, 0, m_heightOffset, m_screenWidth, m_screenHeight);
 	m_drawer.drawOSD();
+	// Keep the frames while the frontend reads them
+	if (m_bReadScreen2 && m_buffersSwapCount - m_readScreen2SwapCount <= 2)
+		m_screenReadback.start(screen, 0, m_heightOffset, m_screenWidth, m_screenHeight, m_buffersSwapCount);
 	_swapBuffers();
+	const graphics::Context::RenderStateStatistics stateStatistics = gfxContext.getRenderStateStatistics();
+	LOG(LOG_VERBOSE, "Frame %u: render state calls %u, elided %u; texture parameter calls %u, elided %u\n",
+		m_buffersSwapCount, stateStatistics.stateCalls, stateStatistics.stateElided,
+		stateStatistics.texParamsCalls, stateStatistics.texParamsElided);
+	gfxContext.resetRenderStateStatistics();
+	m_capture.update();
 	if (!RSP.LLE) {
 		if ((config.generalEmulation.hacks & hack_doNotResetOtherModeL) == 0)
 			gDP.otherMode.l = 0;
@@ -50,14 +69,6 @@ void DisplayWindow::setCaptureScreen(const char * const _strDirectory)
 	m_bCaptureScreen = true;
 }
 
-void DisplayWindow::saveScreenshot()
-{
-	if (!m_bCaptureScreen)
-		return;
-	_saveScreenshot();
-	m_bCaptureScreen = false;
-}
-
 void DisplayWindow::saveBufferContent(FrameBuffer * _pBuffer)
 {
 	saveBufferContent(_pBuffer->m_FBO, _pBuffer->m_pTexture);
@@ -72,13 +83,15 @@ void DisplayWindow::saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture
 			pluginPath += L'/';
 		::wcsncpy(m_strScreenDirectory, pluginPath.c_str(), pluginPath.length() + 1);
 	}
-	_saveBufferContent(_fbo, _pTexture);
+	m_capture.capture(FrameCapture::ckScreenshot, _fbo, 0, 0, _pTexture->realWidth, _pTexture->realHeight);
 }
 
 bool DisplayWindow::changeWindow()
 {
 	if (!m_bToggleFullscreen)
 		return false;
+	m_capture.destroy();
+	m_screenReadback.destroy();
 	m_drawer._destroyData();
 	_changeWindow();
 	updateScale();
@@ -91,6 +104,8 @@ void DisplayWindow::closeWindow()
 {
 	if (!m_bToggleFullscreen || !m_bFullscreen)
 		return;
+	m_capture.destroy();
+	m_screenReadback.destroy();
 	if (m_drawer.getDrawingState() != DrawingState::Non)
 		m_drawer._destroyData();
 	_changeWindow();
@@ -111,6 +126,8 @@ bool DisplayWindow::resizeWindow()
 {
 	if (!m_bResizeWindow)
 		return false;
+	m_capture.destroy();
+	m_screenReadback.destroy();
 	m_drawer._destroyData();
 	if (!_resizeWindow())
 		_start();
@@ -183,5 +200,24 @@ void DisplayWindow::readScreen(void **_pDest, long *_pWidth, long *_pHeight)
 
 void DisplayWindow::readScreen2(void * _dest, int * _width, int * _height, int _front)
 {
+	// The back buffer is read directly, as the frontend asked
+	if (_front == 0) {
+		_readScreen2(_dest, _width, _height, _front);
+		return;
+	}
+
+	m_bReadScreen2 = true;
+	m_readScreen2SwapCount = m_buffersSwapCount;
+
+	// The read started at the last swap may still be in flight, so the front buffer
+	// is returned one frame late: the frame shown before the current one.
+	// Until the ring has that frame, the front buffer is read directly.
+	if (_dest != nullptr && _width != nullptr && _height != nullptr &&
+		m_screenReadback.read((u8*)_dest, m_screenWidth, m_screenHeight, m_buffersSwapCount - 2)) {
+		*_width = m_screenWidth;
+		*_height = m_screenHeight;
+		return;
+	}
+
 	_readScreen2(_dest, _width, _height, _front);
 }
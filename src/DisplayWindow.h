@@ -1,6 +1,8 @@
 #pragma once
 #include "Types.h"
 #include "GraphicsDrawer.h"
+#include "FrameCapture.h"
+#include "ScreenReadback.h"
 
 class DisplayWindow
 {
@@ -11,7 +13,6 @@ public:
 	void stop();
 	void restart();
 	void swapBuffers();
-	void saveScreenshot();
 	void saveBufferContent(FrameBuffer * _pBuffer);
 	void saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture *_pTexture);
 	bool changeWindow();
@@ -51,8 +52,10 @@ protected:
 	bool m_bResizeWindow = false;
 	bool m_bFullscreen = false;
 	bool m_bAdjustScreen = false;
+	bool m_bReadScreen2 = false;
 
 	u32 m_buffersSwapCount = 0;
+	u32 m_readScreen2SwapCount = 0;
 	u32 m_width = 0;
 	u32 m_height = 0;
 	u32 m_heightOffset = 0;
@@ -67,13 +70,17 @@ protected:
 	wchar_t m_strScreenDirectory[PLUGIN_PATH_SIZE];
 
 private:
+	friend class FrameCapture;
+
 	GraphicsDrawer m_drawer;
+	FrameCapture m_capture;
+	ScreenReadback m_screenReadback;
 
 	virtual bool _start() = 0;
 	virtual void _stop() = 0;
 	virtual void _swapBuffers() = 0;
-	virtual void _saveScreenshot() = 0;
-	virtual void _saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture *_pTexture) = 0;
+	// Saves RGB pixels, bottom row first. Called on a capture worker thread.
+	virtual void _saveScreenshot(u32 _width, u32 _height, const u8 * _data) = 0;
 	virtual void _changeWindow() = 0;
 	virtual bool _resizeWindow() = 0;
 	virtual void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) = 0;
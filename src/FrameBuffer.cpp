@@ -19,6 +19,16 @@
 #include "FrameBufferInfo.h"
 #include "Log.h"
 
+#define XXH_INLINE_ALL
+#include "xxHash/xxhash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FB_CHECK_SSE2
+#include <emmintrin.h>
+#elif defined(__NEON_OPT)
+#include <arm_neon.h>
+#endif
+
 #include "BufferCopy/ColorBufferToRDRAM.h"
 #include "BufferCopy/DepthBufferToRDRAM.h"
 #include "BufferCopy/RDRAMtoColorBuffer.h"
@@ -58,6 +68,7 @@ FrameBuffer::FrameBuffer()
 	, m_copied(false)
 	, m_pFrameBufferCopyTexture(nullptr)
 	, m_copyFBO(ObjectHandle::defaultFramebuffer)
+	, m_RdramCopySize(0)
 	, m_validityChecked(0)
 {
 	m_loadTileOrigin.uls = m_loadTileOrigin.ult = 0;
@@ -207,6 +218,7 @@ void FrameBuffer::updateEndAddress()
 {
 	const u32 height = max(1U, m_height);
 	m_endAddress = min(RDRAMSize, m_startAddress + (((m_width * height) << m_size >> 1) - 1));
+	frameBufferList().invalidateIndex();
 }
 
 inline
@@ -219,6 +231,110 @@ u32 _cutHeight(u32 _address, u32 _height, u32 _stride)
 	return _height;
 }
 
+// RDRAM pixels are compared without the lowest bit of each 16bit half: alpha of 16bit pixels.
+static const u32 validityMask = 0xFFFEFFFE;
+// Small enough that a few scattered CPU writes stay below the 1% threshold of the validity check.
+static const u32 rdramHashBlockSize = 128;
+
+// Number of dwords in _pData, which do not match _pRef under validityMask
+static
+u32 _countChangedDwords(const u32 * _pData, const u32 * _pRef, u32 _count)
+{
+	u32 changed = 0;
+	u32 i = 0;
+#if defined(FB_CHECK_SSE2)
+	const __m128i mask = _mm_set1_epi32(validityMask);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i equal = zero;
+	for (; i + 4 <= _count; i += 4) {
+		const __m128i diff = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(_pData + i)), _mm_loadu_si128((const __m128i*)(_pRef + i)));
+		// each equal dword adds -1
+		equal = _mm_add_epi32(equal, _mm_cmpeq_epi32(_mm_and_si128(diff, mask), zero));
+	}
+	u32 lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, _mm_sub_epi32(zero, equal));
+	changed = i - (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#elif defined(__NEON_OPT)
+	const uint32x4_t mask = vdupq_n_u32(validityMask);
+	uint32x4_t diffCount = vdupq_n_u32(0);
+	for (; i + 4 <= _count; i += 4) {
+		const uint32x4_t diff = vandq_u32(veorq_u32(vld1q_u32(_pData + i), vld1q_u32(_pRef + i)), mask);
+		// each changed dword adds 1
+		diffCount = vaddq_u32(diffCount, vshrq_n_u32(vtstq_u32(diff, diff), 31));
+	}
+	changed = vgetq_lane_u32(diffCount, 0) + vgetq_lane_u32(diffCount, 1) +
+		vgetq_lane_u32(diffCount, 2) + vgetq_lane_u32(diffCount, 3);
+#endif
+	for (; i < _count; ++i) {
+		if (((_pData[i] ^ _pRef[i]) & validityMask) != 0)
+			++changed;
+	}
+	return changed;
+}
+
+// Number of dwords in _pData, which do not match _value under validityMask
+static
+u32 _countChangedDwords(const u32 * _pData, u32 _value, u32 _count)
+{
+	u32 changed = 0;
+	u32 i = 0;
+	_value &= validityMask;
+#if defined(FB_CHECK_SSE2)
+	const __m128i mask = _mm_set1_epi32(validityMask);
+	const __m128i value = _mm_set1_epi32(_value);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i equal = zero;
+	for (; i + 4 <= _count; i += 4) {
+		const __m128i data = _mm_and_si128(_mm_loadu_si128((const __m128i*)(_pData + i)), mask);
+		equal = _mm_add_epi32(equal, _mm_cmpeq_epi32(data, value));
+	}
+	u32 lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, _mm_sub_epi32(zero, equal));
+	changed = i - (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#elif defined(__NEON_OPT)
+	const uint32x4_t mask = vdupq_n_u32(validityMask);
+	const uint32x4_t value = vdupq_n_u32(_value);
+	uint32x4_t equalCount = vdupq_n_u32(0);
+	for (; i + 4 <= _count; i += 4) {
+		const uint32x4_t data = vandq_u32(vld1q_u32(_pData + i), mask);
+		equalCount = vaddq_u32(equalCount, vshrq_n_u32(vceqq_u32(data, value), 31));
+	}
+	changed = i - (vgetq_lane_u32(equalCount, 0) + vgetq_lane_u32(equalCount, 1) +
+		vgetq_lane_u32(equalCount, 2) + vgetq_lane_u32(equalCount, 3));
+#endif
+	for (; i < _count; ++i) {
+		if ((_pData[i] & validityMask) != _value)
+			++changed;
+	}
+	return changed;
+}
+
+// Hash of a block of up to rdramHashBlockSize bytes under validityMask.
+// Masking is done with wide stores: XXH64 reads 8 bytes at a time, which cannot be forwarded
+// from separate 4 byte stores, and that doubled the cost of the hash.
+static
+u64 _hashRdramBlock(const u32 * _pData, u32 _count)
+{
+	u32 i = 0;
+#if defined(FB_CHECK_SSE2)
+	__m128i block[rdramHashBlockSize >> 4];
+	const __m128i mask = _mm_set1_epi32(validityMask);
+	for (; i + 4 <= _count; i += 4)
+		block[i >> 2] = _mm_and_si128(_mm_loadu_si128((const __m128i*)(_pData + i)), mask);
+#elif defined(__NEON_OPT)
+	uint32x4_t block[rdramHashBlockSize >> 4];
+	const uint32x4_t mask = vdupq_n_u32(validityMask);
+	for (; i + 4 <= _count; i += 4)
+		block[i >> 2] = vandq_u32(vld1q_u32(_pData + i), mask);
+#else
+	u32 block[rdramHashBlockSize >> 2];
+#endif
+	u32 * const pBlock = reinterpret_cast<u32*>(block);
+	for (; i < _count; ++i)
+		pBlock[i] = _pData[i] & validityMask;
+	return XXH64(block, _count << 2, 0);
+}
+
 void FrameBuffer::setBufferClearParams(u32 _fillcolor, s32 _ulx, s32 _uly, s32 _lrx, s32 _lry)
 {
 	m_cleared = true;
@@ -256,14 +372,38 @@ void FrameBuffer::copyRdram()
 		m_fingerprint = true;
 		return;
 	}
+	m_RdramCopySize = dataSize;
+	if (config.frameBufferEmulation.hashedValidityCheck != 0) {
+		m_RdramCopy.clear();
+		const u32 * const pData = (const u32*)RDRAM + (m_startAddress >> 2);
+		const u32 sizeDwords = dataSize >> 2;
+		const u32 blockDwords = rdramHashBlockSize >> 2;
+		m_RdramCopyHashes.resize((sizeDwords + blockDwords - 1) / blockDwords);
+		for (u32 i = 0, block = 0; i < sizeDwords; i += blockDwords, ++block)
+			m_RdramCopyHashes[block] = _hashRdramBlock(pData + i, min(blockDwords, sizeDwords - i));
+		return;
+	}
+	m_RdramCopyHashes.clear();
 	m_RdramCopy.resize(dataSize);
 	memcpy(m_RdramCopy.data(), RDRAM + m_startAddress, dataSize);
 }
 
+bool FrameBuffer::hasRdramCopy() const
+{
+	return !m_RdramCopy.empty() || !m_RdramCopyHashes.empty();
+}
+
+void FrameBuffer::clearRdramCopy()
+{
+	m_RdramCopy.clear();
+	m_RdramCopyHashes.clear();
+	m_RdramCopySize = 0;
+}
+
 void FrameBuffer::setDirty()
 {
 	m_cleared = false;
-	m_RdramCopy.clear();
+	clearRdramCopy();
 }
 
 bool FrameBuffer::isValid(bool _forceCheck) const
@@ -287,12 +427,11 @@ bool FrameBuffer::isValid(bool _forceCheck) const
 		const u32 start = (m_startAddress >> 2) + m_clearParams.uly * ci_width_in_dwords;
 		const u32 * dst = pData + start;
 		u32 wrongPixels = 0;
-		for (s32 y = m_clearParams.uly; y < lry; ++y) {
-			for (s32 x = m_clearParams.ulx; x < m_clearParams.lrx; ++x) {
-				if ((dst[x] & 0xFFFEFFFE) != testColor)
-					++wrongPixels;
+		if (m_clearParams.lrx > m_clearParams.ulx) {
+			for (s32 y = m_clearParams.uly; y < lry; ++y) {
+				wrongPixels += _countChangedDwords(dst + m_clearParams.ulx, testColor, m_clearParams.lrx - m_clearParams.ulx);
+				dst += ci_width_in_dwords;
 			}
-			dst += ci_width_in_dwords;
 		}
 		return wrongPixels < (m_endAddress - m_startAddress) / 400; // threshold level 1% of dwords
 	} else if (m_fingerprint) {
@@ -306,13 +445,20 @@ bool FrameBuffer::isValid(bool _forceCheck) const
 		const u32 * const pCopy = reinterpret_cast<const u32* >(m_RdramCopy.data());
 		const u32 size = static_cast<u32>(m_RdramCopy.size());
 		const u32 size_dwords = size >> 2;
-		u32 start = m_startAddress >> 2;
+		const u32 wrongPixels = _countChangedDwords(pData + (m_startAddress >> 2), pCopy, size_dwords);
+		return wrongPixels < size / 400; // threshold level 1% of dwords
+	} else if (!m_RdramCopyHashes.empty()) {
+		// A changed block is counted as fully changed, which makes this check somewhat stricter than the one with full copy.
+		const u32 size_dwords = m_RdramCopySize >> 2;
+		const u32 blockDwords = rdramHashBlockSize >> 2;
+		const u32 * const pBuffer = pData + (m_startAddress >> 2);
 		u32 wrongPixels = 0;
-		for (u32 i = 0; i < size_dwords; ++i) {
-			if ((pData[start++] & 0xFFFEFFFE) != (pCopy[i] & 0xFFFEFFFE))
-				++wrongPixels;
+		for (u32 i = 0, block = 0; i < size_dwords; i += blockDwords, ++block) {
+			const u32 count = min(blockDwords, size_dwords - i);
+			if (_hashRdramBlock(pBuffer + i, count) != m_RdramCopyHashes[block])
+				wrongPixels += count;
 		}
-		return wrongPixels < size / 400; // threshold level 1% of dwords
+		return wrongPixels < m_RdramCopySize / 400; // threshold level 1% of dwords
 	}
 	return true; // No data to decide
 }
@@ -556,6 +702,7 @@ void FrameBufferList::init()
 void FrameBufferList::destroy() {
 	gfxContext.bindFramebuffer(bufferTarget::FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
 	m_list.clear();
+	m_index.invalidate();
 	m_pCurrent = nullptr;
 	m_pCopy = nullptr;
 	m_overscan.destroy();
@@ -592,20 +739,14 @@ void FrameBufferList::setCurrentDrawBuffer() const
 
 FrameBuffer * FrameBufferList::findBuffer(u32 _startAddress)
 {
-	for (auto iter = m_list.begin(); iter != m_list.end(); ++iter) {
-		if (iter->m_startAddress <= _startAddress && iter->m_endAddress >= _startAddress) // [  {  ]
-			return &(*iter);
-	}
-	return nullptr;
+	auto iter = m_index.findContaining(m_list, _startAddress); // [  {  ]
+	return iter != m_list.end() ? &(*iter) : nullptr;
 }
 
 FrameBuffer * FrameBufferList::getBuffer(u32 _startAddress)
 {
-	for (auto iter = m_list.begin(); iter != m_list.end(); ++iter) {
-		if (iter->m_startAddress == _startAddress)
-			return &(*iter);
-	}
-	return nullptr;
+	auto iter = m_index.find(m_list, _startAddress);
+	return iter != m_list.end() ? &(*iter) : nullptr;
 }
 
 inline
@@ -626,9 +767,10 @@ void FrameBufferList::removeIntersections()
 {
 	assert(!m_list.empty());
 
-	FrameBuffers::iterator iter = m_list.end();
-	do {
-		--iter;
+	// Only buffers intersecting the current one can be affected. Visit them from the back
+	// of the list, as the current buffer's end address may be cut on the way.
+	m_index.findOverlapping(m_list, m_pCurrent->m_startAddress, m_pCurrent->m_endAddress, m_intersections);
+	for (FrameBuffers::iterator iter : m_intersections) {
 		if (&(*iter) == m_pCurrent)
 			continue;
 		if (iter->m_startAddress <= m_pCurrent->m_startAddress && iter->m_endAddress >= m_pCurrent->m_startAddress) { // [  {  ]
@@ -636,15 +778,16 @@ void FrameBufferList::removeIntersections()
 				iter->m_endAddress = m_pCurrent->m_startAddress - 1;
 				continue;
 			}
-			iter = m_list.erase(iter);
+			m_list.erase(iter);
 		} else if (m_pCurrent->m_startAddress <= iter->m_startAddress && m_pCurrent->m_endAddress >= iter->m_startAddress) { // {  [  }
 			if (isOverlapping(m_pCurrent, &(*iter))) {
 				m_pCurrent->m_endAddress = iter->m_startAddress - 1;
 				continue;
 			}
-			iter = m_list.erase(iter);
+			m_list.erase(iter);
 		}
-	} while (iter != m_list.begin());
+	}
+	m_index.invalidate();
 }
 
 FrameBuffer * FrameBufferList::findTmpBuffer(u32 _address)
@@ -661,6 +804,7 @@ void FrameBufferList::_createScreenSizeBuffer()
 	if (VI.height == 0)
 		return;
 	m_list.emplace_front();
+	m_index.invalidate();
 	FrameBuffer & buffer = m_list.front();
 	buffer.init(VI.width * 2, G_IM_FMT_RGBA, G_IM_SIZ_16b, VI.width, false);
 }
@@ -700,7 +844,7 @@ void FrameBufferList::saveBuffer(u32 _address, u16 _format, u16 _size, u16 _widt
 			!m_pCurrent->m_copiedToRdram &&
 			!m_pCurrent->m_cfb &&
 			!m_pCurrent->m_cleared &&
-			m_pCurrent->m_RdramCopy.empty() &&
+			!m_pCurrent->hasRdramCopy() &&
 			m_pCurrent->m_height > 1) {
 			m_pCurrent->copyRdram();
 		}
@@ -757,6 +901,7 @@ void FrameBufferList::saveBuffer(u32 _address, u16 _format, u16 _size, u16 _widt
 				return;
 			} else if (isOverlappingBuffer(m_pCurrent)) {
 				m_pCurrent->m_endAddress = _address - 1;
+				m_index.invalidate();
 				m_pCurrent = nullptr;
 			} else {
 				removeBuffer(m_pCurrent->m_startAddress);
@@ -790,6 +935,7 @@ void FrameBufferList::saveBuffer(u32 _address, u16 _format, u16 _size, u16 _widt
 	if  (bNew) {
 		// Wasn't found or removed, create a new one
 		m_list.emplace_front();
+		m_index.invalidate();
 		FrameBuffer & buffer = m_list.front();
 		buffer.init(_address, _format, _size, _width, _cfb);
 		m_pCurrent = &buffer;
@@ -835,6 +981,7 @@ void FrameBufferList::removeAux()
 				gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
 			}
 			iter = m_list.erase(iter);
+			m_index.invalidate();
 			if (iter == m_list.end())
 				return;
 		}
@@ -843,15 +990,15 @@ void FrameBufferList::removeAux()
 
 void FrameBufferList::removeBuffer(u32 _address )
 {
-	for (auto iter = m_list.begin(); iter != m_list.end(); ++iter)
-		if (iter->m_startAddress == _address) {
-			if (&(*iter) == m_pCurrent) {
-				m_pCurrent = nullptr;
-				gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
-			}
-			m_list.erase(iter);
-			return;
-		}
+	auto iter = m_index.find(m_list, _address);
+	if (iter == m_list.end())
+		return;
+	if (&(*iter) == m_pCurrent) {
+		m_pCurrent = nullptr;
+		gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
+	}
+	m_list.erase(iter);
+	m_index.invalidate();
 }
 
 void FrameBufferList::removeBuffers(u32 _width)
@@ -864,6 +1011,7 @@ void FrameBufferList::removeBuffers(u32 _width)
 				gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
 			}
 			iter = m_list.erase(iter);
+			m_index.invalidate();
 			if (iter == m_list.end())
 				return;
 		}
@@ -1575,7 +1723,7 @@ bool FrameBuffer_CopyDepthBuffer( u32 address )
 	if (pCopyBuffer != nullptr) {
 		// This code is mainly to emulate Zelda MM camera.
 		ColorBufferToRDRAM::get().copyToRDRAM(pCopyBuffer->m_startAddress, true);
-		pCopyBuffer->m_RdramCopy.resize(0); // To disable validity check by RDRAM content. CPU may change content of the buffer for some unknown reason.
+		pCopyBuffer->clearRdramCopy(); // To disable validity check by RDRAM content. CPU may change content of the buffer for some unknown reason.
 		fblist.setCopyBuffer(nullptr);
 		return true;
 	}
@@ -6,6 +6,7 @@
 
 #include "Types.h"
 #include "Textures.h"
+#include "BufferAddressIndex.h"
 #include "Graphics/ObjectHandle.h"
 
 struct gDPTile;
@@ -25,6 +26,8 @@ struct FrameBuffer
 	void setBufferClearParams(u32 _fillcolor, s32 _ulx, s32 _uly, s32 _lrx, s32 _lry);
 	void copyRdram();
 	void setDirty();
+	bool hasRdramCopy() const;
+	void clearRdramCopy();
 	bool isValid(bool _forceCheck) const;
 	bool isAuxiliary() const;
 
@@ -72,6 +75,9 @@ struct FrameBuffer
 	CachedTexture * m_pFrameBufferCopyTexture;
 
 	std::vector<u8> m_RdramCopy;
+	// Hashed validity check keeps a hash of each 128 byte block of the buffer instead of m_RdramCopy
+	std::vector<u64> m_RdramCopyHashes;
+	u32 m_RdramCopySize;
 
 private:
 	struct {
@@ -121,6 +127,8 @@ public:
 
 	void fillBufferInfo(void * _pinfo, u32 _size);
 
+	void invalidateIndex() { m_index.invalidate(); }
+
 	static FrameBufferList & get();
 
 private:
@@ -164,7 +172,10 @@ private:
 	};
 
 	typedef std::list<FrameBuffer> FrameBuffers;
+	typedef BufferAddressIndex<FrameBuffer, &FrameBuffer::m_startAddress, &FrameBuffer::m_endAddress> FrameBufferIndex;
 	FrameBuffers m_list;
+	FrameBufferIndex m_index;
+	std::vector<FrameBuffers::iterator> m_intersections;
 	FrameBuffer * m_pCurrent;
 	FrameBuffer * m_pCopy;
 	u32 m_prevColorImageHeight;
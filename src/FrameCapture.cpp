@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cwchar>
+#include <algorithm>
+#include <functional>
+#include <osal_files.h>
+#include <Graphics/Context.h>
+#include <Graphics/Parameters.h>
+#include <Graphics/PixelBuffer.h>
+#include "DisplayWindow.h"
+#include "FrameBuffer.h"
+#include "FrameCapture.h"
+#include "PluginAPI.h"
+#include "RSP.h"
+#include "Log.h"
+#include "wst.h"
+
+using namespace graphics;
+
+static const u32 captureNumReads = 3;
+static const u32 captureReadLatency = 2;                     // buffer swaps
+static const size_t captureMaxQueueSize = 256 * 1024 * 1024; // bytes of pixels waiting for the workers
+static const u32 captureMaxThreads = 4;
+
+FrameCapture::FrameCapture()
+: m_nextRead(0)
+, m_frame(0)
+, m_queueSize(0)
+, m_busy(0)
+, m_pathExists(false)
+, m_stop(false)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+	_stopWorkers();
+}
+
+bool FrameCapture::capture(Kind _kind, ObjectHandle _fbo, s32 _x, s32 _y, u32 _width, u32 _height)
+{
+	if (_width == 0 || _height == 0)
+		return false;
+
+	if (m_reads.empty())
+		m_reads.resize(captureNumReads);
+
+	// All buffers are in use if several captures are started within a frame
+	Read & read = m_reads[m_nextRead];
+	if (read.pending)
+		_finish(read);
+
+	const size_t size = size_t(_width) * _height * 4;
+	if (!read.buffer || read.bufferSize < size) {
+		read.buffer.reset(gfxContext.createPixelReadBuffer(size));
+		read.bufferSize = read.buffer ? size : 0;
+		if (!read.buffer) {
+			static bool warned = false;
+			if (!warned)
+				LOG(LOG_WARNING, "Frame capture is not supported without pixel buffers\n");
+			warned = true;
+			return false;
+		}
+	}
+
+	if (_kind == ckFrame && m_framePath.empty()) {
+		wchar_t path[PLUGIN_PATH_SIZE];
+		api().GetUserDataPath(path);
+		m_framePath = path;
+		m_framePath += wst("/frames/");
+	}
+
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, _fbo);
+	{
+		PixelBufferBinder<PixelReadBuffer> binder(read.buffer.get());
+		read.buffer->readPixels(_x, _y, _width, _height, colorFormat::RGBA, datatype::UNSIGNED_BYTE);
+	}
+	FrameBuffer * pBuffer = frameBufferList().getCurrent();
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER,
+		pBuffer != nullptr ? pBuffer->m_FBO : ObjectHandle::defaultFramebuffer);
+
+	read.kind = _kind;
+	read.width = _width;
+	read.height = _height;
+	read.swapCount = dwnd().getBuffersSwapCount();
+	read.frame = _kind == ckFrame ? m_frame++ : 0;
+	read.pending = true;
+	m_nextRead = (m_nextRead + 1) % captureNumReads;
+	return true;
+}
+
+void FrameCapture::update()
+{
+	const u32 swapCount = dwnd().getBuffersSwapCount();
+	// Oldest first, so that frames reach the workers in order
+	for (u32 i = 0; i < m_reads.size(); ++i) {
+		Read & read = m_reads[(m_nextRead + i) % m_reads.size()];
+		if (read.pending && swapCount - read.swapCount >= captureReadLatency)
+			_finish(read);
+	}
+}
+
+void FrameCapture::_finish(Read & _read)
+{
+	_read.pending = false;
+
+	const u32 size = _read.width * _read.height * 4;
+	PixelBufferBinder<PixelReadBuffer> binder(_read.buffer.get());
+	const u8 * pixelData = (const u8*)_read.buffer->getDataRange(0, size);
+	if (pixelData == nullptr)
+		return;
+
+	Job * job = new Job;
+	job->kind = _read.kind;
+	job->width = _read.width;
+	job->height = _read.height;
+	job->data.assign(pixelData, pixelData + size);
+	_read.buffer->closeReadBuffer();
+
+	if (_read.kind == ckFrame) {
+		std::string romName(RSP.romname);
+		std::replace(romName.begin(), romName.end(), ' ', '_');
+		std::replace(romName.begin(), romName.end(), ':', ';');
+		wchar_t strRomName[32];
+		::mbstowcs(strRomName, romName.c_str(), 31);
+		strRomName[31] = 0;
+		wchar_t fileName[64];
+		swprintf(fileName, 64, wst("%ls_%06u.qoi"), strRomName, _read.frame);
+		job->fileName = m_framePath + fileName;
+	}
+
+	_push(job);
+}
+
+void FrameCapture::_push(Job * _job)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_threads.empty()) {
+		m_stop = false;
+		u32 numThreads = std::thread::hardware_concurrency();
+		numThreads = std::min(std::max(numThreads, 2U) - 1, captureMaxThreads);
+		for (u32 i = 0; i < numThreads; ++i)
+			m_threads.emplace_back(std::bind(&FrameCapture::_work, this));
+	}
+
+	// Wait rather than drop, so that a frame sequence has no gaps
+	m_idle.wait(lock, [this] { return m_queueSize < captureMaxQueueSize; });
+	m_queueSize += _job->data.size();
+	m_jobs.push_back(_job);
+	lock.unlock();
+	m_condvar.notify_one();
+}
+
+void FrameCapture::_work()
+{
+	while (true) {
+		Job * job = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condvar.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+			if (m_jobs.empty())
+				return;
+			job = m_jobs.front();
+			m_jobs.pop_front();
+			++m_busy;
+		}
+
+		_write(*job);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_queueSize -= job->data.size();
+			--m_busy;
+		}
+		m_idle.notify_all();
+
+		delete job;
+	}
+}
+
+void FrameCapture::_write(const Job & _job)
+{
+	if (_job.kind == ckFrame) {
+		if (!_writeQOI(_job))
+			LOG(LOG_ERROR, "Frame capture: failed to write %ls\n", _job.fileName.c_str());
+		return;
+	}
+
+	// RGB rows, bottom row first, as screenshots were always read
+	const u32 numPixels = _job.width * _job.height;
+	std::vector<u8> rgb(numPixels * 3);
+	for (u32 i = 0; i < numPixels; ++i)
+		memcpy(rgb.data() + i * 3, _job.data.data() + i * 4, 3);
+
+	// The window picks a free file name, which must not race with other workers
+	std::lock_guard<std::mutex> lock(m_screenshotMutex);
+	dwnd()._saveScreenshot(_job.width, _job.height, rgb.data());
+}
+
+// The Quite OK Image format: lossless and several times faster to encode than PNG.
+bool FrameCapture::_writeQOI(const Job & _job)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_pathExists) {
+			if (!osal_path_existsW(m_framePath.c_str()) && osal_mkdirp(m_framePath.c_str()) != 0)
+				return false;
+			m_pathExists = true;
+		}
+	}
+
+	struct Pixel { u8 r, g, b, a; };
+	const u32 width = _job.width;
+	const u32 height = _job.height;
+	std::vector<u8> out;
+	out.reserve(14 + size_t(width) * height * 4 + 8);
+
+	auto put32 = [&out](u32 _value) {
+		out.push_back(u8(_value >> 24));
+		out.push_back(u8(_value >> 16));
+		out.push_back(u8(_value >> 8));
+		out.push_back(u8(_value));
+	};
+	out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+	put32(width);
+	put32(height);
+	out.push_back(3); // RGB
+	out.push_back(0); // sRGB
+
+	Pixel index[64];
+	memset(index, 0, sizeof(index));
+	Pixel prev = { 0, 0, 0, 255 };
+	u32 run = 0;
+
+	// Top row first
+	for (u32 y = 0; y < height; ++y) {
+		const u8 * row = _job.data.data() + size_t(height - 1 - y) * width * 4;
+		for (u32 x = 0; x < width; ++x) {
+			const Pixel px = { row[x * 4], row[x * 4 + 1], row[x * 4 + 2], 255 };
+			const bool last = y == height - 1 && x == width - 1;
+			if (px.r == prev.r && px.g == prev.g && px.b == prev.b) {
+				if (++run == 62 || last) {
+					out.push_back(u8(0xC0 | (run - 1)));
+					run = 0;
+				}
+				continue;
+			}
+
+			if (run > 0) {
+				out.push_back(u8(0xC0 | (run - 1)));
+				run = 0;
+			}
+
+			const u32 hash = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+			if (index[hash].r == px.r && index[hash].g == px.g && index[hash].b == px.b && index[hash].a == px.a) {
+				out.push_back(u8(hash));
+			} else {
+				index[hash] = px;
+				const s8 vr = s8(px.r - prev.r);
+				const s8 vg = s8(px.g - prev.g);
+				const s8 vb = s8(px.b - prev.b);
+				const s8 vgr = s8(vr - vg);
+				const s8 vgb = s8(vb - vg);
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+					out.push_back(u8(0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2)));
+				} else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+					out.push_back(u8(0x80 | (vg + 32)));
+					out.push_back(u8(((vgr + 8) << 4) | (vgb + 8)));
+				} else {
+					out.insert(out.end(), { 0xFE, px.r, px.g, px.b });
+				}
+			}
+			prev = px;
+		}
+	}
+	out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+
+	FILE * file;
+#ifdef OS_WINDOWS
+	file = _wfopen(_job.fileName.c_str(), wst("wb"));
+#else
+	constexpr size_t bufSize = PLUGIN_PATH_SIZE * 6;
+	char cbuf[bufSize];
+	wcstombs(cbuf, _job.fileName.c_str(), bufSize);
+	file = fopen(cbuf, "wb");
+#endif //OS_WINDOWS
+	if (file == nullptr)
+		return false;
+	const bool res = fwrite(out.data(), 1, out.size(), file) == out.size();
+	fclose(file);
+	return res;
+}
+
+void FrameCapture::destroy()
+{
+	for (u32 i = 0; i < m_reads.size(); ++i) {
+		Read & read = m_reads[(m_nextRead + i) % m_reads.size()];
+		if (read.pending)
+			_finish(read);
+	}
+	m_reads.clear();
+	m_nextRead = 0;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait(lock, [this] { return m_jobs.empty() && m_busy == 0; });
+	}
+	_stopWorkers();
+}
+
+void FrameCapture::_stopWorkers()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condvar.notify_all();
+
+	for (auto & thread : m_threads)
+		thread.join();
+	m_threads.clear();
+}
@@ -0,0 +1,84 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Types.h"
+#include "Graphics/ObjectHandle.h"
+
+namespace graphics {
+	class PixelReadBuffer;
+}
+
+// Takes screenshots and frame sequences without stalling rendering.
+// Pixels are read into pixel buffers and fetched a couple of buffer swaps
+// later, when the GPU has written them. Worker threads encode and write
+// the files.
+class FrameCapture
+{
+public:
+	enum Kind {
+		ckScreenshot, // saved by the display window
+		ckFrame       // numbered QOI image of a frame sequence
+	};
+
+	FrameCapture();
+	~FrameCapture();
+
+	// Starts reading an area of _fbo. Returns false if pixel buffers are not supported.
+	bool capture(Kind _kind, graphics::ObjectHandle _fbo, s32 _x, s32 _y, u32 _width, u32 _height);
+	// Hands reads which the GPU has finished to the workers. Called once per buffer swap.
+	void update();
+	// Waits for all reads and files, then releases the pixel buffers and workers.
+	void destroy();
+
+private:
+	struct Read {
+		std::unique_ptr<graphics::PixelReadBuffer> buffer;
+		size_t bufferSize = 0;
+		Kind kind = ckScreenshot;
+		u32 width = 0;
+		u32 height = 0;
+		u32 swapCount = 0;
+		u32 frame = 0;
+		bool pending = false;
+	};
+
+	struct Job {
+		Kind kind;
+		u32 width;
+		u32 height;
+		std::wstring fileName;
+		std::vector<u8> data; // RGBA8, bottom row first
+	};
+
+	void _finish(Read & _read);
+	void _push(Job * _job);
+	void _work();
+	void _write(const Job & _job);
+	bool _writeQOI(const Job & _job);
+	void _stopWorkers();
+
+	std::vector<Read> m_reads;
+	u32 m_nextRead;
+	u32 m_frame;
+	std::wstring m_framePath;
+
+	std::deque<Job*> m_jobs;
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_condvar;
+	std::condition_variable m_idle;
+	std::mutex m_screenshotMutex;
+	size_t m_queueSize;
+	u32 m_busy;
+	bool m_pathExists;
+	bool m_stop;
+};
+
+#endif // FRAMECAPTURE_H
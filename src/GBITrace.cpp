@@ -0,0 +1,296 @@
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "GBITrace.h"
+#include "N64.h"
+#include "RSP.h"
+#include "gDP.h"
+#include "gSP.h"
+#include "CRC.h"
+#include "Config.h"
+#include "PluginAPI.h"
+#include "Log.h"
+#include "wst.h"
+
+static const u32 traceMagic = 0x52544C47;       // "GLTR"
+static const u32 traceVersion = 1;
+static const u32 traceFrameTag = 0x4D415246;    // "FRAM"
+static const u32 traceIndexTag = 0x58444E49;    // "INDX"
+static const u32 traceEndTag = 0x444E4554;      // "TEND"
+static const u32 tracePageSize = 4096;
+static const u32 traceDMEMSize = 0x1000;
+
+GBITrace & GBITrace::get()
+{
+	static GBITrace trace;
+	return trace;
+}
+
+template <typename T>
+static
+bool _write(FILE * _file, const T & _value)
+{
+	return fwrite(&_value, sizeof(T), 1, _file) == 1;
+}
+
+template <typename T>
+static
+bool _read(FILE * _file, T & _value)
+{
+	return fread(&_value, sizeof(T), 1, _file) == 1;
+}
+
+bool GBITrace::_open(TraceMode _mode)
+{
+	wchar_t tracePath[PLUGIN_PATH_SIZE + 20];
+	api().GetUserDataPath(tracePath);
+	gln_wcscat(tracePath, wst("/gliden64.gbitrace"));
+#ifdef OS_WINDOWS
+	m_file = _wfopen(tracePath, _mode == tmRecord ? wst("wb") : wst("rb"));
+#else
+	constexpr size_t bufSize = PLUGIN_PATH_SIZE * 6;
+	char cbuf[bufSize];
+	wcstombs(cbuf, tracePath, bufSize);
+	m_file = fopen(cbuf, _mode == tmRecord ? "wb" : "rb");
+#endif //OS_WINDOWS
+	if (m_file == nullptr) {
+		LOG(LOG_ERROR, "GBI trace: failed to open trace file\n");
+		return false;
+	}
+
+	m_rdramSize = RDRAMSize + 1;
+	m_frame = 0;
+	m_mismatches = 0;
+	m_index.clear();
+	m_commands.clear();
+
+	if (_mode == tmRecord) {
+		// The first frame stores all of RDRAM
+		m_rdram.assign(m_rdramSize, 0);
+		m_pages.clear();
+		for (u32 page = 0; page < m_rdramSize / tracePageSize; ++page)
+			m_pages.push_back(page);
+		memcpy(m_rdram.data(), RDRAM, m_rdramSize);
+		m_offset = sizeof(u32) * 3;
+		return _write(m_file, traceMagic) && _write(m_file, traceVersion) && _write(m_file, m_rdramSize);
+	}
+
+	u32 magic = 0, version = 0, rdramSize = 0;
+	if (!_read(m_file, magic) || !_read(m_file, version) || !_read(m_file, rdramSize) ||
+		magic != traceMagic || version != traceVersion || rdramSize != m_rdramSize) {
+		LOG(LOG_ERROR, "GBI trace: trace file does not match this emulator setup\n");
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+	u32 numFrames = 0, endTag = 0;
+	u64 indexOffset = 0;
+	const long footerSize = sizeof(numFrames) + sizeof(indexOffset) + sizeof(endTag);
+	if (fseek(m_file, -footerSize, SEEK_END) != 0 || !_read(m_file, numFrames) ||
+		!_read(m_file, indexOffset) || !_read(m_file, endTag) || endTag != traceEndTag) {
+		LOG(LOG_ERROR, "GBI trace: trace file is incomplete\n");
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+	fseek(m_file, sizeof(u32) * 3, SEEK_SET);
+	LOG(LOG_MINIMAL, "GBI trace: replaying %u frames\n", numFrames);
+
+	m_rdram.assign(m_rdramSize, 0);
+	m_dmem.assign(traceDMEMSize, 0);
+	m_offset = sizeof(u32) * 3;
+	return true;
+}
+
+void GBITrace::beginFrame()
+{
+	if (!m_started) {
+		m_started = true;
+		if (config.debug.gbiTrace == Config::gtRecord && _open(tmRecord))
+			m_mode = tmRecord;
+		else if (config.debug.gbiTrace == Config::gtReplay && _open(tmReplay))
+			m_mode = tmReplay;
+	}
+
+	if (m_mode == tmNone || m_inFrame)
+		return;
+
+	if (m_mode == tmRecord) {
+		// Pages changed by the CPU or by us since the last frame
+		if (m_frame != 0) {
+			m_pages.clear();
+			for (u32 page = 0; page < m_rdramSize / tracePageSize; ++page) {
+				const u32 offset = page * tracePageSize;
+				if (memcmp(m_rdram.data() + offset, RDRAM + offset, tracePageSize) != 0) {
+					memcpy(m_rdram.data() + offset, RDRAM + offset, tracePageSize);
+					m_pages.push_back(page);
+				}
+			}
+		}
+		m_dmem.assign(DMEM, DMEM + traceDMEMSize);
+		m_commands.clear();
+	} else {
+		if (!_readFrame()) {
+			_close();
+			return;
+		}
+		_swapMemory();
+	}
+
+	m_nextCommand = 0;
+	m_commandMismatch = false;
+	m_inFrame = true;
+}
+
+void GBITrace::_command(u32 _pc, u32 _w0, u32 _w1)
+{
+	if (!m_inFrame)
+		return;
+
+	if (m_mode == tmRecord) {
+		m_commands.push_back({ _pc, _w0, _w1 });
+		return;
+	}
+
+	if (m_commandMismatch)
+		return;
+	if (m_nextCommand >= m_commands.size()) {
+		LOG(LOG_WARNING, "GBI trace: frame %u runs more commands than recorded\n", m_frame);
+		m_commandMismatch = true;
+		return;
+	}
+	const Command & recorded = m_commands[m_nextCommand++];
+	if (recorded.pc != _pc || recorded.w0 != _w0 || recorded.w1 != _w1) {
+		LOG(LOG_WARNING, "GBI trace: frame %u command %u is 0x%08X: %08X %08X, recorded 0x%08X: %08X %08X\n",
+			m_frame, m_nextCommand - 1, _pc, _w0, _w1, recorded.pc, recorded.w0, recorded.w1);
+		m_commandMismatch = true;
+	}
+}
+
+void GBITrace::endFrame()
+{
+	if (!m_inFrame)
+		return;
+	m_inFrame = false;
+
+	if (m_mode == tmRecord) {
+		_recordFrame();
+	} else if (m_mode == tmReplay) {
+		_swapMemory();
+		if (!m_commandMismatch && m_nextCommand < m_commands.size()) {
+			LOG(LOG_WARNING, "GBI trace: frame %u runs %u of %u recorded commands\n",
+				m_frame, m_nextCommand, u32(m_commands.size()));
+			m_commandMismatch = true;
+		}
+		const u32 digest = _digest();
+		if (digest != m_recordedDigest)
+			LOG(LOG_WARNING, "GBI trace: frame %u ends in a different RDP state\n", m_frame);
+		if (m_commandMismatch || digest != m_recordedDigest)
+			++m_mismatches;
+	}
+	++m_frame;
+}
+
+void GBITrace::_recordFrame()
+{
+	const u32 numPages = u32(m_pages.size());
+	const u32 numCommands = u32(m_commands.size());
+	bool res = _write(m_file, traceFrameTag) && _write(m_file, m_frame) &&
+		fwrite(m_dmem.data(), 1, traceDMEMSize, m_file) == traceDMEMSize &&
+		_write(m_file, numPages);
+	for (u32 i = 0; res && i < numPages; ++i)
+		res = _write(m_file, m_pages[i]) &&
+			fwrite(m_rdram.data() + m_pages[i] * tracePageSize, 1, tracePageSize, m_file) == tracePageSize;
+	res = res && _write(m_file, numCommands) &&
+		fwrite(m_commands.data(), sizeof(Command), numCommands, m_file) == numCommands &&
+		_write(m_file, _digest());
+
+	if (!res) {
+		LOG(LOG_ERROR, "GBI trace: failed to write frame %u\n", m_frame);
+		_close();
+		return;
+	}
+
+	m_index.push_back(m_offset);
+	m_offset += sizeof(u32) * 5 + traceDMEMSize + u64(numPages) * (sizeof(u32) + tracePageSize) +
+		u64(numCommands) * sizeof(Command);
+}
+
+bool GBITrace::_readFrame()
+{
+	u32 tag = 0, frame = 0, numPages = 0, numCommands = 0;
+	if (!_read(m_file, tag) || tag != traceFrameTag || !_read(m_file, frame) ||
+		fread(m_dmem.data(), 1, traceDMEMSize, m_file) != traceDMEMSize ||
+		!_read(m_file, numPages))
+		return false;
+
+	for (u32 i = 0; i < numPages; ++i) {
+		u32 page = 0;
+		if (!_read(m_file, page) || page >= m_rdramSize / tracePageSize ||
+			fread(m_rdram.data() + page * tracePageSize, 1, tracePageSize, m_file) != tracePageSize)
+			return false;
+	}
+
+	if (!_read(m_file, numCommands))
+		return false;
+	m_commands.resize(numCommands);
+	return fread(m_commands.data(), sizeof(Command), numCommands, m_file) == numCommands &&
+		_read(m_file, m_recordedDigest);
+}
+
+// Exchanges emulated and recorded memory, so that the emulator gets its own back after the frame.
+void GBITrace::_swapMemory()
+{
+	std::swap_ranges(m_rdram.begin(), m_rdram.end(), RDRAM);
+	std::swap_ranges(m_dmem.begin(), m_dmem.end(), DMEM);
+}
+
+u32 GBITrace::_digest() const
+{
+	const u32 state[] = {
+		u32(gDP.otherMode._u64), u32(gDP.otherMode._u64 >> 32),
+		gDP.combine.muxs0, gDP.combine.muxs1,
+		gSP.geometryMode,
+		gDP.colorImage.address, gDP.colorImage.width,
+		gDP.depthImageAddress,
+		gDP.textureImage.address,
+		gSP.tri_num
+	};
+	return CRC_Calculate(0xFFFFFFFF, state, sizeof(state));
+}
+
+void GBITrace::stop()
+{
+	_close();
+	m_started = false;
+}
+
+void GBITrace::_close()
+{
+	if (m_file != nullptr) {
+		if (m_mode == tmRecord) {
+			// Index of frame offsets and a footer locating it
+			const u32 numFrames = u32(m_index.size());
+			const bool res = _write(m_file, traceIndexTag) && _write(m_file, numFrames) &&
+				fwrite(m_index.data(), sizeof(u64), numFrames, m_file) == numFrames &&
+				_write(m_file, numFrames) && _write(m_file, m_offset) && _write(m_file, traceEndTag);
+			if (!res)
+				LOG(LOG_ERROR, "GBI trace: failed to write frame index\n");
+			LOG(LOG_MINIMAL, "GBI trace: recorded %u frames\n", numFrames);
+		} else if (m_mode == tmReplay) {
+			LOG(LOG_MINIMAL, "GBI trace: replayed %u frames, %u differ\n", m_frame, m_mismatches);
+		}
+		fclose(m_file);
+		m_file = nullptr;
+	}
+
+	m_mode = tmNone;
+	m_inFrame = false;
+	m_rdram.clear();
+	m_rdram.shrink_to_fit();
+	m_dmem.clear();
+	m_pages.clear();
+	m_commands.clear();
+	m_index.clear();
+}
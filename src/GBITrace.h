@@ -0,0 +1,79 @@
+#ifndef GBI_TRACE_H
+#define GBI_TRACE_H
+
+#include <stdio.h>
+#include <vector>
+#include "Types.h"
+
+// Binary trace of the display lists run by RSP_ProcessDList, written to gliden64.gbitrace.
+// Each frame record holds DMEM, the RDRAM pages changed since the previous frame,
+// the commands run and a digest of the RDP state they left behind.
+// An index of frame offsets closes the file.
+// Replay feeds the recorded memory through the usual display list processing
+// in place of the emulated one and reports where commands or digests diverge,
+// so that builds can be compared on the same input.
+// GBITraceReplay/ builds a driver which replays a trace without an emulator.
+class GBITrace
+{
+public:
+	void beginFrame();
+	void endFrame();
+	// Ends the trace of this emulation session
+	void stop();
+
+	void command(u32 _pc, u32 _w0, u32 _w1)
+	{
+		if (m_mode != tmNone)
+			_command(_pc, _w0, _w1);
+	}
+
+	static GBITrace & get();
+
+private:
+	GBITrace() = default;
+	GBITrace(const GBITrace &) = delete;
+
+	enum TraceMode {
+		tmNone,
+		tmRecord,
+		tmReplay
+	};
+
+	struct Command {
+		u32 pc;
+		u32 w0;
+		u32 w1;
+	};
+
+	bool _open(TraceMode _mode);
+	void _close();
+	void _command(u32 _pc, u32 _w0, u32 _w1);
+	void _recordFrame();
+	bool _readFrame();
+	void _swapMemory();
+	u32 _digest() const;
+
+	TraceMode m_mode = tmNone;
+	bool m_started = false;
+	bool m_inFrame = false;
+	FILE * m_file = nullptr;
+	u32 m_frame = 0;
+	u32 m_rdramSize = 0;
+	u64 m_offset = 0;
+	std::vector<u8> m_rdram;      // record: RDRAM as last written; replay: RDRAM of the trace
+	std::vector<u8> m_dmem;       // DMEM of the current frame
+	std::vector<u32> m_pages;     // record: pages changed before the current frame
+	std::vector<Command> m_commands;
+	std::vector<u64> m_index;     // file offsets of the frames
+	u32 m_recordedDigest = 0;
+	u32 m_nextCommand = 0;
+	u32 m_mismatches = 0;
+	bool m_commandMismatch = false;
+};
+
+inline GBITrace & gbiTrace()
+{
+	return GBITrace::get();
+}
+
+#endif // GBI_TRACE_H
@@ -0,0 +1,314 @@
+// The part of the mupen64plus core the plugin needs to replay a GBI trace:
+// an in-memory configuration, the user paths and an offscreen EGL context.
+// It is a module of its own, loaded with local symbol scope as the real core is,
+// because the plugin has global function pointers with the same names.
+
+#define M64P_CORE_PROTOTYPES
+#include <string.h>
+#include <sys/stat.h>
+#include <map>
+#include <string>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "m64p_common.h"
+#include "m64p_config.h"
+#include "m64p_vidext.h"
+
+struct Parameter
+{
+	m64p_type type;
+	int intValue;
+	float floatValue;
+	std::string stringValue;
+};
+
+typedef std::map<std::string, Parameter> Section;
+
+static std::map<std::string, Section> sections;
+static std::string dataPath;
+static std::string sharedDataFile;
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLSurface surface = EGL_NO_SURFACE;
+static EGLContext context = EGL_NO_CONTEXT;
+static std::map<m64p_GLattr, int> glAttributes;
+
+static
+Parameter * _findParameter(m64p_handle _handle, const char * _name)
+{
+	if (_handle == nullptr || _name == nullptr)
+		return nullptr;
+	Section & section = *static_cast<Section*>(_handle);
+	auto iter = section.find(_name);
+	return iter != section.end() ? &iter->second : nullptr;
+}
+
+static
+m64p_error _setDefault(m64p_handle _handle, const char * _name, m64p_type _type, int _intValue, float _floatValue, const char * _stringValue)
+{
+	if (_handle == nullptr || _name == nullptr)
+		return M64ERR_INPUT_ASSERT;
+	Section & section = *static_cast<Section*>(_handle);
+	if (section.find(_name) != section.end())
+		return M64ERR_SUCCESS;
+	Parameter & param = section[_name];
+	param.type = _type;
+	param.intValue = _intValue;
+	param.floatValue = _floatValue;
+	param.stringValue = _stringValue != nullptr ? _stringValue : "";
+	return M64ERR_SUCCESS;
+}
+
+// Called by gbitrace_replay before PluginStartup.
+// _dataPath ends with a path separator.
+extern "C" EXPORT void CALL GBITraceCoreSetup(const char * _dataPath, int _gbiTraceMode)
+{
+	dataPath = _dataPath;
+	sections.clear();
+	Parameter & param = sections["Video-GLideN64"]["DebugGBITrace"];
+	param.type = M64TYPE_INT;
+	param.intValue = _gbiTraceMode;
+	param.floatValue = float(_gbiTraceMode);
+}
+
+EXPORT m64p_error CALL PluginGetVersion(m64p_plugin_type * _PluginType, int * _PluginVersion, int * _APIVersion, const char ** _PluginNamePtr, int * _Capabilities)
+{
+	if (_PluginType != nullptr)
+		*_PluginType = M64PLUGIN_CORE;
+	// 2.5.1 and later pass the GFX_INFO version
+	if (_PluginVersion != nullptr)
+		*_PluginVersion = 0x020600;
+	if (_APIVersion != nullptr)
+		*_APIVersion = 0x020001;
+	if (_PluginNamePtr != nullptr)
+		*_PluginNamePtr = "GBI trace replay";
+	if (_Capabilities != nullptr)
+		*_Capabilities = 0;
+	return M64ERR_SUCCESS;
+}
+
+/* Configuration */
+
+EXPORT m64p_error CALL ConfigOpenSection(const char * _SectionName, m64p_handle * _ConfigSectionHandle)
+{
+	if (_SectionName == nullptr || _ConfigSectionHandle == nullptr)
+		return M64ERR_INPUT_ASSERT;
+	*_ConfigSectionHandle = &sections[_SectionName];
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL ConfigDeleteSection(const char * _SectionName)
+{
+	// Keep the section, so that handles stay valid
+	auto iter = sections.find(_SectionName);
+	if (iter == sections.end())
+		return M64ERR_INPUT_NOT_FOUND;
+	iter->second.clear();
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL ConfigSaveFile(void)
+{
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL ConfigSaveSection(const char * _SectionName)
+{
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultInt(m64p_handle _ConfigSectionHandle, const char * _ParamName, int _ParamValue, const char * _ParamHelp)
+{
+	return _setDefault(_ConfigSectionHandle, _ParamName, M64TYPE_INT, _ParamValue, float(_ParamValue), nullptr);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultFloat(m64p_handle _ConfigSectionHandle, const char * _ParamName, float _ParamValue, const char * _ParamHelp)
+{
+	return _setDefault(_ConfigSectionHandle, _ParamName, M64TYPE_FLOAT, int(_ParamValue), _ParamValue, nullptr);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultBool(m64p_handle _ConfigSectionHandle, const char * _ParamName, int _ParamValue, const char * _ParamHelp)
+{
+	return _setDefault(_ConfigSectionHandle, _ParamName, M64TYPE_BOOL, _ParamValue != 0 ? 1 : 0, _ParamValue != 0 ? 1.0f : 0.0f, nullptr);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultString(m64p_handle _ConfigSectionHandle, const char * _ParamName, const char * _ParamValue, const char * _ParamHelp)
+{
+	return _setDefault(_ConfigSectionHandle, _ParamName, M64TYPE_STRING, 0, 0.0f, _ParamValue);
+}
+
+EXPORT int CALL ConfigGetParamInt(m64p_handle _ConfigSectionHandle, const char * _ParamName)
+{
+	const Parameter * param = _findParameter(_ConfigSectionHandle, _ParamName);
+	return param != nullptr ? param->intValue : 0;
+}
+
+EXPORT float CALL ConfigGetParamFloat(m64p_handle _ConfigSectionHandle, const char * _ParamName)
+{
+	const Parameter * param = _findParameter(_ConfigSectionHandle, _ParamName);
+	return param != nullptr ? param->floatValue : 0.0f;
+}
+
+EXPORT int CALL ConfigGetParamBool(m64p_handle _ConfigSectionHandle, const char * _ParamName)
+{
+	const Parameter * param = _findParameter(_ConfigSectionHandle, _ParamName);
+	return param != nullptr && param->intValue != 0 ? 1 : 0;
+}
+
+EXPORT const char * CALL ConfigGetParamString(m64p_handle _ConfigSectionHandle, const char * _ParamName)
+{
+	const Parameter * param = _findParameter(_ConfigSectionHandle, _ParamName);
+	return param != nullptr ? param->stringValue.c_str() : "";
+}
+
+// Shared data files, such as font.ttf, are looked up next to the trace
+EXPORT const char * CALL ConfigGetSharedDataFilepath(const char * _filename)
+{
+	if (_filename == nullptr)
+		return nullptr;
+	sharedDataFile = dataPath + _filename;
+	struct stat fileInfo;
+	return stat(sharedDataFile.c_str(), &fileInfo) == 0 ? sharedDataFile.c_str() : nullptr;
+}
+
+EXPORT const char * CALL ConfigGetUserConfigPath(void)
+{
+	return dataPath.c_str();
+}
+
+EXPORT const char * CALL ConfigGetUserDataPath(void)
+{
+	return dataPath.c_str();
+}
+
+EXPORT const char * CALL ConfigGetUserCachePath(void)
+{
+	return dataPath.c_str();
+}
+
+/* Video extension */
+
+EXPORT m64p_error CALL VidExt_Init(void)
+{
+	display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr) == EGL_TRUE)
+		return M64ERR_SUCCESS;
+
+	// No window system, as on a build server
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	display = getPlatformDisplay != nullptr ?
+		getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+	if (display == EGL_NO_DISPLAY || eglInitialize(display, nullptr, nullptr) != EGL_TRUE) {
+		display = EGL_NO_DISPLAY;
+		return M64ERR_SYSTEM_FAIL;
+	}
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_Quit(void)
+{
+	if (display == EGL_NO_DISPLAY)
+		return M64ERR_NOT_INIT;
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (context != EGL_NO_CONTEXT)
+		eglDestroyContext(display, context);
+	if (surface != EGL_NO_SURFACE)
+		eglDestroySurface(display, surface);
+	eglTerminate(display);
+	context = EGL_NO_CONTEXT;
+	surface = EGL_NO_SURFACE;
+	display = EGL_NO_DISPLAY;
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ListFullscreenModes(m64p_2d_size * _SizeArray, int * _NumSizes)
+{
+	return M64ERR_UNSUPPORTED;
+}
+
+// The window is a pbuffer of the requested size
+EXPORT m64p_error CALL VidExt_SetVideoMode(int _Width, int _Height, int _BitsPerPixel, m64p_video_mode _ScreenMode, m64p_video_flags _Flags)
+{
+	if (display == EGL_NO_DISPLAY)
+		return M64ERR_NOT_INIT;
+
+	const EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_DEPTH_SIZE, glAttributes.count(M64P_GL_DEPTH_SIZE) != 0 ? glAttributes[M64P_GL_DEPTH_SIZE] : 16,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint numConfigs = 0;
+	if (eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) != EGL_TRUE || numConfigs == 0)
+		return M64ERR_SYSTEM_FAIL;
+
+	const EGLint surfaceAttribs[] = { EGL_WIDTH, _Width, EGL_HEIGHT, _Height, EGL_NONE };
+	surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+	if (surface == EGL_NO_SURFACE)
+		return M64ERR_SYSTEM_FAIL;
+
+	const bool core = glAttributes.count(M64P_GL_CONTEXT_PROFILE_MASK) != 0 &&
+		glAttributes[M64P_GL_CONTEXT_PROFILE_MASK] == M64P_GL_CONTEXT_PROFILE_CORE;
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, glAttributes.count(M64P_GL_CONTEXT_MAJOR_VERSION) != 0 ? glAttributes[M64P_GL_CONTEXT_MAJOR_VERSION] : 2,
+		EGL_CONTEXT_MINOR_VERSION, glAttributes.count(M64P_GL_CONTEXT_MINOR_VERSION) != 0 ? glAttributes[M64P_GL_CONTEXT_MINOR_VERSION] : 0,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, core ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+		EGL_NONE
+	};
+	eglBindAPI(EGL_OPENGL_API);
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+	if (context == EGL_NO_CONTEXT || eglMakeCurrent(display, surface, surface, context) != EGL_TRUE)
+		return M64ERR_SYSTEM_FAIL;
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ResizeWindow(int _Width, int _Height)
+{
+	return M64ERR_UNSUPPORTED;
+}
+
+EXPORT m64p_error CALL VidExt_SetCaption(const char * _Title)
+{
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ToggleFullScreen(void)
+{
+	return M64ERR_UNSUPPORTED;
+}
+
+EXPORT void * CALL VidExt_GL_GetProcAddress(const char * _Proc)
+{
+	return (void*)eglGetProcAddress(_Proc);
+}
+
+EXPORT m64p_error CALL VidExt_GL_SetAttribute(m64p_GLattr _Attr, int _Value)
+{
+	glAttributes[_Attr] = _Value;
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_GL_GetAttribute(m64p_GLattr _Attr, int * _pValue)
+{
+	auto iter = glAttributes.find(_Attr);
+	if (iter == glAttributes.end() || _pValue == nullptr)
+		return M64ERR_INPUT_INVALID;
+	*_pValue = iter->second;
+	return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_GL_SwapBuffers(void)
+{
+	return eglSwapBuffers(display, surface) == EGL_TRUE ? M64ERR_SUCCESS : M64ERR_SYSTEM_FAIL;
+}
+
+EXPORT uint32_t CALL VidExt_GL_GetDefaultFramebuffer(void)
+{
+	return 0;
+}
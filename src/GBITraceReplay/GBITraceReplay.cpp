@@ -0,0 +1,206 @@
+// Replays a GBI trace through the mupen64plus build of the plugin, without an emulator,
+// so that two builds can be compared on the same recorded input.
+// The trace must be named gliden64.gbitrace. The plugin's log is written next to it,
+// and the trace lines the replay adds to it are printed.
+// VI registers are not part of the trace, so frames are run but not shown.
+// Usage: gbitrace_replay <plugin library> <trace directory>
+// Returns 0 if all frames match the recording, 1 if some differ and 2 on errors.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "m64p_common.h"
+#include "m64p_plugin.h"
+
+// See GBITrace.cpp
+static const unsigned int traceMagic = 0x52544C47;    // "GLTR"
+static const unsigned int traceVersion = 1;
+static const unsigned int traceEndTag = 0x444E4554;   // "TEND"
+static const int gbiTraceReplay = 2;                  // Config::gtReplay
+
+typedef void (*ptr_GBITraceCoreSetup)(const char *, int);
+
+static
+bool readTraceInfo(const std::string & _path, unsigned int & _rdramSize, unsigned int & _numFrames)
+{
+	FILE * file = fopen(_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	unsigned int header[3] = {};
+	unsigned int endTag = 0;
+	unsigned long long indexOffset = 0;
+	const bool res = fread(header, sizeof(header), 1, file) == 1 &&
+		header[0] == traceMagic && header[1] == traceVersion &&
+		fseek(file, -long(sizeof(_numFrames) + sizeof(indexOffset) + sizeof(endTag)), SEEK_END) == 0 &&
+		fread(&_numFrames, sizeof(_numFrames), 1, file) == 1 &&
+		fread(&indexOffset, sizeof(indexOffset), 1, file) == 1 &&
+		fread(&endTag, sizeof(endTag), 1, file) == 1 && endTag == traceEndTag;
+	fclose(file);
+	_rdramSize = header[2];
+	return res;
+}
+
+static
+long fileSize(const std::string & _path)
+{
+	FILE * file = fopen(_path.c_str(), "rb");
+	if (file == nullptr)
+		return 0;
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+// The core module is built next to this executable
+static
+std::string corePath()
+{
+	char path[512];
+	const ssize_t res = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	if (res == -1)
+		return "gbitrace_core.so";
+	path[res] = 0;
+	std::string exePath(path);
+	return exePath.substr(0, exePath.find_last_of('/') + 1) + "gbitrace_core.so";
+}
+
+static
+void checkInterrupts()
+{
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc < 3) {
+		printf("Usage: %s <plugin library> <trace directory>\n", argv[0]);
+		return 2;
+	}
+
+	std::string dataPath(argv[2]);
+	if (dataPath.empty() || dataPath.back() != '/')
+		dataPath += '/';
+	const std::string tracePath = dataPath + "gliden64.gbitrace";
+	const std::string logPath = dataPath + "gliden64.log";
+
+	unsigned int rdramSize = 0, numFrames = 0;
+	if (!readTraceInfo(tracePath, rdramSize, numFrames)) {
+		printf("%s is not a complete GBI trace\n", tracePath.c_str());
+		return 2;
+	}
+
+	void * core = dlopen(corePath().c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (core == nullptr) {
+		printf("%s\n", dlerror());
+		return 2;
+	}
+	void * plugin = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+	if (plugin == nullptr) {
+		printf("%s\n", dlerror());
+		return 2;
+	}
+
+	ptr_GBITraceCoreSetup coreSetup = (ptr_GBITraceCoreSetup)dlsym(core, "GBITraceCoreSetup");
+	ptr_PluginStartup pluginStartup = (ptr_PluginStartup)dlsym(plugin, "PluginStartup");
+	ptr_PluginShutdown pluginShutdown = (ptr_PluginShutdown)dlsym(plugin, "PluginShutdown");
+	ptr_InitiateGFX initiateGFX = (ptr_InitiateGFX)dlsym(plugin, "InitiateGFX");
+	ptr_RomOpen romOpen = (ptr_RomOpen)dlsym(plugin, "RomOpen");
+	ptr_RomClosed romClosed = (ptr_RomClosed)dlsym(plugin, "RomClosed");
+	ptr_ProcessDList processDList = (ptr_ProcessDList)dlsym(plugin, "ProcessDList");
+	if (coreSetup == nullptr || pluginStartup == nullptr || pluginShutdown == nullptr || initiateGFX == nullptr ||
+		romOpen == nullptr || romClosed == nullptr || processDList == nullptr) {
+		printf("%s is not a mupen64plus video plugin\n", argv[1]);
+		return 2;
+	}
+
+	coreSetup(dataPath.c_str(), gbiTraceReplay);
+	const long logStart = fileSize(logPath);
+	if (pluginStartup(core, nullptr, nullptr) != M64ERR_SUCCESS) {
+		printf("Plugin startup failed\n");
+		return 2;
+	}
+
+	// The trace replaces RDRAM and DMEM for each frame
+	std::vector<unsigned char> rdram(rdramSize);
+	std::vector<unsigned char> dmem(0x1000);
+	std::vector<unsigned char> imem(0x1000);
+	std::vector<unsigned char> header(0x40);
+	std::vector<unsigned int> regs(32);
+	unsigned int * reg = regs.data();
+
+	GFX_INFO gfxInfo;
+	memset(&gfxInfo, 0, sizeof(gfxInfo));
+	gfxInfo.HEADER = header.data();
+	gfxInfo.RDRAM = rdram.data();
+	gfxInfo.DMEM = dmem.data();
+	gfxInfo.IMEM = imem.data();
+	gfxInfo.MI_INTR_REG = reg++;
+	gfxInfo.DPC_START_REG = reg++;
+	gfxInfo.DPC_END_REG = reg++;
+	gfxInfo.DPC_CURRENT_REG = reg++;
+	gfxInfo.DPC_STATUS_REG = reg++;
+	gfxInfo.DPC_CLOCK_REG = reg++;
+	gfxInfo.DPC_BUFBUSY_REG = reg++;
+	gfxInfo.DPC_PIPEBUSY_REG = reg++;
+	gfxInfo.DPC_TMEM_REG = reg++;
+	gfxInfo.VI_STATUS_REG = reg++;
+	gfxInfo.VI_ORIGIN_REG = reg++;
+	gfxInfo.VI_WIDTH_REG = reg++;
+	gfxInfo.VI_INTR_REG = reg++;
+	gfxInfo.VI_V_CURRENT_LINE_REG = reg++;
+	gfxInfo.VI_TIMING_REG = reg++;
+	gfxInfo.VI_V_SYNC_REG = reg++;
+	gfxInfo.VI_H_SYNC_REG = reg++;
+	gfxInfo.VI_LEAP_REG = reg++;
+	gfxInfo.VI_H_START_REG = reg++;
+	gfxInfo.VI_V_START_REG = reg++;
+	gfxInfo.VI_V_BURST_REG = reg++;
+	gfxInfo.VI_X_SCALE_REG = reg++;
+	gfxInfo.VI_Y_SCALE_REG = reg++;
+	gfxInfo.SP_STATUS_REG = reg++;
+	gfxInfo.CheckInterrupts = checkInterrupts;
+	gfxInfo.version = 2;
+	gfxInfo.RDRAM_SIZE = &rdramSize;
+
+	initiateGFX(gfxInfo);
+	if (romOpen() == 0) {
+		printf("Plugin failed to open the display\n");
+		pluginShutdown();
+		return 2;
+	}
+	for (unsigned int frame = 0; frame < numFrames; ++frame)
+		processDList();
+	romClosed();
+	pluginShutdown();
+
+	// The plugin reports the replay in its log
+	unsigned int replayed = 0, differ = 0;
+	bool summary = false;
+	FILE * log = fopen(logPath.c_str(), "r");
+	if (log != nullptr) {
+		fseek(log, fileSize(logPath) >= logStart ? logStart : 0, SEEK_SET);
+		char line[1024];
+		while (fgets(line, sizeof(line), log) != nullptr) {
+			const char * trace = strstr(line, "GBI trace:");
+			if (trace == nullptr)
+				continue;
+			fputs(trace, stdout);
+			if (sscanf(trace, "GBI trace: replayed %u frames, %u differ", &replayed, &differ) == 2)
+				summary = true;
+		}
+		fclose(log);
+	}
+
+	dlclose(plugin);
+	dlclose(core);
+
+	if (!summary) {
+		printf("The plugin did not replay the trace\n");
+		return 2;
+	}
+	return differ == 0 ? 0 : 1;
+}
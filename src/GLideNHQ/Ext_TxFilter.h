@@ -86,12 +86,22 @@ typedef unsigned char boolean;
 
 #define DEPOSTERIZE         0x00001000
 
-#define HIRESTEXTURES_MASK  0x000f0000
+/* GPU compressed hires textures supported by hardware.
+ * Such textures are kept and uploaded as is. */
+#define GPUCOMPRESSED_MASK  0x0004e000
+#define S3TC_HIRESTEX       0x00002000 /* BC1, BC2, BC3 */
+#define BPTC_HIRESTEX       0x00004000 /* BC7 */
+#define ETC2_HIRESTEX       0x00008000
+#define ASTC_HIRESTEX       0x00040000
+
+#define HIRESTEXTURES_MASK  0x00030000
 #define NO_HIRESTEXTURES    0x00000000
 #define GHQ_HIRESTEXTURES   0x00010000
 #define RICE_HIRESTEXTURES  0x00020000
 #define JABO_HIRESTEXTURES  0x00030000
 
+#define LZ4_TXCACHE         0x00080000 /* LZ4 instead of zlib for GZ_TEXCACHE and GZ_HIRESTEXCACHE */
+
 //#define COMPRESS_TEX        0x00100000 // Not used anymore
 //#define COMPRESS_HIRESTEX   0x00200000 // Not used anymore
 #define GZ_TEXCACHE         0x00400000
@@ -120,6 +130,22 @@ struct GHQTexInfo {
   {}
 };
 
+/* Hit and miss counters of a texture cache, per tier.
+ * Memory misses are looked up on disk. */
+struct GHQCacheStats {
+  unsigned int ramHits;
+  unsigned int ramMisses;
+  unsigned int diskHits;
+  unsigned int diskMisses;
+  unsigned int ramSize;  /* bytes */
+  unsigned int diskSize; /* bytes */
+
+  GHQCacheStats() :
+	  ramHits(0), ramMisses(0), diskHits(0), diskMisses(0),
+	  ramSize(0), diskSize(0)
+  {}
+};
+
 /* Callback to display hires texture info.
  * Gonetz <gonetz(at)ngs.ru>
  *
@@ -220,6 +246,7 @@ extern "C"{
 
 TAPI boolean TAPIENTRY
 txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+	int hirescachesize, int diskcachesize, int dumpcompression,
 	const wchar_t *txCachePath, const wchar_t *txDumpPath, const wchar_t * texPackPath,
 	const wchar_t* ident, dispInfoFuncExt callback);
 
@@ -245,6 +272,9 @@ txfilter_reloadhirestex();
 TAPI void TAPIENTRY
 txfilter_dumpcache(void);
 
+TAPI void TAPIENTRY
+txfilter_cachestats(GHQCacheStats *texcache, GHQCacheStats *hirescache);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,15 +27,35 @@
 
 #include "TxCache.h"
 #include "TxDbg.h"
+#include "TxUtil.h"
+#include "TxCodec.h"
 #include <osal_files.h>
 #include <zlib.h>
 #include <memory.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+
+#ifdef OS_WINDOWS
+#define FSEEK64 _fseeki64
+#define FTELL64 _ftelli64
+#else
+#define FSEEK64 fseeko
+#define FTELL64 ftello
+#endif
+
+/* bytes in front of the texture data of a record */
+#define TXCACHE_RECORD_HEADER 29
 
 TxCache::~TxCache()
 {
+	if (_compaction.joinable())
+		_compaction.join();
+
 	/* free memory, clean up, etc */
 	clear();
+
+	delete _diskCache;
 }
 
 TxCache::TxCache(int options, int cachesize, const wchar_t *cachePath, const wchar_t *ident,
@@ -45,6 +65,9 @@ TxCache::TxCache(int options, int cachesize, const wchar_t *cachePath, const wch
 	_cacheSize = cachesize;
 	_callback = callback;
 	_totalSize = 0;
+	_diskCache = nullptr;
+	_logConfig = 0;
+	_logRecords = 0;
 
 	/* save path name */
 	if (cachePath)
@@ -54,7 +77,7 @@ TxCache::TxCache(int options, int cachesize, const wchar_t *cachePath, const wch
 	if (ident)
 		_ident.assign(ident);
 
-	/* zlib memory buffers to (de)compress hires textures */
+	/* memory buffers to (de)compress hires textures */
 	if (_options & (GZ_TEXCACHE|GZ_HIRESTEXCACHE)) {
 		_gzdest0   = TxMemBuf::getInstance()->get(0);
 		_gzdest1   = TxMemBuf::getInstance()->get(1);
@@ -68,12 +91,29 @@ TxCache::TxCache(int options, int cachesize, const wchar_t *cachePath, const wch
 			_gzdestLen = 0;
 		}
 	}
+
+	_codec = TxCodec::fromOptions(_options);
 }
 
 boolean
 TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 {
-	/* NOTE: dataSize must be provided if info->data is zlib compressed. */
+	if (_diskCache && _diskCache->is_cached(checksum))
+		return 0;
+
+	if (!_add(checksum, info, dataSize))
+		return 0;
+
+	/* goes into the .htc file with the next save */
+	_unsaved.insert(checksum);
+
+	return 1;
+}
+
+boolean
+TxCache::_add(uint64 checksum, GHQTexInfo *info, int dataSize)
+{
+	/* NOTE: dataSize must be provided if info->data is compressed. */
 
 	if (!checksum || !info->data || _cache.find(checksum) != _cache.end())
 		return 0;
@@ -87,17 +127,16 @@ TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 		if (!dataSize)
 			return 0;
 
-		if (_options & (GZ_TEXCACHE|GZ_HIRESTEXCACHE)) {
-			/* zlib compress it. compression level:1 (best speed) */
-			uLongf destLen = _gzdestLen;
+		if (_codec) {
+			uint32 destLen = _gzdestLen;
 			dest = (dest == _gzdest0) ? _gzdest1 : _gzdest0;
-			if (compress2(dest, &destLen, info->data, dataSize, 1) != Z_OK) {
+			if (!_codec->compress(info->data, dataSize, dest, &destLen)) {
 				dest = info->data;
-				DBG_INFO(80, wst("Error: zlib compression failed!\n"));
+				DBG_INFO(80, wst("Error: texture compression failed!\n"));
 			} else {
-				DBG_INFO(80, wst("zlib compressed: %.02fkb->%.02fkb\n"), (float)dataSize/1000, (float)destLen/1000);
+				DBG_INFO(80, wst("compressed: %.02fkb->%.02fkb\n"), (float)dataSize/1000, (float)destLen/1000);
 				dataSize = destLen;
-				format |= GL_TEXFMT_GZ;
+				format |= _codec->format();
 			}
 		}
 	}
@@ -112,9 +151,12 @@ TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 				/* find it in _cache */
 				auto itMap = _cache.find(*itList);
 				if (itMap != _cache.end()) {
-					/* yep we have it. remove it. */
+					/* yep we have it. move it to disk or remove it. */
 					_totalSize -= (*itMap).second->size;
-					free((*itMap).second->info.data);
+					if (_diskCache)
+						_diskCache->push((*itMap).first, &(*itMap).second->info, (*itMap).second->size);
+					else
+						free((*itMap).second->info.data);
 					delete (*itMap).second;
 					_cache.erase(itMap);
 				}
@@ -180,10 +222,26 @@ TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 boolean
 TxCache::get(uint64 checksum, GHQTexInfo *info)
 {
-	if (!checksum || _cache.empty()) return 0;
+	if (!checksum) return 0;
 
 	/* find a match in cache */
 	auto itMap = _cache.find(checksum);
+	if (itMap == _cache.end()) {
+		++_stats.ramMisses;
+		if (!_diskCache)
+			return 0;
+
+		/* bring it back from disk */
+		if (!_promote(checksum)) {
+			++_stats.diskMisses;
+			return 0;
+		}
+		++_stats.diskHits;
+		itMap = _cache.find(checksum);
+	} else {
+		++_stats.ramHits;
+	}
+
 	if (itMap != _cache.end()) {
 		/* yep, we've got it. */
 		memcpy(info, &(((*itMap).second)->info), sizeof(GHQTexInfo));
@@ -195,17 +253,18 @@ TxCache::get(uint64 checksum, GHQTexInfo *info)
 			((*itMap).second)->it = --(_cachelist.end());
 		}
 
-		/* zlib decompress it */
-		if (info->format & GL_TEXFMT_GZ) {
-			uLongf destLen = _gzdestLen;
+		/* decompress it with the codec which compressed it */
+		const TxCodec *codec = TxCodec::fromFormat(info->format);
+		if (codec) {
+			uint32 destLen = _gzdestLen;
 			uint8 *dest = (_gzdest0 == info->data) ? _gzdest1 : _gzdest0;
-			if (uncompress(dest, &destLen, info->data, ((*itMap).second)->size) != Z_OK) {
-				DBG_INFO(80, wst("Error: zlib decompression failed!\n"));
+			if (dest == nullptr || !codec->decompress(info->data, ((*itMap).second)->size, dest, &destLen)) {
+				DBG_INFO(80, wst("Error: texture decompression failed!\n"));
 				return 0;
 			}
 			info->data = dest;
-			info->format &= ~GL_TEXFMT_GZ;
-			DBG_INFO(80, wst("zlib decompressed: %.02fkb->%.02fkb\n"), (float)(((*itMap).second)->size)/1000, (float)destLen/1000);
+			info->format &= ~GL_TEXFMT_COMPRESSION_MASK;
+			DBG_INFO(80, wst("decompressed: %.02fkb->%.02fkb\n"), (float)(((*itMap).second)->size)/1000, (float)destLen/1000);
 		}
 
 		return 1;
@@ -215,87 +274,264 @@ TxCache::get(uint64 checksum, GHQTexInfo *info)
 }
 
 boolean
-TxCache::save(const wchar_t *path, const wchar_t *filename, int config)
+TxCache::_promote(uint64 checksum)
 {
-	if (_cache.empty())
+	GHQTexInfo info;
+	int dataSize;
+	if (!_diskCache->read(checksum, &info, &dataSize))
 		return 0;
 
-	/* dump cache to disk */
+	/* the data is kept as it was in memory, compressed or not.
+	 * the disk copy stays until the texture is back in memory. */
+	const boolean res = _add(checksum, &info, dataSize);
+	free(info.data);
+
+	if (res)
+		_diskCache->del(checksum);
+
+	return res;
+}
+
+static
+FILE *openFile(const tx_wstring &filename, const char *mode)
+{
+#ifdef OS_WINDOWS
+	wchar_t wmode[4];
+	mbstowcs(wmode, mode, 4);
+	return _wfopen(filename.c_str(), wmode);
+#else
 	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filename.c_str(), MAX_PATH);
+	return fopen(cbuf, mode);
+#endif
+}
 
-	osal_mkdirp(path);
+static
+void writeTexture(FILE *fp, uint64 checksum, const GHQTexInfo &info, uint32 destLen)
+{
+	uint8 header[TXCACHE_RECORD_HEADER];
+	uint8 *p = header;
+
+	/* texture checksum */
+	memcpy(p, &checksum, 8); p += 8;
+
+	/* other texture info */
+	memcpy(p, &info.width, 4); p += 4;
+	memcpy(p, &info.height, 4); p += 4;
+	memcpy(p, &info.format, 4); p += 4;
+	memcpy(p, &info.texture_format, 2); p += 2;
+	memcpy(p, &info.pixel_type, 2); p += 2;
+	memcpy(p, &info.is_hires_tex, 1); p += 1;
+	memcpy(p, &destLen, 4);
+
+	fwrite(header, 1, TXCACHE_RECORD_HEADER, fp);
+	fwrite(info.data, 1, destLen, fp);
+}
+
+/* Rewrites a version 2 .htc file with the last record of every texture.
+ * Runs on its own thread and only touches the file. */
+static
+void compactFile(tx_wstring file)
+{
+	FILE *fp = openFile(file, "rb");
+	if (fp == nullptr)
+		return;
+
+	int header[3];
+	if (fread(header, 4, 3, fp) != 3 || header[0] != TXCACHE_TAG || header[1] != TXCACHE_VERSION) {
+		fclose(fp);
+		return;
+	}
+
+	/* find the last record of every texture */
+	std::map<uint64, int64> latest;
+	uint8 record[TXCACHE_RECORD_HEADER];
+	int64 offset = FTELL64(fp);
+	while (fread(record, 1, TXCACHE_RECORD_HEADER, fp) == TXCACHE_RECORD_HEADER) {
+		uint64 checksum;
+		uint32 dataSize;
+		memcpy(&checksum, record, 8);
+		memcpy(&dataSize, record + TXCACHE_RECORD_HEADER - 4, 4);
+		latest[checksum] = offset;
+		if (FSEEK64(fp, dataSize, SEEK_CUR) != 0)
+			break;
+		offset = FTELL64(fp);
+	}
+
+	/* keep the order of the file */
+	std::vector<int64> offsets;
+	offsets.reserve(latest.size());
+	for (const auto & item : latest)
+		offsets.push_back(item.second);
+	std::sort(offsets.begin(), offsets.end());
+
+	tx_wstring tmpFile(file);
+	tmpFile.append(wst(".tmp"));
+	FILE *out = openFile(tmpFile, "wb");
+	if (out == nullptr) {
+		fclose(fp);
+		return;
+	}
+
+	boolean res = fwrite(header, 4, 3, out) == 3;
+	std::vector<uint8> data;
+	for (int64 recordOffset : offsets) {
+		if (!res)
+			break;
+		uint32 dataSize;
+		res = FSEEK64(fp, recordOffset, SEEK_SET) == 0 &&
+			fread(record, 1, TXCACHE_RECORD_HEADER, fp) == TXCACHE_RECORD_HEADER;
+		if (!res)
+			break;
+		memcpy(&dataSize, record + TXCACHE_RECORD_HEADER - 4, 4);
+		data.resize(dataSize);
+		res = fread(data.data(), 1, dataSize, fp) == dataSize &&
+			fwrite(record, 1, TXCACHE_RECORD_HEADER, out) == TXCACHE_RECORD_HEADER &&
+			fwrite(data.data(), 1, dataSize, out) == dataSize;
+	}
+	fclose(fp);
+	res = fclose(out) == 0 && res;
 
-	/* Ugly hack to enable fopen/gzopen in Win9x */
 #ifdef OS_WINDOWS
-	wchar_t curpath[MAX_PATH];
-	GETCWD(MAX_PATH, curpath);
-	CHDIR(path);
+	if (res)
+		res = MoveFileExW(tmpFile.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+	if (!res)
+		_wremove(tmpFile.c_str());
 #else
-	char curpath[MAX_PATH];
-	GETCWD(MAX_PATH, curpath);
-	wcstombs(cbuf, path, MAX_PATH);
-	CHDIR(cbuf);
+	char cbuf[MAX_PATH];
+	char tmpbuf[MAX_PATH];
+	wcstombs(cbuf, file.c_str(), MAX_PATH);
+	wcstombs(tmpbuf, tmpFile.c_str(), MAX_PATH);
+	if (res)
+		res = rename(tmpbuf, cbuf) == 0;
+	if (!res)
+		remove(tmpbuf);
 #endif
 
-	wcstombs(cbuf, filename, MAX_PATH);
+	DBG_INFO(80, wst("compacted %ls: %d textures %ls\n"), file.c_str(), offsets.size(), res ? wst("ok") : wst("failed"));
+}
 
-	gzFile gzfp = gzopen(cbuf, "wb1");
-	DBG_INFO(80, wst("gzfp:%x file:%ls\n"), gzfp, filename);
-	if (gzfp) {
-		/* write header to determine config match */
-		gzwrite(gzfp, &config, 4);
+boolean
+TxCache::_saveTexture(FILE *fp, uint64 checksum)
+{
+	auto itMap = _cache.find(checksum);
+	if (itMap != _cache.end()) {
+		writeTexture(fp, checksum, (*itMap).second->info, (*itMap).second->size);
+		return 1;
+	}
 
-		auto itMap = _cache.begin();
-		int total = 0;
-		while (itMap != _cache.end()) {
-			uint8 *dest = (*itMap).second->info.data;
-			uint32 destLen = (*itMap).second->size;
-			uint32 format = (*itMap).second->info.format;
-
-			/* to keep things simple, we save the texture data in a zlib uncompressed state. */
-			/* sigh... for those who cannot wait the extra few seconds. changed to keep
-	 * texture data in a zlib compressed state. if the GZ_TEXCACHE or GZ_HIRESTEXCACHE
-	 * option is toggled, the cache will need to be rebuilt.
-	 */
-			/*if (format & GL_TEXFMT_GZ) {
-	  dest = _gzdest0;
-	  destLen = _gzdestLen;
-	  if (dest && destLen) {
-	  if (uncompress(dest, &destLen, (*itMap).second->info.data, (*itMap).second->size) != Z_OK) {
-	  dest = nullptr;
-	  destLen = 0;
-	  }
-	  format &= ~GL_TEXFMT_GZ;
-	  }
-	  }*/
-
-			if (dest && destLen) {
-				/* texture checksum */
-				gzwrite(gzfp, &((*itMap).first), 8);
-
-				/* other texture info */
-				gzwrite(gzfp, &((*itMap).second->info.width), 4);
-				gzwrite(gzfp, &((*itMap).second->info.height), 4);
-				gzwrite(gzfp, &format, 4);
-				gzwrite(gzfp, &((*itMap).second->info.texture_format), 2);
-				gzwrite(gzfp, &((*itMap).second->info.pixel_type), 2);
-				gzwrite(gzfp, &((*itMap).second->info.is_hires_tex), 1);
-
-				gzwrite(gzfp, &destLen, 4);
-				gzwrite(gzfp, dest, destLen);
-			}
+	/* or the ones moved to disk */
+	GHQTexInfo info;
+	int dataSize;
+	if (!_diskCache || !_diskCache->read(checksum, &info, &dataSize))
+		return 0;
 
-			itMap++;
+	writeTexture(fp, checksum, info, dataSize);
+	free(info.data);
 
-			if (_callback)
-				(*_callback)(wst("Total textures saved to HDD: %d\n"), ++total);
-		}
-		gzclose(gzfp);
+	return 1;
+}
+
+boolean
+TxCache::save(const wchar_t *path, const wchar_t *filename, int config)
+{
+	if (_cache.empty())
+		return 0;
+
+	/* the file is ours again once compacted */
+	if (_compaction.joinable())
+		_compaction.join();
+
+	osal_mkdirp(path);
+
+	tx_wstring file(path);
+	file.append(wst("/"));
+	file.append(filename);
+
+	/* only append the textures added since the file was loaded or written,
+	 * unless that is most of the cache anyway */
+	if (file == _logFile && config == _logConfig && _unsaved.size() < _logged.size() &&
+		osal_path_existsW(file.c_str()))
+		return _append();
+
+	return _rewrite(file, config);
+}
+
+boolean
+TxCache::_rewrite(const tx_wstring &file, int config)
+{
+	_logFile.clear();
+
+	FILE *fp = openFile(file, "wb");
+	DBG_INFO(80, wst("fp:%x file:%ls\n"), fp, file.c_str());
+	if (fp == nullptr)
+		return 0;
+
+	/* write format version and header to determine config match */
+	const int header[3] = { TXCACHE_TAG, TXCACHE_VERSION, config };
+	fwrite(header, 4, 3, fp);
+
+	/* the texture data is saved as cached, compressed or not */
+	std::vector<uint64> list;
+	checksums(list);
+	_logged.clear();
+	int total = 0;
+	for (uint64 checksum : list) {
+		if (!_saveTexture(fp, checksum))
+			continue;
+		_logged.insert(checksum);
+
+		if (_callback)
+			(*_callback)(wst("Total textures saved to HDD: %d\n"), ++total);
 	}
 
-	CHDIR(curpath);
+	const boolean res = !ferror(fp);
+	if (fclose(fp) != 0 || !res)
+		return 0;
+
+	_logFile = file;
+	_logConfig = config;
+	_logRecords = (uint32)_logged.size();
+	_unsaved.clear();
+
+	return 1;
+}
+
+boolean
+TxCache::_append()
+{
+	FILE *fp = openFile(_logFile, "ab");
+	DBG_INFO(80, wst("fp:%x file:%ls\n"), fp, _logFile.c_str());
+	if (fp == nullptr)
+		return 0;
+
+	int total = 0;
+	for (uint64 checksum : _unsaved) {
+		/* dropped from memory meanwhile */
+		if (!_saveTexture(fp, checksum))
+			continue;
+		_logged.insert(checksum);
+		++_logRecords;
+
+		if (_callback)
+			(*_callback)(wst("Total textures saved to HDD: %d\n"), ++total);
+	}
+
+	const boolean res = !ferror(fp);
+	if (fclose(fp) != 0 || !res) {
+		/* the end of the file may be garbage now */
+		_logFile.clear();
+		return 0;
+	}
+	_unsaved.clear();
+
+	/* drop replaced records once they are half of the file */
+	if (_logRecords >= 2 * _logged.size()) {
+		_compaction = std::thread(compactFile, _logFile);
+		_logRecords = (uint32)_logged.size();
+	}
 
-	return _cache.empty() ? 0 : 1;
+	return 1;
 }
 
 boolean
@@ -317,6 +553,10 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config, boolean
 
 	wcstombs(cbuf, filename, MAX_PATH);
 
+	_logFile.clear();
+	_logged.clear();
+
+	/* version 2 files are not gzipped, gzread reads them as they are */
 	gzFile gzfp = gzopen(cbuf, "rb");
 	DBG_INFO(80, wst("gzfp:%x file:%ls\n"), gzfp, filename);
 	if (gzfp) {
@@ -324,14 +564,23 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config, boolean
 		int dataSize;
 		uint64 checksum;
 		int tmpconfig;
+		int version = 0;
+		uint32 records = 0;
+		uint32 unsupported = 0;
 		/* read header to determine config match */
 		gzread(gzfp, &tmpconfig, 4);
+		if (tmpconfig == TXCACHE_TAG) {
+			gzread(gzfp, &version, 4);
+			gzread(gzfp, &tmpconfig, 4);
+		}
 
-		if (tmpconfig == config || force) {
+		/* textures of a newer format may use a codec we do not know */
+		if (version <= TXCACHE_VERSION && (tmpconfig == config || force)) {
 			do {
 				GHQTexInfo tmpInfo;
 
-				gzread(gzfp, &checksum, 8);
+				if (gzread(gzfp, &checksum, 8) != 8)
+					break;
 
 				gzread(gzfp, &tmpInfo.width, 4);
 				gzread(gzfp, &tmpInfo.height, 4);
@@ -340,14 +589,33 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config, boolean
 				gzread(gzfp, &tmpInfo.pixel_type, 2);
 				gzread(gzfp, &tmpInfo.is_hires_tex, 1);
 
-				gzread(gzfp, &dataSize, 4);
+				if (gzread(gzfp, &dataSize, 4) != 4)
+					break;
+
+				_logged.insert(checksum);
+				++records;
+
+				/* gpu compressed textures the driver can not take */
+				const ColorFormat fmt = ColorFormat(u32(tmpInfo.format & ~GL_TEXFMT_COMPRESSION_MASK));
+				if (TxUtil::isCompressedTx(fmt) && !TxUtil::isCompressedTxSupported(fmt, _options)) {
+					gzseek(gzfp, dataSize, SEEK_CUR);
+					++unsupported;
+					continue;
+				}
 
 				tmpInfo.data = (uint8*)malloc(dataSize);
 				if (tmpInfo.data) {
-					gzread(gzfp, tmpInfo.data, dataSize);
+					if (gzread(gzfp, tmpInfo.data, dataSize) != dataSize) {
+						free(tmpInfo.data);
+						break;
+					}
+
+					/* a later record replaces the texture */
+					if (is_cached(checksum))
+						del(checksum);
 
 					/* add to memory cache */
-					add(checksum, &tmpInfo, (tmpInfo.format & GL_TEXFMT_GZ) ? dataSize : 0);
+					_add(checksum, &tmpInfo, (tmpInfo.format & GL_TEXFMT_COMPRESSION_MASK) ? dataSize : 0);
 
 					free(tmpInfo.data);
 				} else {
@@ -359,8 +627,21 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config, boolean
 					(*_callback)(wst("[%d] total mem:%.02fmb - %ls\n"), _cache.size(), (float)_totalSize/1000000, filename);
 
 			} while (!gzeof(gzfp));
-			gzclose(gzfp);
+
+			if (unsupported != 0)
+				INFO(80, wst("Warning: %u compressed textures in %ls are not supported by hardware and were skipped\n"),
+					 unsupported, filename);
+
+			/* older files are rewritten on the next save */
+			if (version == TXCACHE_VERSION && tmpconfig == config) {
+				_logFile.assign(path);
+				_logFile.append(wst("/"));
+				_logFile.append(filename);
+				_logConfig = config;
+				_logRecords = records;
+			}
 		}
+		gzclose(gzfp);
 	}
 
 	CHDIR(curpath);
@@ -371,7 +652,10 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config, boolean
 boolean
 TxCache::del(uint64 checksum)
 {
-	if (!checksum || _cache.empty()) return 0;
+	if (!checksum) return 0;
+
+	if (_diskCache && _diskCache->del(checksum))
+		return 1;
 
 	auto itMap = _cache.find(checksum);
 	if (itMap != _cache.end()) {
@@ -399,6 +683,8 @@ TxCache::is_cached(uint64 checksum)
 	auto itMap = _cache.find(checksum);
 	if (itMap != _cache.end()) return 1;
 
+	if (_diskCache) return _diskCache->is_cached(checksum);
+
 	return 0;
 }
 
@@ -418,4 +704,52 @@ TxCache::clear()
 	if (!_cachelist.empty()) _cachelist.clear();
 
 	_totalSize = 0;
+
+	if (_diskCache)
+		_diskCache->clear();
+
+	/* the .htc file no longer matches, write all of it next time */
+	_logFile.clear();
+	_logged.clear();
+	_unsaved.clear();
+}
+
+int
+TxCache::size()
+{
+	int count = (int)_cache.size();
+	if (_diskCache)
+		count += _diskCache->size();
+	return count;
+}
+
+void
+TxCache::checksums(std::vector<uint64> &list)
+{
+	list.reserve(size());
+	for (const auto & item : _cache)
+		list.push_back(item.first);
+	if (_diskCache)
+		_diskCache->checksums(list);
+}
+
+void
+TxCache::initDiskCache(int diskcachesize, const tx_wstring &name)
+{
+	/* without a memory limit nothing is ever evicted */
+	if (diskcachesize <= 0 || _cacheSize <= 0 || _cachePath.empty() || _diskCache)
+		return;
+
+	tx_wstring path(_cachePath);
+	path.append(wst("/"));
+	path.append(name);
+	_diskCache = new TxDiskCache(path, diskcachesize);
+}
+
+void
+TxCache::getStats(GHQCacheStats *stats)
+{
+	*stats = _stats;
+	stats->ramSize = _totalSize;
+	stats->diskSize = _diskCache ? _diskCache->totalSize() : 0;
 }
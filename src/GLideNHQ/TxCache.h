@@ -26,8 +26,22 @@
 
 #include "TxInternal.h"
 #include "TxUtil.h"
+#include "TxDiskCache.h"
+#include "TxCodec.h"
+#include <stdio.h>
 #include <list>
 #include <map>
+#include <set>
+#include <vector>
+#include <thread>
+
+/* .htc files start with this tag and their format version. files without
+ * the tag are version 0 and start with the config. the tag has bits which
+ * no config uses. version 1 adds LZ4 compressed textures. version 2 files
+ * are not gzipped; textures are stored as they are cached and new ones are
+ * appended, so a texture can have several records. the last one counts. */
+#define TXCACHE_TAG     0x43544847 /* "GHTC" */
+#define TXCACHE_VERSION 2
 
 class TxCache
 {
@@ -36,6 +50,21 @@ private:
   uint8 *_gzdest0;
   uint8 *_gzdest1;
   uint32 _gzdestLen;
+  const TxCodec *_codec;
+  TxDiskCache *_diskCache;
+  GHQCacheStats _stats;
+  /* the .htc file last loaded or written, and what changed since */
+  tx_wstring _logFile;
+  int _logConfig;
+  uint32 _logRecords;        /* records in the file, replaced ones included */
+  std::set<uint64> _logged;  /* textures in the file */
+  std::set<uint64> _unsaved; /* textures added since */
+  std::thread _compaction;
+  boolean _add(uint64 checksum, GHQTexInfo *info, int dataSize);
+  boolean _promote(uint64 checksum);
+  boolean _saveTexture(FILE *fp, uint64 checksum);
+  boolean _rewrite(const tx_wstring &file, int config);
+  boolean _append();
 protected:
   int _options;
   tx_wstring _ident;
@@ -54,6 +83,10 @@ protected:
   boolean del(uint64 checksum); /* checksum hi:palette low:texture */
   boolean is_cached(uint64 checksum); /* checksum hi:palette low:texture */
   void clear();
+  int size();
+  void checksums(std::vector<uint64> &list);
+  /* textures evicted from memory go to disk instead of being dropped */
+  void initDiskCache(int diskcachesize, const tx_wstring &name);
 public:
   ~TxCache();
   TxCache(int options, int cachesize, const wchar_t *cachePath, const wchar_t *ident,
@@ -62,6 +95,7 @@ public:
               GHQTexInfo *info, int dataSize = 0);
   boolean get(uint64 checksum, /* checksum hi:palette low:texture */
               GHQTexInfo *info);
+  void getStats(GHQCacheStats *stats);
 };
 
 #endif /* __TXCACHE_H__ */
@@ -0,0 +1,255 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <string.h>
+#include <zlib.h>
+#include "TxCodec.h"
+
+/* zlib level 1. slow to decompress but small */
+class TxZlibCodec : public TxCodec
+{
+public:
+	uint32 format() const override { return GL_TEXFMT_GZ; }
+
+	boolean compress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const override
+	{
+		uLongf len = *destLen;
+		if (compress2(dest, &len, src, srcLen, 1) != Z_OK)
+			return 0;
+		*destLen = (uint32)len;
+		return 1;
+	}
+
+	boolean decompress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const override
+	{
+		uLongf len = *destLen;
+		if (uncompress(dest, &len, src, srcLen) != Z_OK)
+			return 0;
+		*destLen = (uint32)len;
+		return 1;
+	}
+};
+
+/* LZ4 block format. Compresses less than zlib, but decompresses
+ * several times faster, which is what counts on a cache hit. */
+class TxLZ4Codec : public TxCodec
+{
+private:
+	enum {
+		MINMATCH = 4,
+		LASTLITERALS = 5,   /* the last 5 bytes are always literals */
+		MFLIMIT = 12,       /* the last match starts 12 bytes before the end at the latest */
+		MAXDISTANCE = 65535,
+		HASHLOG = 12
+	};
+
+	static uint32 _read32(const uint8 *p)
+	{
+		uint32 v;
+		memcpy(&v, p, 4);
+		return v;
+	}
+
+	static uint32 _hash(uint32 sequence)
+	{
+		return (sequence * 2654435761U) >> (32 - HASHLOG);
+	}
+
+	/* token, literal length, literals, offset and match length of one sequence */
+	static boolean _writeSequence(uint8 *dest, uint32 destLen, uint32 &op,
+								  const uint8 *literals, uint32 litLen, uint32 offset, uint32 matchLen)
+	{
+		const uint32 maxLen = 1 + litLen / 255 + 1 + litLen + 2 + matchLen / 255 + 1;
+		if (op + maxLen > destLen)
+			return 0;
+
+		uint8 *token = dest + op++;
+		*token = (uint8)((litLen < 15 ? litLen : 15) << 4);
+		if (litLen >= 15) {
+			uint32 len = litLen - 15;
+			for (; len >= 255; len -= 255)
+				dest[op++] = 255;
+			dest[op++] = (uint8)len;
+		}
+		memcpy(dest + op, literals, litLen);
+		op += litLen;
+
+		/* the last sequence has literals only */
+		if (offset == 0)
+			return 1;
+
+		dest[op++] = (uint8)(offset & 0xff);
+		dest[op++] = (uint8)(offset >> 8);
+
+		const uint32 len = matchLen - MINMATCH;
+		*token |= (uint8)(len < 15 ? len : 15);
+		if (len >= 15) {
+			uint32 rest = len - 15;
+			for (; rest >= 255; rest -= 255)
+				dest[op++] = 255;
+			dest[op++] = (uint8)rest;
+		}
+		return 1;
+	}
+
+public:
+	uint32 format() const override { return GL_TEXFMT_LZ4; }
+
+	boolean compress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const override
+	{
+		uint32 table[1 << HASHLOG];
+		memset(table, 0xff, sizeof(table));
+
+		uint32 ip = 0;
+		uint32 anchor = 0;
+		uint32 op = 0;
+
+		if (srcLen > MFLIMIT) {
+			const uint32 matchLimit = srcLen - LASTLITERALS;
+			const uint32 inputLimit = srcLen - MFLIMIT;
+			while (ip < inputLimit) {
+				const uint32 sequence = _read32(src + ip);
+				const uint32 h = _hash(sequence);
+				const uint32 ref = table[h];
+				table[h] = ip;
+
+				if (ref == 0xffffffff || ip - ref > MAXDISTANCE || _read32(src + ref) != sequence) {
+					/* step faster over data which does not compress */
+					ip += 1 + ((ip - anchor) >> 6);
+					continue;
+				}
+
+				uint32 matchLen = MINMATCH;
+				while (ip + matchLen < matchLimit && src[ref + matchLen] == src[ip + matchLen])
+					++matchLen;
+
+				if (!_writeSequence(dest, *destLen, op, src + anchor, ip - anchor, ip - ref, matchLen))
+					return 0;
+
+				ip += matchLen;
+				anchor = ip;
+			}
+		}
+
+		if (!_writeSequence(dest, *destLen, op, src + anchor, srcLen - anchor, 0, 0))
+			return 0;
+
+		*destLen = op;
+		return 1;
+	}
+
+	boolean decompress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const override
+	{
+		const uint32 destCap = *destLen;
+		uint32 ip = 0;
+		uint32 op = 0;
+
+		while (ip < srcLen) {
+			const uint8 token = src[ip++];
+
+			uint32 litLen = token >> 4;
+			if (litLen == 15) {
+				uint8 b;
+				do {
+					if (ip >= srcLen)
+						return 0;
+					b = src[ip++];
+					litLen += b;
+				} while (b == 255);
+			}
+			if (litLen > srcLen - ip || litLen > destCap - op)
+				return 0;
+			if (litLen <= 16 && srcLen - ip >= 16 && destCap - op >= 16)
+				memcpy(dest + op, src + ip, 16); /* short runs: one fixed size copy */
+			else
+				memcpy(dest + op, src + ip, litLen);
+			ip += litLen;
+			op += litLen;
+
+			/* last sequence */
+			if (ip == srcLen)
+				break;
+
+			if (srcLen - ip < 2)
+				return 0;
+			const uint32 offset = src[ip] | (src[ip + 1] << 8);
+			ip += 2;
+			if (offset == 0 || offset > op)
+				return 0;
+
+			uint32 matchLen = token & 15;
+			if (matchLen == 15) {
+				uint8 b;
+				do {
+					if (ip >= srcLen)
+						return 0;
+					b = src[ip++];
+					matchLen += b;
+				} while (b == 255);
+			}
+			matchLen += MINMATCH;
+			if (matchLen > destCap - op)
+				return 0;
+
+			uint8 *match = dest + op - offset;
+			if (offset >= 8 && destCap - op >= matchLen + 8) {
+				/* 8 bytes at a time, may write a few bytes past the match */
+				for (uint32 i = 0; i < matchLen; i += 8)
+					memcpy(dest + op + i, match + i, 8);
+			} else if (offset >= matchLen) {
+				memcpy(dest + op, match, matchLen);
+			} else {
+				/* overlapping copy repeats the last offset bytes */
+				for (uint32 i = 0; i < matchLen; ++i)
+					dest[op + i] = match[i];
+			}
+			op += matchLen;
+		}
+
+		*destLen = op;
+		return 1;
+	}
+};
+
+static const TxZlibCodec zlibCodec;
+static const TxLZ4Codec lz4Codec;
+
+const TxCodec *
+TxCodec::fromOptions(int options)
+{
+	if (!(options & (GZ_TEXCACHE | GZ_HIRESTEXCACHE)))
+		return nullptr;
+	if (options & LZ4_TXCACHE)
+		return &lz4Codec;
+	return &zlibCodec;
+}
+
+const TxCodec *
+TxCodec::fromFormat(uint32 format)
+{
+	if (format & GL_TEXFMT_LZ4)
+		return &lz4Codec;
+	if (format & GL_TEXFMT_GZ)
+		return &zlibCodec;
+	return nullptr;
+}
@@ -0,0 +1,48 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXCODEC_H__
+#define __TXCODEC_H__
+
+#include "TxInternal.h"
+
+/* Compressors of cached texture data. The codec which compressed the
+ * data is marked in the texture format, so caches written with another
+ * codec still load. */
+class TxCodec
+{
+public:
+  virtual ~TxCodec() {}
+  /* GL_TEXFMT_* bit marking data compressed by this codec */
+  virtual uint32 format() const = 0;
+  /* destLen is the size of dest on input. fail if the data does not fit */
+  virtual boolean compress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const = 0;
+  virtual boolean decompress(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 *destLen) const = 0;
+
+  /* codec selected by GZ_TEXCACHE/GZ_HIRESTEXCACHE and LZ4_TXCACHE, nullptr for none */
+  static const TxCodec * fromOptions(int options);
+  /* codec which compressed data of this format, nullptr for uncompressed */
+  static const TxCodec * fromFormat(uint32 format);
+};
+
+#endif /* __TXCODEC_H__ */
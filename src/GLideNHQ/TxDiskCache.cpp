@@ -0,0 +1,343 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __MSC__
+#pragma warning(disable: 4786)
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <osal_files.h>
+#include "TxDiskCache.h"
+#include "TxDbg.h"
+
+TxDiskCache::TxDiskCache(const tx_wstring &path, int cachesize)
+	: _path(path)
+	, _cacheSize(cachesize)
+	, _totalSize(0)
+	, _serial(0)
+	, _busy(0)
+	, _pathExists(0)
+	, _stop(0)
+{
+	_thread = std::thread(&TxDiskCache::_work, this);
+}
+
+TxDiskCache::~TxDiskCache()
+{
+	/* the files are of no use without the index */
+	clear();
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stop = 1;
+	}
+	_condvar.notify_all();
+
+	_thread.join();
+}
+
+boolean
+TxDiskCache::push(uint64 checksum, GHQTexInfo *info, int size)
+{
+	if (!checksum || !info->data || size <= 0)
+		return 0;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto itMap = _entries.find(checksum);
+	if (itMap != _entries.end())
+		_erase(lock, itMap);
+
+	if (size > _cacheSize) {
+		free(info->data);
+		return 0;
+	}
+
+	/* make room, oldest first */
+	while (_totalSize + size > _cacheSize && !_entrylist.empty())
+		_erase(lock, _entries.find(_entrylist.front()));
+
+	DiskEntry &entry = _entries[checksum];
+	entry.info = *info;
+	entry.size = size;
+	entry.serial = ++_serial;
+	entry.busy = 0;
+	_entrylist.push_back(checksum);
+	entry.it = --(_entrylist.end());
+	_totalSize += size;
+
+	_queue.push_back({ checksum, entry.serial, 1 });
+	lock.unlock();
+	_condvar.notify_one();
+
+	return 1;
+}
+
+boolean
+TxDiskCache::read(uint64 checksum, GHQTexInfo *info, int *size)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto itMap = _entries.find(checksum);
+	if (itMap == _entries.end())
+		return 0;
+
+	DiskEntry &entry = itMap->second;
+	_idle.wait(lock, [&entry] { return !entry.busy; });
+
+	/* push it to the back of the list */
+	_entrylist.erase(entry.it);
+	_entrylist.push_back(checksum);
+	entry.it = --(_entrylist.end());
+
+	*info = entry.info;
+	*size = entry.size;
+	info->data = (uint8*)malloc(*size);
+	if (info->data == nullptr)
+		return 0;
+
+	if (entry.info.data) {
+		memcpy(info->data, entry.info.data, *size);
+		return 1;
+	}
+
+	/* entries are only erased by the caller's thread */
+	lock.unlock();
+	if (!_read(checksum, info->data, *size)) {
+		free(info->data);
+		info->data = nullptr;
+		return 0;
+	}
+
+	return 1;
+}
+
+boolean
+TxDiskCache::del(uint64 checksum)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto itMap = _entries.find(checksum);
+	if (itMap == _entries.end())
+		return 0;
+
+	_erase(lock, itMap);
+	lock.unlock();
+	_condvar.notify_one();
+
+	return 1;
+}
+
+boolean
+TxDiskCache::is_cached(uint64 checksum)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _entries.find(checksum) != _entries.end();
+}
+
+void
+TxDiskCache::checksums(std::vector<uint64> &list)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	list.reserve(list.size() + _entries.size());
+	for (const auto & item : _entries)
+		list.push_back(item.first);
+}
+
+void
+TxDiskCache::clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_entries.empty())
+		_erase(lock, _entries.begin());
+	lock.unlock();
+	_condvar.notify_one();
+
+	flush();
+}
+
+void
+TxDiskCache::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [this] { return _queue.empty() && !_busy; });
+}
+
+int
+TxDiskCache::size()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return (int)_entries.size();
+}
+
+int
+TxDiskCache::totalSize()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _totalSize;
+}
+
+void
+TxDiskCache::_erase(std::unique_lock<std::mutex> &lock, std::map<uint64, DiskEntry>::iterator itMap)
+{
+	DiskEntry &entry = itMap->second;
+	_idle.wait(lock, [&entry] { return !entry.busy; });
+
+	if (entry.info.data)
+		free(entry.info.data);
+	else
+		_queue.push_back({ itMap->first, 0, 0 });
+
+	_totalSize -= entry.size;
+	_entrylist.erase(entry.it);
+	_entries.erase(itMap);
+}
+
+void
+TxDiskCache::_work()
+{
+	while (true) {
+		DiskJob job;
+		const uint8 *data = nullptr;
+		int size = 0;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condvar.wait(lock, [this] { return _stop || !_queue.empty(); });
+			if (_queue.empty())
+				return;
+			job = _queue.front();
+			_queue.pop_front();
+
+			/* skip textures which were taken back or dropped meanwhile.
+			 * a newer push of the same texture has its own job, which
+			 * must stay behind the removal of the older file. */
+			if (job.write) {
+				auto itMap = _entries.find(job.checksum);
+				if (itMap != _entries.end() && itMap->second.serial == job.serial) {
+					itMap->second.busy = 1;
+					data = itMap->second.info.data;
+					size = itMap->second.size;
+				}
+			}
+			_busy = 1;
+		}
+
+		boolean written = 0;
+		if (!job.write)
+			_remove(job.checksum);
+		else if (data)
+			written = _write(job.checksum, data, size);
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (data) {
+				/* busy entries are never erased */
+				DiskEntry &entry = _entries[job.checksum];
+				entry.busy = 0;
+				if (written) {
+					free(entry.info.data);
+					entry.info.data = nullptr;
+				} else {
+					/* keep serving it from memory */
+					DBG_INFO(80, wst("Error: failed to write %08X %08X to disk cache\n"),
+							 (uint32)(job.checksum >> 32), (uint32)(job.checksum & 0xffffffff));
+				}
+			}
+			_busy = 0;
+		}
+		_idle.notify_all();
+	}
+}
+
+tx_wstring
+TxDiskCache::_getFileName(uint64 checksum) const
+{
+	wchar_t wbuf[32];
+	tx_swprintf(wbuf, 32, wst("/%08X%08X.bin"), (uint32)(checksum >> 32), (uint32)(checksum & 0xffffffff));
+	tx_wstring filename(_path);
+	filename.append(wbuf);
+	return filename;
+}
+
+boolean
+TxDiskCache::_write(uint64 checksum, const uint8 *data, int size)
+{
+	if (!_pathExists) {
+		if (!osal_path_existsW(_path.c_str()) && osal_mkdirp(_path.c_str()) != 0)
+			return 0;
+		_pathExists = 1;
+	}
+
+	const tx_wstring filename = _getFileName(checksum);
+	FILE *fp = nullptr;
+#ifdef OS_WINDOWS
+	if ((fp = _wfopen(filename.c_str(), wst("wb"))) == nullptr)
+		return 0;
+#else
+	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filename.c_str(), MAX_PATH);
+	if ((fp = fopen(cbuf, "wb")) == nullptr)
+		return 0;
+#endif
+
+	const boolean res = fwrite(data, 1, size, fp) == (size_t)size;
+	fclose(fp);
+
+	return res;
+}
+
+boolean
+TxDiskCache::_read(uint64 checksum, uint8 *data, int size)
+{
+	const tx_wstring filename = _getFileName(checksum);
+	FILE *fp = nullptr;
+#ifdef OS_WINDOWS
+	if ((fp = _wfopen(filename.c_str(), wst("rb"))) == nullptr)
+		return 0;
+#else
+	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filename.c_str(), MAX_PATH);
+	if ((fp = fopen(cbuf, "rb")) == nullptr)
+		return 0;
+#endif
+
+	const boolean res = fread(data, 1, size, fp) == (size_t)size;
+	fclose(fp);
+
+	return res;
+}
+
+void
+TxDiskCache::_remove(uint64 checksum)
+{
+	const tx_wstring filename = _getFileName(checksum);
+#ifdef OS_WINDOWS
+	_wremove(filename.c_str());
+#else
+	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filename.c_str(), MAX_PATH);
+	remove(cbuf);
+#endif
+}
@@ -0,0 +1,91 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXDISKCACHE_H__
+#define __TXDISKCACHE_H__
+
+#include "TxInternal.h"
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* Last tier of the texture cache. Keeps textures evicted from the memory
+ * cache in one file per texture. Files are written and removed on a worker
+ * thread; a texture waiting to be written stays in memory and is served
+ * from there. The files only live as long as the cache. */
+class TxDiskCache
+{
+private:
+  struct DiskEntry {
+    GHQTexInfo info; /* info.data is set until the texture is written */
+    int size;
+    uint32 serial;   /* tells pushes of the same texture apart */
+    boolean busy;    /* the worker is writing info.data */
+    std::list<uint64>::iterator it;
+  };
+  struct DiskJob {
+    uint64 checksum;
+    uint32 serial;
+    boolean write;   /* 0: remove the file */
+  };
+  std::map<uint64, DiskEntry> _entries;
+  std::list<uint64> _entrylist; /* oldest in the front */
+  std::deque<DiskJob> _queue;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _condvar;
+  std::condition_variable _idle;
+  tx_wstring _path;
+  int _cacheSize;
+  int _totalSize;
+  uint32 _serial;
+  boolean _busy;
+  boolean _pathExists;
+  boolean _stop;
+  void _work();
+  void _erase(std::unique_lock<std::mutex> &lock, std::map<uint64, DiskEntry>::iterator itMap);
+  tx_wstring _getFileName(uint64 checksum) const;
+  boolean _write(uint64 checksum, const uint8 *data, int size);
+  boolean _read(uint64 checksum, uint8 *data, int size);
+  void _remove(uint64 checksum);
+public:
+  ~TxDiskCache();
+  TxDiskCache(const tx_wstring &path, int cachesize);
+  /* takes ownership of info->data, which must be allocated with malloc */
+  boolean push(uint64 checksum, GHQTexInfo *info, int size);
+  /* copies the texture and keeps it cached. caller frees info->data */
+  boolean read(uint64 checksum, GHQTexInfo *info, int *size);
+  boolean del(uint64 checksum);
+  boolean is_cached(uint64 checksum);
+  void checksums(std::vector<uint64> &list);
+  void clear();
+  void flush();
+  int size();
+  int totalSize();
+};
+
+#endif /* __TXDISKCACHE_H__ */
@@ -0,0 +1,189 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __MSC__
+#pragma warning(disable: 4786)
+#endif
+
+#include <functional>
+#include <string.h>
+#include <stdlib.h>
+#include <osal_files.h>
+#include "TxDumpQueue.h"
+#include "TxImage.h"
+#include "TxUtil.h"
+#include "TxDbg.h"
+
+TxDumpQueue::TxDumpQueue(const tx_wstring &path, int compressionLevel)
+	: _path(path)
+	, _queueSize(0)
+	, _busy(0)
+	, _compressionLevel(compressionLevel)
+	, _pathExists(0)
+	, _stop(0)
+{
+	uint32 numThreads = TxUtil::getNumberofProcessors() >> 1;
+	if (numThreads < 1) numThreads = 1;
+	if (numThreads > TXDUMP_MAXTHREADS) numThreads = TXDUMP_MAXTHREADS;
+
+	for (uint32 i = 0; i < numThreads; ++i)
+		_threads.emplace_back(std::bind(&TxDumpQueue::_work, this));
+}
+
+TxDumpQueue::~TxDumpQueue()
+{
+	/* write everything which is still queued */
+	flush();
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stop = 1;
+	}
+	_condvar.notify_all();
+
+	for (auto & thread : _threads)
+		thread.join();
+}
+
+boolean
+TxDumpQueue::push(const tx_wstring &filename, uint8 *src, int width, int height, int rowStridePixel,
+				  uint16 n64fmt, uint64 r_crc64)
+{
+	const uint32 dataSize = (uint32)(width * height) << 2;
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		if (_dumped.find(std::make_pair(r_crc64, n64fmt)) != _dumped.end())
+			return 0;
+
+		/* drop the texture rather than stall the emulation.
+		 * it is not marked dumped, so it is taken on next load. */
+		if (_queueSize + dataSize > TXDUMP_MAXQUEUESIZE) {
+			DBG_INFO(80, wst("dump queue is full. r_crc64:%08X %08X dropped\n"),
+					 (uint32)(r_crc64 >> 32), (uint32)(r_crc64 & 0xffffffff));
+			return 0;
+		}
+
+		_dumped.insert(std::make_pair(r_crc64, n64fmt));
+		_queueSize += dataSize;
+	}
+
+	DumpItem *item = new DumpItem;
+	item->filename = filename;
+	item->width = width;
+	item->height = height;
+	item->data.resize(dataSize);
+
+	const int rowBytes = width << 2;
+	for (int y = 0; y < height; ++y)
+		memcpy(item->data.data() + y * rowBytes, src + ((y * rowStridePixel) << 2), rowBytes);
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_queue.push_back(item);
+	}
+	_condvar.notify_one();
+
+	return 1;
+}
+
+boolean
+TxDumpQueue::dumped(uint16 n64fmt, uint64 r_crc64)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _dumped.find(std::make_pair(r_crc64, n64fmt)) != _dumped.end();
+}
+
+void
+TxDumpQueue::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [this] { return _queue.empty() && _busy == 0; });
+}
+
+void
+TxDumpQueue::_work()
+{
+	while (true) {
+		DumpItem *item = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condvar.wait(lock, [this] { return _stop || !_queue.empty(); });
+			if (_queue.empty())
+				return;
+			item = _queue.front();
+			_queue.pop_front();
+			++_busy;
+		}
+
+		if (!_write(item))
+			DBG_INFO(80, wst("Error: failed to dump %ls\n"), item->filename.c_str());
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queueSize -= (uint32)item->data.size();
+			--_busy;
+		}
+		_idle.notify_all();
+
+		delete item;
+	}
+}
+
+boolean
+TxDumpQueue::_write(DumpItem *item)
+{
+	{
+		/* create directories */
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (!_pathExists) {
+			if (!osal_path_existsW(_path.c_str()) && osal_mkdirp(_path.c_str()) != 0)
+				return 0;
+			_pathExists = 1;
+		}
+	}
+
+	tx_wstring filename(_path);
+	filename.append(item->filename);
+
+	FILE *fp = nullptr;
+#ifdef OS_WINDOWS
+	if ((fp = _wfopen(filename.c_str(), wst("wb"))) == nullptr)
+		return 0;
+#else
+	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filename.c_str(), MAX_PATH);
+	if ((fp = fopen(cbuf, "wb")) == nullptr)
+		return 0;
+#endif
+
+	/* TxImage keeps no state, one per write is cheap */
+	TxImage txImage;
+	const boolean res = txImage.writePNG(item->data.data(), fp, item->width, item->height,
+										 item->width << 2, graphics::internalcolorFormat::RGBA8,
+										 _compressionLevel);
+	fclose(fp);
+
+	return res;
+}
@@ -0,0 +1,76 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * Copyright (C) 2007  Hiroshi Morii   All Rights Reserved.
+ * Email koolsmoky(at)users.sourceforge.net
+ * Web   http://www.3dfxzone.it/koolsmoky
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXDUMPQUEUE_H__
+#define __TXDUMPQUEUE_H__
+
+/* maximum size of texels waiting to be written, in bytes */
+#define TXDUMP_MAXQUEUESIZE (64 * 1024 * 1024)
+
+/* maximum number of png encoding threads */
+#define TXDUMP_MAXTHREADS 2
+
+#include "TxInternal.h"
+#include <deque>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* Writes dumped textures to png files on worker threads,
+ * so that dumping does not stall the emulation. */
+class TxDumpQueue
+{
+private:
+  struct DumpItem {
+    tx_wstring filename;
+    int width;
+    int height;
+    std::vector<uint8> data; /* RGBA8, tightly packed */
+  };
+  std::deque<DumpItem*> _queue;
+  std::set<std::pair<uint64, uint16>> _dumped;
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _condvar;
+  std::condition_variable _idle;
+  tx_wstring _path;
+  uint32 _queueSize;
+  int _busy;
+  int _compressionLevel;
+  boolean _pathExists;
+  boolean _stop;
+  void _work();
+  boolean _write(DumpItem *item);
+public:
+  ~TxDumpQueue();
+  TxDumpQueue(const tx_wstring &path, int compressionLevel);
+  /* returns 0 if the texture was dumped before or the queue is full */
+  boolean push(const tx_wstring &filename, uint8 *src, int width, int height, int rowStridePixel,
+               uint16 n64fmt, uint64 r_crc64);
+  boolean dumped(uint16 n64fmt, uint64 r_crc64);
+  void flush();
+};
+
+#endif /* __TXDUMPQUEUE_H__ */
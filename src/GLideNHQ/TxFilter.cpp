@@ -38,6 +38,9 @@
 
 void TxFilter::clear()
 {
+	/* finish texture dumps */
+	delete _txDumpQueue;
+
 	/* clear hires texture cache */
 	delete _txHiResCache;
 
@@ -62,6 +65,9 @@ TxFilter::TxFilter(int maxwidth,
 				   int maxbpp,
 				   int options,
 				   int cachesize,
+				   int hirescachesize,
+				   int diskcachesize,
+				   int dumpcompression,
 				   const wchar_t * texCachePath,
 				   const wchar_t * texDumpPath,
 				   const wchar_t * texPackPath,
@@ -73,6 +79,7 @@ TxFilter::TxFilter(int maxwidth,
 	, _txTexCache(nullptr)
 	, _txHiResCache(nullptr)
 	, _txImage(nullptr)
+	, _txDumpQueue(nullptr)
 {
 	/* HACKALERT: the emulator misbehaves and sometimes forgets to shutdown */
 	if ((ident && wcscmp(ident, wst("DEFAULT")) != 0 && _ident.compare(ident) == 0) &&
@@ -129,6 +136,15 @@ TxFilter::TxFilter(int maxwidth,
 	if (ident && wcscmp(ident, wst("DEFAULT")) != 0)
 		_ident.assign(ident);
 
+	/* texture dumps are written in background */
+	if ((_options & DUMP_TEX) && !_dumpPath.empty() && !_ident.empty()) {
+		tx_wstring dumpPath(_dumpPath);
+		dumpPath.append(wst("/"));
+		dumpPath.append(_ident);
+		dumpPath.append(wst("/GLideNHQ"));
+		_txDumpQueue = new TxDumpQueue(dumpPath, dumpcompression);
+	}
+
 	if (TxMemBuf::getInstance()->init(_maxwidth, _maxheight)) {
 		if (!_tex1)
 			_tex1 = TxMemBuf::getInstance()->get(0);
@@ -143,11 +159,12 @@ TxFilter::TxFilter(int maxwidth,
 #endif
 
 	/* initialize texture cache in bytes. 128Mb will do nicely in most cases */
-	_txTexCache = new TxTexCache(_options, _cacheSize, texCachePath, _ident.c_str(), callback);
+	_txTexCache = new TxTexCache(_options, _cacheSize, diskcachesize, texCachePath, _ident.c_str(), callback);
 
 	/* hires texture */
 #if HIRES_TEXTURE
-	_txHiResCache = new TxHiResCache(_maxwidth, _maxheight, _maxbpp, _options, texCachePath, texPackPath, _ident.c_str(), callback);
+	_txHiResCache = new TxHiResCache(_maxwidth, _maxheight, _maxbpp, _options, hirescachesize, diskcachesize,
+									 texCachePath, texPackPath, _ident.c_str(), callback);
 
 	if (_txHiResCache->empty())
 		_options &= ~HIRESTEXTURES_MASK;
@@ -578,7 +595,10 @@ TxFilter::dmptx(uint8 *src, int width, int height, int rowStridePixel, ColorForm
 	if (!_initialized)
 		return 0;
 
-	if (!(_options & DUMP_TEX))
+	if (!(_options & DUMP_TEX) || _txDumpQueue == nullptr)
+		return 0;
+
+	if (_txDumpQueue->dumped(n64fmt, r_crc64))
 		return 0;
 
 	DBG_INFO(80, wst("gfmt = %02x n64fmt = %02x\n"), u32(gfmt), n64fmt);
@@ -591,43 +611,14 @@ TxFilter::dmptx(uint8 *src, int width, int height, int rowStridePixel, ColorForm
 		src = _tex1;
 	}
 
-	if (!_dumpPath.empty() && !_ident.empty()) {
-		/* dump it to disk */
-		FILE *fp = nullptr;
-		tx_wstring tmpbuf;
-
-		/* create directories */
-		tmpbuf.assign(_dumpPath);
-		tmpbuf.append(wst("/"));
-		tmpbuf.append(_ident);
-		tmpbuf.append(wst("/GLideNHQ"));
-		if (!osal_path_existsW(tmpbuf.c_str()) && osal_mkdirp(tmpbuf.c_str()) != 0)
-			return 0;
+	/* queue it for dump to disk */
+	wchar_t wbuf[256];
+	if ((n64fmt >> 8) == 0x2)
+		tx_swprintf(wbuf, 256, wst("/%ls#%08X#%01X#%01X#%08X_ciByRGBA.png"), _ident.c_str(), (uint32)(r_crc64 & 0xffffffff), (n64fmt >> 8), (n64fmt & 0xf), (uint32)(r_crc64 >> 32));
+	else
+		tx_swprintf(wbuf, 256, wst("/%ls#%08X#%01X#%01X_all.png"), _ident.c_str(), (uint32)(r_crc64 & 0xffffffff), (n64fmt >> 8), (n64fmt & 0xf));
 
-		if ((n64fmt >> 8) == 0x2) {
-			wchar_t wbuf[256];
-			tx_swprintf(wbuf, 256, wst("/%ls#%08X#%01X#%01X#%08X_ciByRGBA.png"), _ident.c_str(), (uint32)(r_crc64 & 0xffffffff), (n64fmt >> 8), (n64fmt & 0xf), (uint32)(r_crc64 >> 32));
-			tmpbuf.append(wbuf);
-		} else {
-			wchar_t wbuf[256];
-			tx_swprintf(wbuf, 256, wst("/%ls#%08X#%01X#%01X_all.png"), _ident.c_str(), (uint32)(r_crc64 & 0xffffffff), (n64fmt >> 8), (n64fmt & 0xf));
-			tmpbuf.append(wbuf);
-		}
-
-#ifdef OS_WINDOWS
-		if ((fp = _wfopen(tmpbuf.c_str(), wst("wb"))) != nullptr) {
-#else
-		char cbuf[MAX_PATH];
-		wcstombs(cbuf, tmpbuf.c_str(), MAX_PATH);
-		if ((fp = fopen(cbuf, "wb")) != nullptr) {
-#endif
-			_txImage->writePNG(src, fp, width, height, (rowStridePixel << 2), graphics::internalcolorFormat::RGBA8);
-			fclose(fp);
-			return 1;
-		}
-	}
-
-	return 0;
+	return _txDumpQueue->push(wbuf, src, width, height, rowStridePixel, n64fmt, r_crc64);
 }
 
 boolean
@@ -644,6 +635,17 @@ TxFilter::reloadhirestex()
 	return 0;
 }
 
+void
+TxFilter::cachestats(GHQCacheStats *texcache, GHQCacheStats *hirescache)
+{
+	if (texcache && _txTexCache)
+		_txTexCache->getStats(texcache);
+#if HIRES_TEXTURE
+	if (hirescache && _txHiResCache)
+		_txHiResCache->getStats(hirescache);
+#endif
+}
+
 void
 TxFilter::dumpcache()
 {
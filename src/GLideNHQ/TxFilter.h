@@ -30,6 +30,7 @@
 #include "TxTexCache.h"
 #include "TxUtil.h"
 #include "TxImage.h"
+#include "TxDumpQueue.h"
 
 class TxFilter
 {
@@ -49,6 +50,7 @@ private:
   TxTexCache *_txTexCache;
   TxHiResCache *_txHiResCache;
   TxImage *_txImage;
+  TxDumpQueue *_txDumpQueue;
   boolean _initialized;
   void clear();
 public:
@@ -58,6 +60,9 @@ public:
 		   int maxbpp,
 		   int options,
 		   int cachesize,
+		   int hirescachesize,
+		   int diskcachesize,
+		   int dumpcompression,
 		   const wchar_t * texCachePath,
 		   const wchar_t * texDumpPath,
 		   const wchar_t * texPackPath,
@@ -77,6 +82,7 @@ public:
   boolean dmptx(uint8 *src, int width, int height, int rowStridePixel, ColorFormat gfmt, uint16 n64fmt, uint64 r_crc64);
   boolean reloadhirestex();
   void dumpcache();
+  void cachestats(GHQCacheStats *texcache, GHQCacheStats *hirescache);
 };
 
 #endif /* __TXFILTER_H__ */
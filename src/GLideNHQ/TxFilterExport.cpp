@@ -35,12 +35,13 @@ extern "C"{
 
 TAPI boolean TAPIENTRY
 txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+	int hirescachesize, int diskcachesize, int dumpcompression,
 	const wchar_t * txCachePath, const wchar_t* txDumpPath, const wchar_t * texPackPath, const wchar_t * ident,
 	dispInfoFuncExt callback)
 {
   if (txFilter) return 0;
 
-  txFilter = new TxFilter(maxwidth, maxheight, maxbpp, options, cachesize,
+  txFilter = new TxFilter(maxwidth, maxheight, maxbpp, options, cachesize, hirescachesize, diskcachesize, dumpcompression,
 	  txCachePath, txDumpPath, texPackPath, ident, callback);
 
   return 1;
@@ -108,6 +109,13 @@ txfilter_dumpcache(void)
 	  txFilter->dumpcache();
 }
 
+TAPI void TAPIENTRY
+txfilter_cachestats(GHQCacheStats *texcache, GHQCacheStats *hirescache)
+{
+	if (txFilter)
+		txFilter->cachestats(texcache, hirescache);
+}
+
 
 #ifdef __cplusplus
 }
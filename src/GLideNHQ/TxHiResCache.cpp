@@ -43,9 +43,13 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 TxHiResCache::~TxHiResCache()
 {
+  /* a partly loaded pack is of no use anymore */
+  _finishLoad(0);
+
   delete _txImage;
   delete _txQuantize;
   delete _txReSample;
@@ -55,11 +59,13 @@ TxHiResCache::TxHiResCache(int maxwidth,
 						   int maxheight,
 						   int maxbpp,
 						   int options,
+						   int cachesize,
+						   int diskcachesize,
 						   const wchar_t *cachePath,
 						   const wchar_t *texPackPath,
 						   const wchar_t *ident,
 						   dispInfoFuncExt callback)
-	: TxCache((options & ~GZ_TEXCACHE), 0, cachePath, ident, callback)
+	: TxCache((options & ~GZ_TEXCACHE), diskcachesize > 0 ? cachesize : 0, cachePath, ident, callback)
 {
   _txImage = new TxImage();
   _txQuantize  = new TxQuantize();
@@ -70,6 +76,11 @@ TxHiResCache::TxHiResCache(int maxwidth,
   _maxbpp    = maxbpp;
   _abortLoad = 0;
   _cacheDumped = 0;
+  _readySize = 0;
+  _loadResult = resOk;
+  _loading = 0;
+  _loadDone = 0;
+  _cancelLoad = 0;
 
   if (texPackPath)
 	  _texPackPath.assign(texPackPath);
@@ -79,27 +90,103 @@ TxHiResCache::TxHiResCache(int maxwidth,
 	return;
   }
 
+  /* hires textures are loaded once, so they may leave memory only for disk */
+  tx_wstring diskCacheName = _ident + wst("_HIRESTEXTURES_DISK");
+  removeColon(diskCacheName);
+  initDiskCache(diskcachesize, diskCacheName);
+
   /* read in hires texture cache */
   if (_options & DUMP_HIRESTEXCACHE) {
 	/* find it on disk */
 	_cacheDumped = TxCache::load(_cachePath.c_str(), _getFileName().c_str(), _getConfig(), !_HiResTexPackPathExists());
   }
 
-/* read in hires textures */
-  if (!_cacheDumped) {
-	  if (TxHiResCache::load(0) && (_options & DUMP_HIRESTEXCACHE) != 0)
-		  _cacheDumped = TxCache::save(_cachePath.c_str(), _getFileName().c_str(), _getConfig());
-  }
+/* read in hires textures while the game starts. the cache is dumped
+ * with the next dump() */
+  if (!_cacheDumped)
+	  _startLoad();
 }
 
 void TxHiResCache::dump()
 {
-	if ((_options & DUMP_HIRESTEXCACHE) && !_cacheDumped && !_abortLoad && !empty()) {
+	if (!(_options & DUMP_HIRESTEXCACHE) || _cacheDumped)
+		return;
+
+	/* only a fully loaded pack is worth dumping. the rest of the pack is not
+	 * waited for, that would hold up closing the ROM. */
+	if (_loading) {
+		boolean loadDone;
+		{
+			std::unique_lock<std::mutex> lock(_loadMutex);
+			loadDone = _loadDone;
+		}
+		_finishLoad(loadDone);
+		if (!loadDone)
+			return;
+	}
+
+	if (!_abortLoad && !empty()) {
 	  /* dump cache to disk */
 	  _cacheDumped = TxCache::save(_cachePath.c_str(), _getFileName().c_str(), _getConfig());
 	}
 }
 
+/* encode RGBA8 textures of the cache to BC1/BC3 and dump it to disk.
+ * run offline by transcode/htc_transcode; the driver then gets the blocks as is. */
+boolean TxHiResCache::transcode()
+{
+	_finishLoad(1);
+
+	if (!(_options & S3TC_HIRESTEX)) {
+		INFO(80, wst("Warning: hires textures are not transcoded, hardware does not support S3TC\n"));
+		return 0;
+	}
+
+	if (empty() || _cachePath.empty() || _ident.empty())
+		return 0;
+
+	std::vector<uint64> checksums;
+	TxCache::checksums(checksums);
+
+	int count = 0;
+	for (uint64 checksum : checksums) {
+		GHQTexInfo info;
+		if (!get(checksum, &info) || info.format != u32(graphics::internalcolorFormat::RGBA8))
+			continue;
+
+		boolean opaque = 1;
+		const int numPixels = info.width * info.height;
+		for (int i = 0; i < numPixels && opaque; i++)
+			opaque = info.data[(i << 2) + 3] == 0xff;
+
+		const ColorFormat destformat = opaque ?
+			graphics::internalcolorFormat::COMPRESSED_RGBA_BC1 :
+			graphics::internalcolorFormat::COMPRESSED_RGBA_BC3;
+		uint8 *blocks = (uint8*)malloc(TxUtil::sizeofTx(info.width, info.height, destformat));
+		if (blocks == nullptr)
+			break;
+
+		if (_txQuantize->compress(info.data, blocks, info.width, info.height, destformat)) {
+			GHQTexInfo tmpInfo = info;
+			tmpInfo.data = blocks;
+			tmpInfo.format = u32(destformat);
+			setTextureFormat(destformat, &tmpInfo);
+			del(checksum);
+			if (add(checksum, &tmpInfo))
+				++count;
+		}
+		free(blocks);
+
+		if (_callback)
+			(*_callback)(wst("transcoded %d of %d hires textures\n"), count, (int)checksums.size());
+	}
+
+	DBG_INFO(80, wst("transcoded %d of %d hires textures\n"), count, checksums.size());
+
+	_cacheDumped = TxCache::save(_cachePath.c_str(), _getFileName().c_str(), _getConfig());
+	return _cacheDumped;
+}
+
 tx_wstring TxHiResCache::_getFileName() const
 {
 	tx_wstring filename = _ident + wst("_HIRESTEXTURES.") + TEXCACHE_EXT;
@@ -122,7 +209,16 @@ boolean TxHiResCache::_HiResTexPackPathExists() const
 
 boolean TxHiResCache::empty()
 {
-  return _cache.empty();
+  /* textures may still come */
+  return !_loading && size() == 0;
+}
+
+boolean TxHiResCache::get(uint64 checksum, GHQTexInfo *info)
+{
+	if (_loading)
+		_promoteLoaded(checksum);
+
+	return TxCache::get(checksum, info);
 }
 
 boolean TxHiResCache::load(boolean replace) /* 0 : reload, 1 : replace partial */
@@ -130,6 +226,8 @@ boolean TxHiResCache::load(boolean replace) /* 0 : reload, 1 : replace partial *
 	if (_texPackPath.empty() || _ident.empty())
 		return 0;
 
+	_finishLoad(0);
+
 	if (!replace) TxCache::clear();
 
 	tx_wstring dir_path(_texPackPath);
@@ -150,19 +248,232 @@ boolean TxHiResCache::load(boolean replace) /* 0 : reload, 1 : replace partial *
 		dir_path += OSAL_DIR_SEPARATOR_STR;
 		dir_path += _ident;
 
-		const LoadResult res = loadHiResTextures(dir_path.c_str(), replace);
+		std::vector<PackEntry> pack;
+		std::set<uint64> checksums;
+		LoadResult res = _indexHiResTextures(dir_path.c_str(), pack, checksums);
+		for (size_t i = 0; i < pack.size() && res == resOk; ++i) {
+			if (KBHIT(0x1B)) {
+				_abortLoad = 1;
+				if (_callback) (*_callback)(wst("Aborted loading hiresolution texture!\n"));
+				INFO(80, wst("Error: aborted loading hiresolution texture!\n"));
+			}
+			if (_abortLoad) break;
+
+			GHQTexInfo tmpInfo;
+			const LoadResult texRes = _readHiResTexture(pack[i], _txImage, _txQuantize, _txReSample, &tmpInfo);
+			if (texRes == resError)
+				res = resError;
+			if (texRes != resOk)
+				continue;
+
+			/* remove redundant in cache */
+			if (replace && TxCache::del(pack[i].checksum)) {
+				DBG_INFO(80, wst("removed duplicate old cache.\n"));
+			}
+
+			/* add to cache */
+			const boolean added = TxCache::add(pack[i].checksum, &tmpInfo);
+			free(tmpInfo.data);
+			if (!added) {
+				res = resError;
+				break;
+			}
+
+			/* Callback to display hires texture info.
+			 * Gonetz <gonetz(at)ngs.ru> */
+			if (_callback) {
+				wchar_t tmpbuf[MAX_PATH];
+				mbstowcs(tmpbuf, pack[i].path.c_str() + pack[i].path.rfind('/') + 1, MAX_PATH);
+				(*_callback)(wst("[%d] total mem:%.2fmb - %ls\n"), _cache.size(), (float)_totalSize/1000000, tmpbuf);
+			}
+			DBG_INFO(80, wst("texture loaded!\n"));
+		}
 		if (res == resError) {
 			if (_callback) (*_callback)(wst("Texture pack load failed. Clear hiresolution texture cache.\n"));
 			INFO(80, wst("Texture pack load failed. Clear hiresolution texture cache.\n"));
-			_cache.clear();
+			TxCache::clear();
 		}
 		return res == resOk ? 1 : 0;
 	}
 	return 0;
 }
 
+void TxHiResCache::_startLoad()
+{
+	if (_texPackPath.empty() || _ident.empty() ||
+		(_options & HIRESTEXTURES_MASK) != RICE_HIRESTEXTURES || !_HiResTexPackPathExists())
+		return;
+
+	TxCache::clear();
+
+	tx_wstring dir_path(_texPackPath);
+	dir_path += OSAL_DIR_SEPARATOR_STR;
+	dir_path += _ident;
+
+	_readySize = 0;
+	_loadResult = resOk;
+	_loadDone = 0;
+	_cancelLoad = 0;
+	_loading = 1;
+	_loadThread = std::thread(&TxHiResCache::_loadWork, this, dir_path);
+}
+
+void TxHiResCache::_loadWork(tx_wstring dir_path)
+{
+	std::vector<PackEntry> pack;
+	std::set<uint64> checksums;
+	LoadResult result = _indexHiResTextures(dir_path.c_str(), pack, checksums);
+
+	/* lookups can read textures from now on. _pack keeps its size. */
+	std::unique_lock<std::mutex> lock(_loadMutex);
+	_pack.swap(pack);
+	for (size_t i = 0; i < _pack.size(); ++i)
+		_packIndex[_pack[i].checksum] = i;
+	lock.unlock();
+
+	/* the helpers of the cache belong to the caller's thread */
+	TxImage txImage;
+	TxQuantize txQuantize;
+	TxReSample txReSample;
+
+	for (size_t i = 0; i < _pack.size() && result == resOk; ++i) {
+		if (KBHIT(0x1B)) {
+			_abortLoad = 1;
+			INFO(80, wst("Error: aborted loading hiresolution texture!\n"));
+		}
+		if (_abortLoad) break;
+
+		lock.lock();
+		_loadCondvar.wait(lock, [this] { return _cancelLoad || _readySize < TXHIRES_MAXREADYSIZE; });
+		PackEntry &entry = _pack[i];
+		if (_cancelLoad || entry.state != peQueued) {
+			const boolean cancel = _cancelLoad;
+			lock.unlock();
+			if (cancel)
+				break;
+			continue;
+		}
+		entry.state = peReading;
+		lock.unlock();
+
+		GHQTexInfo info;
+		const LoadResult res = _readHiResTexture(entry, &txImage, &txQuantize, &txReSample, &info);
+
+		lock.lock();
+		entry.state = peDone;
+		if (res == resOk) {
+			_ready[entry.checksum] = info;
+			_readySize += TxUtil::sizeofTx(info.width, info.height, ColorFormat(info.format));
+		} else if (res == resError) {
+			result = resError;
+		}
+		lock.unlock();
+		_loadIdle.notify_all();
+	}
+
+	lock.lock();
+	_loadResult = result;
+	_loadDone = 1;
+	lock.unlock();
+	_loadIdle.notify_all();
+}
+
+void TxHiResCache::_promoteReady(std::unique_lock<std::mutex> &lock, std::map<uint64, GHQTexInfo>::iterator itReady)
+{
+	const uint64 checksum = itReady->first;
+	GHQTexInfo info = itReady->second;
+	_readySize -= TxUtil::sizeofTx(info.width, info.height, ColorFormat(info.format));
+	_ready.erase(itReady);
+	lock.unlock();
+	_loadCondvar.notify_one();
+
+	TxCache::add(checksum, &info);
+	free(info.data);
+
+	lock.lock();
+}
+
+void TxHiResCache::_promoteLoaded(uint64 checksum)
+{
+	{
+		std::unique_lock<std::mutex> lock(_loadMutex);
+
+		auto itReady = _ready.find(checksum);
+		if (itReady != _ready.end()) {
+			_promoteReady(lock, itReady);
+		} else if (!TxCache::is_cached(checksum)) {
+			auto itPack = _packIndex.find(checksum);
+			if (itPack != _packIndex.end()) {
+				PackEntry &entry = _pack[itPack->second];
+				if (entry.state == peQueued) {
+					/* not reached yet, read it right away */
+					entry.state = peDone;
+					lock.unlock();
+					GHQTexInfo info;
+					if (_readHiResTexture(entry, _txImage, _txQuantize, _txReSample, &info) == resOk) {
+						TxCache::add(checksum, &info);
+						free(info.data);
+					}
+					lock.lock();
+				} else if (entry.state == peReading) {
+					_loadIdle.wait(lock, [&entry] { return entry.state == peDone; });
+					itReady = _ready.find(checksum);
+					if (itReady != _ready.end())
+						_promoteReady(lock, itReady);
+				}
+			}
+		}
+
+		/* a few of the others, so that the thread keeps going */
+		for (int i = 0; i < TXHIRES_MAXPROMOTE && !_ready.empty(); ++i)
+			_promoteReady(lock, _ready.begin());
+
+		if (!_loadDone || !_ready.empty())
+			return;
+	}
+
+	_finishLoad(1);
+}
+
+void TxHiResCache::_finishLoad(boolean wait)
+{
+	if (!_loading)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(_loadMutex);
+		if (!wait)
+			_cancelLoad = 1;
+		_loadCondvar.notify_one();
+
+		/* keep taking textures, the thread waits for room */
+		while (wait && (!_loadDone || !_ready.empty())) {
+			_loadIdle.wait(lock, [this] { return _loadDone || !_ready.empty(); });
+			while (!_ready.empty())
+				_promoteReady(lock, _ready.begin());
+		}
+	}
+
+	_loadThread.join();
+
+	for (auto & item : _ready)
+		free(item.second.data);
+	_ready.clear();
+	_readySize = 0;
+	_pack.clear();
+	_packIndex.clear();
+	_loading = 0;
+
+	if (wait && _loadResult == resError) {
+		INFO(80, wst("Texture pack load failed. Clear hiresolution texture cache.\n"));
+		TxCache::clear();
+	}
+}
+
+/* Walks the pack and parses the file names. Nothing is read yet, so this is
+ * quick compared to loading the textures. */
 TxHiResCache::LoadResult
-TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
+TxHiResCache::_indexHiResTextures(const wchar_t * dir_path, std::vector<PackEntry> &pack, std::set<uint64> &checksums)
 {
   DBG_INFO(80, wst("-----\n"));
   DBG_INFO(80, wst("path: %ls\n"), dir_path);
@@ -175,19 +486,10 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 
   LoadResult result = resOk;
 
-#ifdef OS_WINDOWS
-  wchar_t curpath[MAX_PATH];
-  GETCWD(MAX_PATH, curpath);
-  CHDIR(dir_path);
-#else
-  char curpath[MAX_PATH];
-  char cbuf[MAX_PATH];
-  wcstombs(cbuf, dir_path, MAX_PATH);
-  GETCWD(MAX_PATH, curpath);
-  CHDIR(cbuf);
-#endif
+  char dir[MAX_PATH];
+  wcstombs(dir, dir_path, MAX_PATH);
 
-  void *dir = osal_search_dir_open(dir_path);
+  void *dir_handle = osal_search_dir_open(dir_path);
   const wchar_t *foundfilename;
   // the path of the texture
   tx_wstring texturefilename;
@@ -196,12 +498,11 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 
 	if (KBHIT(0x1B)) {
 	  _abortLoad = 1;
-	  if (_callback) (*_callback)(wst("Aborted loading hiresolution texture!\n"));
 	  INFO(80, wst("Error: aborted loading hiresolution texture!\n"));
 	}
 	if (_abortLoad) break;
 
-	foundfilename = osal_search_dir_read_next(dir);
+	foundfilename = osal_search_dir_read_next(dir_handle);
 	// The array is empty,  break the current operation
 	if (foundfilename == nullptr)
 		break;
@@ -215,7 +516,7 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 
 	/* recursive read into sub-directory */
 	if (osal_is_directory(texturefilename.c_str())) {
-		result = loadHiResTextures(texturefilename.c_str(), replace);
+		result = _indexHiResTextures(texturefilename.c_str(), pack, checksums);
 		if (result == resOk)
 			continue;
 		else
@@ -225,20 +526,11 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	DBG_INFO(80, wst("-----\n"));
 	DBG_INFO(80, wst("file: %ls\n"), foundfilename);
 
-	int width = 0, height = 0;
-	ColorFormat format = graphics::internalcolorFormat::NOCOLOR;
-	uint8 *tex = nullptr;
-	int tmpwidth = 0, tmpheight = 0;
-	ColorFormat tmpformat = graphics::internalcolorFormat::NOCOLOR;
-	uint8 *tmptex= nullptr;
-	ColorFormat destformat = graphics::internalcolorFormat::NOCOLOR;
-
 	/* Rice hi-res textures: begin
 	 */
 	uint32 chksum = 0, fmt = 0, siz = 0, palchksum = 0;
 	char *pfname = nullptr, fname[MAX_PATH];
 	std::string ident;
-	FILE *fp = nullptr;
 
 	wcstombs(fname, _ident.c_str(), MAX_PATH);
 	/* XXX case sensitivity fiasco!
@@ -268,13 +560,14 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	pfname = fname + strlen(fname) - 4;
 	if (!(pfname == strstr(fname, ".png") ||
 		  pfname == strstr(fname, ".bmp") ||
-		  pfname == strstr(fname, ".dds"))) {
+		  pfname == strstr(fname, ".dds") ||
+		  pfname == strstr(fname, ".ktx"))) {
 #if !DEBUG
 	  INFO(80, wst("-----\n"));
 	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
 	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-	  INFO(80, wst("Error: not png or bmp or dds!\n"));
+	  INFO(80, wst("Error: not png or bmp or dds or ktx!\n"));
 	  continue;
 	}
 	pfname = strstr(fname, ident.c_str());
@@ -306,21 +599,66 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	  continue;
 	}
 
-	/* check if we already have it in hires texture cache */
-	if (!replace) {
-	  uint64 chksum64 = (uint64)palchksum;
-	  chksum64 <<= 32;
-	  chksum64 |= (uint64)chksum;
-	  if (TxCache::is_cached(chksum64)) {
+	/* check if we already have it in the pack */
+	uint64 chksum64 = (uint64)palchksum;
+	chksum64 <<= 32;
+	chksum64 |= (uint64)chksum;
+	if (!checksums.insert(chksum64).second) {
 #if !DEBUG
-		INFO(80, wst("-----\n"));
-		INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-		INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+	  INFO(80, wst("-----\n"));
+	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-		INFO(80, wst("Error: already cached! duplicate texture!\n"));
-		continue;
-	  }
+	  INFO(80, wst("Error: already cached! duplicate texture!\n"));
+	  continue;
+	}
+
+	/* the file is read later, with the full path */
+	PackEntry entry;
+	entry.checksum = chksum64;
+	entry.fmt = fmt;
+	entry.siz = siz;
+	entry.state = peQueued;
+	entry.path.assign(dir);
+	entry.path += "/";
+	entry.suffix = entry.path.size() + (pfname - fname);
+	entry.path += fname;
+	/* room for the longest suffix swapped in when reading */
+	if (entry.path.size() + 16 >= MAX_PATH) {
+	  INFO(80, wst("Error: path too long!\n"));
+	  continue;
 	}
+	pack.push_back(entry);
+
+  } while (foundfilename != nullptr);
+  osal_search_dir_close(dir_handle);
+
+  return result;
+}
+
+/* Reads a texture of the pack and converts it the way it is cached.
+ * Only touches the pack entry and the given helpers, so that it can run
+ * on the loading thread. */
+TxHiResCache::LoadResult
+TxHiResCache::_readHiResTexture(const PackEntry &entry, TxImage *txImage, TxQuantize *txQuantize,
+								TxReSample *txReSample, GHQTexInfo *info)
+{
+	int width = 0, height = 0;
+	ColorFormat format = graphics::internalcolorFormat::NOCOLOR;
+	uint8 *tex = nullptr;
+	int tmpwidth = 0, tmpheight = 0;
+	ColorFormat tmpformat = graphics::internalcolorFormat::NOCOLOR;
+	uint8 *tmptex= nullptr;
+	ColorFormat destformat = graphics::internalcolorFormat::NOCOLOR;
+
+	const uint32 chksum = (uint32)(entry.checksum & 0xffffffff);
+	const uint32 palchksum = (uint32)(entry.checksum >> 32);
+	const uint32 fmt = entry.fmt;
+	const uint32 siz = entry.siz;
+	char fname[MAX_PATH];
+	strcpy(fname, entry.path.c_str());
+	char *pfname = fname + entry.suffix;
+	FILE *fp = nullptr;
 
 	DBG_INFO(80, wst("rom: %ls chksum:%08X %08X fmt:%x size:%x\n"), _ident.c_str(), chksum, palchksum, fmt, siz);
 
@@ -354,34 +692,34 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 		  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
 		  INFO(80, wst("Error: missing _rgb.*! _a.* must be paired with _rgb.*!\n"));
-		  continue;
+		  return resNotFound;
 		}
 	  }
 	  /* _a.png */
 	  strcpy(pfname, "_a.png");
 	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		tmptex = _txImage->readPNG(fp, &tmpwidth, &tmpheight, &tmpformat);
+		tmptex = txImage->readPNG(fp, &tmpwidth, &tmpheight, &tmpformat);
 		fclose(fp);
 	  }
 	  if (!tmptex) {
 		/* _a.bmp */
 		strcpy(pfname, "_a.bmp");
 		if ((fp = fopen(fname, "rb")) != nullptr) {
-		  tmptex = _txImage->readBMP(fp, &tmpwidth, &tmpheight, &tmpformat);
+		  tmptex = txImage->readBMP(fp, &tmpwidth, &tmpheight, &tmpformat);
 		  fclose(fp);
 		}
 	  }
 	  /* _rgb.png */
 	  strcpy(pfname, "_rgb.png");
 	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		tex = _txImage->readPNG(fp, &width, &height, &format);
+		tex = txImage->readPNG(fp, &width, &height, &format);
 		fclose(fp);
 	  }
 	  if (!tex) {
 		/* _rgb.bmp */
 		strcpy(pfname, "_rgb.bmp");
 		if ((fp = fopen(fname, "rb")) != nullptr) {
-		  tex = _txImage->readBMP(fp, &width, &height, &format);
+		  tex = txImage->readBMP(fp, &width, &height, &format);
 		  fclose(fp);
 		}
 	  }
@@ -405,7 +743,7 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 		  free(tmptex);
 		  tex = nullptr;
 		  tmptex = nullptr;
-		  continue;
+		  return resNotFound;
 		}
 	  }
 	  /* make adjustments */
@@ -456,30 +794,45 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	} else
 
 	/*
-	 * read in _all.png, _all.dds, _allciByRGBA.png, _allciByRGBA.dds
-	 * _ciByRGBA.png, _ciByRGBA.dds, _ci.bmp
+	 * read in _all.png, _all.dds, _all.ktx, _allciByRGBA.png, _allciByRGBA.dds,
+	 * _allciByRGBA.ktx, _ciByRGBA.png, _ciByRGBA.dds, _ciByRGBA.ktx, _ci.bmp
 	 */
 	if (pfname == strstr(fname, "_all.png") ||
 		pfname == strstr(fname, "_all.dds") ||
+		pfname == strstr(fname, "_all.ktx") ||
 #ifdef OS_WINDOWS
 		pfname == strstr(fname, "_allcibyrgba.png") ||
 		pfname == strstr(fname, "_allcibyrgba.dds") ||
+		pfname == strstr(fname, "_allcibyrgba.ktx") ||
 		pfname == strstr(fname, "_cibyrgba.png") ||
 		pfname == strstr(fname, "_cibyrgba.dds") ||
+		pfname == strstr(fname, "_cibyrgba.ktx") ||
 #else
 		pfname == strstr(fname, "_allciByRGBA.png") ||
 		pfname == strstr(fname, "_allciByRGBA.dds") ||
+		pfname == strstr(fname, "_allciByRGBA.ktx") ||
 		pfname == strstr(fname, "_ciByRGBA.png") ||
 		pfname == strstr(fname, "_ciByRGBA.dds") ||
+		pfname == strstr(fname, "_ciByRGBA.ktx") ||
 #endif
 		pfname == strstr(fname, "_ci.bmp")) {
 	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		if      (strstr(fname, ".png")) tex = _txImage->readPNG(fp, &width, &height, &format);
-		else                            tex = _txImage->readBMP(fp, &width, &height, &format);
+		if      (strstr(fname, ".png")) tex = txImage->readPNG(fp, &width, &height, &format);
+		else if (strstr(fname, ".dds")) tex = txImage->readDDS(fp, &width, &height, &format);
+		else if (strstr(fname, ".ktx")) tex = txImage->readKTX(fp, &width, &height, &format);
+		else                            tex = txImage->readBMP(fp, &width, &height, &format);
 		fclose(fp);
 	  }
 	}
 
+	/* GPU compressed textures are kept as is if hardware can sample them */
+	if (tex && TxUtil::isCompressedTx(format) && !TxUtil::isCompressedTxSupported(format, _options)) {
+	  free(tex);
+	  tex = nullptr;
+	  INFO(80, wst("Error: compressed format gfmt:%x is not supported by hardware!\n"), u32(format));
+	  return resNotFound;
+	}
+
 	/* if we do not have a texture at this point we are screwed */
 	if (!tex) {
 #if !DEBUG
@@ -488,12 +841,13 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
 	  INFO(80, wst("Error: load failed!\n"));
-	  continue;
+	  return resNotFound;
 	}
 	DBG_INFO(80, wst("read in as %d x %d gfmt:%x\n"), tmpwidth, tmpheight, tmpformat);
 
 	/* check if size and format are OK */
-	if (!(format == graphics::internalcolorFormat::RGBA8 || format == graphics::internalcolorFormat::COLOR_INDEX8) ||
+	if (!(format == graphics::internalcolorFormat::RGBA8 || format == graphics::internalcolorFormat::COLOR_INDEX8 ||
+		  TxUtil::isCompressedTx(format)) ||
 		(width * height) < 4) { /* TxQuantize requirement: width * height must be 4 or larger. */
 	  free(tex);
 	  tex = nullptr;
@@ -502,8 +856,8 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
 	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-	  INFO(80, wst("Error: not width * height > 4 or 8bit palette color or 32bpp or dxt1 or dxt3 or dxt5!\n"));
-	  continue;
+	  INFO(80, wst("Error: not width * height > 4 or 8bit palette color or 32bpp or gpu compressed!\n"));
+	  return resNotFound;
 	}
 
 	/* analyze and determine best format to quantize */
@@ -645,26 +999,26 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 		} else {
 		  ratio = (int)ceil((double)height / _maxheight);
 		}
-		if (!_txReSample->minify(&tex, &width, &height, ratio)) {
+		if (!txReSample->minify(&tex, &width, &height, ratio)) {
 		  free(tex);
 		  tex = nullptr;
 		  DBG_INFO(80, wst("Error: minification failed!\n"));
-		  continue;
+		  return resNotFound;
 		}
 	  }
 
 #if POW2_TEXTURES
 #if (POW2_TEXTURES == 2)
 		/* 3dfx Glide3x aspect ratio (8:1 - 1:8) */
-		if (!_txReSample->nextPow2(&tex, &width , &height, 32, 1)) {
+		if (!txReSample->nextPow2(&tex, &width , &height, 32, 1)) {
 #else
 		/* normal pow2 expansion */
-		if (!_txReSample->nextPow2(&tex, &width , &height, 32, 0)) {
+		if (!txReSample->nextPow2(&tex, &width , &height, 32, 0)) {
 #endif
 		  free(tex);
 		  tex = nullptr;
 		  DBG_INFO(80, wst("Error: aspect ratio adjustment failed!\n"));
-		  continue;
+		  return resNotFound;
 		}
 #endif
 
@@ -674,8 +1028,7 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 		if (tmptex == nullptr) {
 			free(tex);
 			tex = nullptr;
-			result = resError;
-			break;
+			return resError;
 		}
 		if (destformat == graphics::internalcolorFormat::RGBA8 ||
 			destformat == graphics::internalcolorFormat::RGBA4) {
@@ -685,7 +1038,7 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 			if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
 				destformat = graphics::internalcolorFormat::RGB5_A1;
 		}
-		if (_txQuantize->quantize(tex, tmptex, width, height, graphics::internalcolorFormat::RGBA8, destformat, 0)) {
+		if (txQuantize->quantize(tex, tmptex, width, height, graphics::internalcolorFormat::RGBA8, destformat, 0)) {
 			format = destformat;
 			free(tex);
 			tex = tmptex;
@@ -710,49 +1063,14 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	  } else {
 		INFO(80, wst("Error: load failed!!\n"));
 	  }
-	  continue;
+	  return resNotFound;
 	}
 
-	/* load it into hires texture cache. */
-	{
-	  uint64 chksum64 = (uint64)palchksum;
-	  chksum64 <<= 32;
-	  chksum64 |= (uint64)chksum;
-
-	  GHQTexInfo tmpInfo;
-	  tmpInfo.data = tex;
-	  tmpInfo.width = width;
-	  tmpInfo.height = height;
-	  tmpInfo.is_hires_tex = 1;
-	  setTextureFormat(format, &tmpInfo);
-
-	  /* remove redundant in cache */
-	  if (replace && TxCache::del(chksum64)) {
-		DBG_INFO(80, wst("removed duplicate old cache.\n"));
-	  }
+	info->data = tex;
+	info->width = width;
+	info->height = height;
+	info->is_hires_tex = 1;
+	setTextureFormat(format, info);
 
-	  /* add to cache */
-	  const boolean added = TxCache::add(chksum64, &tmpInfo);
-	  free(tex);
-	  if (added) {
-		/* Callback to display hires texture info.
-		 * Gonetz <gonetz(at)ngs.ru> */
-		if (_callback) {
-		  wchar_t tmpbuf[MAX_PATH];
-		  mbstowcs(tmpbuf, fname, MAX_PATH);
-		  (*_callback)(wst("[%d] total mem:%.2fmb - %ls\n"), _cache.size(), (float)_totalSize/1000000, tmpbuf);
-		}
-		DBG_INFO(80, wst("texture loaded!\n"));
-	  } else {
-		  result = resError;
-		  break;
-	  }
-	}
-
-  } while (foundfilename != nullptr);
-  osal_search_dir_close(dir);
-
-  CHDIR(curpath);
-
-  return result;
+	return resOk;
 }
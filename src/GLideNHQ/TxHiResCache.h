@@ -34,6 +34,19 @@
 #include "TxQuantize.h"
 #include "TxImage.h"
 #include "TxReSample.h"
+#include <set>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* maximum size of pack textures read ahead of the cache, in bytes */
+#define TXHIRES_MAXREADYSIZE (64 * 1024 * 1024)
+
+/* maximum number of read ahead textures moved to the cache per lookup */
+#define TXHIRES_MAXPROMOTE 16
 
 class TxHiResCache : public TxCache
 {
@@ -42,7 +55,7 @@ private:
   int _maxheight;
   int _maxbpp;
   boolean _cacheDumped;
-  boolean _abortLoad;
+  std::atomic<boolean> _abortLoad; /* also set by the loader thread */
   TxImage *_txImage;
   TxQuantize *_txQuantize;
   TxReSample *_txReSample;
@@ -52,7 +65,43 @@ private:
 	  resNotFound,
 	  resError
   };
-  LoadResult loadHiResTextures(const wchar_t * dir_path, boolean replace);
+  enum PackEntryState {
+	  peQueued,
+	  peReading,
+	  peDone
+  };
+  /* a texture file of the pack */
+  struct PackEntry {
+	  uint64 checksum;
+	  uint32 fmt;
+	  uint32 siz;
+	  std::string path; /* full path, the suffix is swapped when reading */
+	  size_t suffix;    /* offset of _rgb, _a, _all, ... in path */
+	  PackEntryState state;
+  };
+  /* The pack is read on a thread while the game runs. Lookups move read
+   * textures to the cache, or read a texture the thread has not reached
+   * yet right away. The cache itself is only used by the caller's thread. */
+  std::thread _loadThread;
+  std::mutex _loadMutex;
+  std::condition_variable _loadCondvar;
+  std::condition_variable _loadIdle;
+  std::vector<PackEntry> _pack;
+  std::map<uint64, size_t> _packIndex;
+  std::map<uint64, GHQTexInfo> _ready;
+  uint32 _readySize;
+  LoadResult _loadResult;
+  boolean _loading;
+  boolean _loadDone;
+  boolean _cancelLoad;
+  void _startLoad();
+  void _loadWork(tx_wstring dir_path);
+  void _promoteReady(std::unique_lock<std::mutex> &lock, std::map<uint64, GHQTexInfo>::iterator itReady);
+  void _promoteLoaded(uint64 checksum);
+  void _finishLoad(boolean wait);
+  LoadResult _indexHiResTextures(const wchar_t * dir_path, std::vector<PackEntry> &pack, std::set<uint64> &checksums);
+  LoadResult _readHiResTexture(const PackEntry &entry, TxImage *txImage, TxQuantize *txQuantize,
+							   TxReSample *txReSample, GHQTexInfo *info);
   tx_wstring _getFileName() const;
   int _getConfig() const;
   boolean _HiResTexPackPathExists() const;
@@ -63,13 +112,17 @@ public:
 			   int maxheight,
 			   int maxbpp,
 			   int options,
+			   int cachesize,
+			   int diskcachesize,
 			   const wchar_t *cachePath,
 			   const wchar_t *texPackPath,
 			   const wchar_t *ident,
 			   dispInfoFuncExt callback);
   boolean empty();
   boolean load(boolean replace);
+  boolean get(uint64 checksum, GHQTexInfo *info);
   void dump();
+  boolean transcode();
 };
 
 #endif /* __TXHIRESCACHE_H__ */
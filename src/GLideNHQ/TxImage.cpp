@@ -34,6 +34,7 @@
 
 #include "TxImage.h"
 #include "TxReSample.h"
+#include "TxUtil.h"
 #include "TxDbg.h"
 
 boolean
@@ -247,7 +248,7 @@ TxImage::readPNG(FILE* fp, int* width, int* height, ColorFormat *format)
 }
 
 boolean
-TxImage::writePNG(uint8* src, FILE* fp, int width, int height, int rowStride, ColorFormat format)
+TxImage::writePNG(uint8* src, FILE* fp, int width, int height, int rowStride, ColorFormat format, int compressionLevel)
 {
 	assert(format == graphics::internalcolorFormat::RGBA8);
 	png_structp png_ptr = nullptr;
@@ -275,6 +276,8 @@ TxImage::writePNG(uint8* src, FILE* fp, int width, int height, int rowStride, Co
 	}
 
 	png_init_io(png_ptr, fp);
+	if (compressionLevel >= 0)
+		png_set_compression_level(png_ptr, compressionLevel > 9 ? 9 : compressionLevel);
 
 	bit_depth = 8;
 	sig_bit.red   = 8;
@@ -635,3 +638,166 @@ TxImage::getDDSInfo(FILE *fp, DDSFILEHEADER *dds_fhdr)
 
 	return 1;
 }
+
+uint8*
+TxImage::readCompressed(FILE* fp, int width, int height, ColorFormat format)
+{
+	/* only the top mip level is kept. the block data is stored as is. */
+	const int dataSize = TxUtil::sizeofTx(width, height, format);
+	if (dataSize == 0)
+		return nullptr;
+
+	uint8 *image = (uint8*)malloc(dataSize);
+	if (!image)
+		return nullptr;
+
+	if (fread(image, dataSize, 1, fp) != 1) {
+		free(image);
+		return nullptr;
+	}
+
+	return image;
+}
+
+uint8*
+TxImage::readDDS(FILE* fp, int* width, int* height, ColorFormat *format)
+{
+	DDSFILEHEADER dds_fhdr;
+	uint8 *image = nullptr;
+
+	*width = 0;
+	*height = 0;
+	*format = graphics::internalcolorFormat::NOCOLOR;
+
+	memset(&dds_fhdr, 0, sizeof(DDSFILEHEADER));
+
+	/* check if we have a valid dds file */
+	if (!fp || !getDDSInfo(fp, &dds_fhdr)) {
+		INFO(80, wst("error reading dds file! not a valid dds file.\n"));
+		return nullptr;
+	}
+
+	if (!(dds_fhdr.ddpf.dwFlags & DDPF_FOURCC)) {
+		INFO(80, wst("error reading dds file! only block compressed dds is supported.\n"));
+		return nullptr;
+	}
+
+	ColorFormat tmpformat = graphics::internalcolorFormat::NOCOLOR;
+	const uint32 fourCC = (uint32)dds_fhdr.ddpf.dwFourCC;
+	if (memcmp(&fourCC, "DXT1", 4) == 0) {
+		tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC1;
+	} else if (memcmp(&fourCC, "DXT2", 4) == 0 || memcmp(&fourCC, "DXT3", 4) == 0) {
+		tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC2;
+	} else if (memcmp(&fourCC, "DXT4", 4) == 0 || memcmp(&fourCC, "DXT5", 4) == 0) {
+		tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC3;
+	} else if (memcmp(&fourCC, "DX10", 4) == 0) {
+		/* DDS_HEADER_DXT10 follows the main header */
+		uint32 dx10hdr[5];
+		if (fread(dx10hdr, 4, 5, fp) != 5)
+			return nullptr;
+		switch (dx10hdr[0]) {
+		case DXGI_FORMAT_BC1_UNORM:
+			tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC1;
+			break;
+		case DXGI_FORMAT_BC2_UNORM:
+			tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC2;
+			break;
+		case DXGI_FORMAT_BC3_UNORM:
+			tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC3;
+			break;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			tmpformat = graphics::internalcolorFormat::COMPRESSED_RGBA_BC7;
+			break;
+		}
+	}
+
+	if (tmpformat == graphics::internalcolorFormat::NOCOLOR) {
+		INFO(80, wst("error reading dds file! unsupported block format.\n"));
+		return nullptr;
+	}
+
+	image = readCompressed(fp, dds_fhdr.dwWidth, dds_fhdr.dwHeight, tmpformat);
+	if (image) {
+		*width = dds_fhdr.dwWidth;
+		*height = dds_fhdr.dwHeight;
+		*format = tmpformat;
+	}
+
+#ifdef DEBUG
+	if (!image) {
+		DBG_INFO(80, wst("Error: failed to load dds image!\n"));
+	}
+#endif
+
+	return image;
+}
+
+uint8*
+TxImage::readKTX(FILE* fp, int* width, int* height, ColorFormat *format)
+{
+	static const uint8 ktxIdentifier[12] = {
+		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+	};
+
+	/* KTX 1.1 header after identifier */
+	struct {
+		uint32 endianness;
+		uint32 glType;
+		uint32 glTypeSize;
+		uint32 glFormat;
+		uint32 glInternalFormat;
+		uint32 glBaseInternalFormat;
+		uint32 pixelWidth;
+		uint32 pixelHeight;
+		uint32 pixelDepth;
+		uint32 numberOfArrayElements;
+		uint32 numberOfFaces;
+		uint32 numberOfMipmapLevels;
+		uint32 bytesOfKeyValueData;
+	} ktx_hdr;
+
+	uint8 identifier[12];
+	uint8 *image = nullptr;
+
+	*width = 0;
+	*height = 0;
+	*format = graphics::internalcolorFormat::NOCOLOR;
+
+	if (!fp ||
+		fread(identifier, 12, 1, fp) != 1 ||
+		memcmp(identifier, ktxIdentifier, 12) != 0 ||
+		fread(&ktx_hdr, sizeof(ktx_hdr), 1, fp) != 1 ||
+		ktx_hdr.endianness != 0x04030201) {
+		INFO(80, wst("error reading ktx file! not a valid ktx file.\n"));
+		return nullptr;
+	}
+
+	const ColorFormat tmpformat(ktx_hdr.glInternalFormat);
+	if (ktx_hdr.glType != 0 || !TxUtil::isCompressedTx(tmpformat) ||
+		ktx_hdr.pixelDepth > 1 || ktx_hdr.numberOfFaces > 1 || ktx_hdr.numberOfArrayElements > 1) {
+		INFO(80, wst("error reading ktx file! only 2D compressed textures are supported.\n"));
+		return nullptr;
+	}
+
+	uint32 imageSize = 0;
+	if (fseek(fp, ktx_hdr.bytesOfKeyValueData, SEEK_CUR) != 0 ||
+		fread(&imageSize, 4, 1, fp) != 1 ||
+		imageSize != (uint32)TxUtil::sizeofTx(ktx_hdr.pixelWidth, ktx_hdr.pixelHeight, tmpformat))
+		return nullptr;
+
+	image = readCompressed(fp, ktx_hdr.pixelWidth, ktx_hdr.pixelHeight, tmpformat);
+	if (image) {
+		*width = ktx_hdr.pixelWidth;
+		*height = ktx_hdr.pixelHeight;
+		*format = tmpformat;
+	}
+
+#ifdef DEBUG
+	if (!image) {
+		DBG_INFO(80, wst("Error: failed to load ktx image!\n"));
+	}
+#endif
+
+	return image;
+}
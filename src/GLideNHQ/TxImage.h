@@ -72,6 +72,12 @@ typedef struct tagBITMAPINFOHEADER BITMAPINFOHEADER;
 #define DDSCAPS_TEXTURE	0x00001000
 #define DDSCAPS_MIPMAP	0x00400000
 
+#define DXGI_FORMAT_BC1_UNORM	71
+#define DXGI_FORMAT_BC2_UNORM	74
+#define DXGI_FORMAT_BC3_UNORM	77
+#define DXGI_FORMAT_BC7_UNORM	98
+#define DXGI_FORMAT_BC7_UNORM_SRGB	99
+
 typedef struct tagDDSPIXELFORMAT {
   unsigned long dwSize;
   unsigned long dwFlags;
@@ -104,12 +110,16 @@ private:
   boolean getPNGInfo(FILE *fp, png_structp *png_ptr, png_infop *info_ptr);
   boolean getBMPInfo(FILE *fp, BITMAPFILEHEADER *bmp_fhdr, BITMAPINFOHEADER *bmp_ihdr);
   boolean getDDSInfo(FILE *fp, DDSFILEHEADER *dds_fhdr);
+  uint8* readCompressed(FILE* fp, int width, int height, ColorFormat format);
 public:
   TxImage() {}
   ~TxImage() {}
   uint8* readPNG(FILE* fp, int* width, int* height, ColorFormat* format);
-  boolean writePNG(uint8* src, FILE* fp, int width, int height, int rowStride, ColorFormat format/*, uint8 *palette*/);
+  boolean writePNG(uint8* src, FILE* fp, int width, int height, int rowStride, ColorFormat format/*, uint8 *palette*/,
+                   int compressionLevel = -1 /* zlib default */);
   uint8* readBMP(FILE* fp, int* width, int* height, ColorFormat* format);
+  uint8* readDDS(FILE* fp, int* width, int* height, ColorFormat* format);
+  uint8* readKTX(FILE* fp, int* width, int* height, ColorFormat* format);
 };
 
 #endif /* __TXIMAGE_H__ */
@@ -37,7 +37,9 @@
 
 typedef graphics::InternalColorFormatParam ColorFormat;
 
-/* in-memory zlib texture compression */
+/* in-memory texture compression, see TxCodec */
 #define GL_TEXFMT_GZ 0x80000000
+#define GL_TEXFMT_LZ4 0x40000000
+#define GL_TEXFMT_COMPRESSION_MASK (GL_TEXFMT_GZ | GL_TEXFMT_LZ4)
 
 #endif /* __INTERNAL_H__ */
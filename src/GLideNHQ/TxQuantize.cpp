@@ -30,6 +30,8 @@
 #include <functional>
 #include <thread>
 #include <assert.h>
+#include <stdlib.h>
+#include <cstring>
 
 #include "TxQuantize.h"
 
@@ -944,3 +946,158 @@ TxQuantize::quantize(uint8* src, uint8* dest, int width, int height, ColorFormat
 
 	return 1;
 }
+
+/* simple range fit block compression. good enough for offline transcoding
+ * of texture packs which only come as png. */
+static
+uint16 RGB888_RGB565(const uint8 *c)
+{
+	return (uint16)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static
+void RGB565_RGB888(uint16 c, int *rgb)
+{
+	const int r = (c >> 11) & 0x1f;
+	const int g = (c >> 5) & 0x3f;
+	const int b = c & 0x1f;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+static
+void compressColorBlock(const uint8 *block, uint8 *dest)
+{
+	uint8 minColor[3] = { 255, 255, 255 };
+	uint8 maxColor[3] = { 0, 0, 0 };
+	int i, j;
+
+	for (i = 0; i < 16; i++) {
+		for (j = 0; j < 3; j++) {
+			if (block[i * 4 + j] < minColor[j]) minColor[j] = block[i * 4 + j];
+			if (block[i * 4 + j] > maxColor[j]) maxColor[j] = block[i * 4 + j];
+		}
+	}
+
+	/* inset the bounding box to reduce the error of the end points */
+	for (j = 0; j < 3; j++) {
+		const int inset = (maxColor[j] - minColor[j]) >> 4;
+		minColor[j] = (uint8)(minColor[j] + inset);
+		maxColor[j] = (uint8)(maxColor[j] - inset);
+	}
+
+	uint16 c0 = RGB888_RGB565(maxColor);
+	uint16 c1 = RGB888_RGB565(minColor);
+	if (c0 < c1) {
+		const uint16 tmp = c0;
+		c0 = c1;
+		c1 = tmp;
+	}
+
+	uint32 indices = 0;
+	if (c0 != c1) {
+		int palette[4][3];
+		RGB565_RGB888(c0, palette[0]);
+		RGB565_RGB888(c1, palette[1]);
+		for (j = 0; j < 3; j++) {
+			palette[2][j] = (2 * palette[0][j] + palette[1][j]) / 3;
+			palette[3][j] = (palette[0][j] + 2 * palette[1][j]) / 3;
+		}
+		for (i = 0; i < 16; i++) {
+			int best = 0;
+			int bestDist = 0x7fffffff;
+			for (int k = 0; k < 4; k++) {
+				int dist = 0;
+				for (j = 0; j < 3; j++) {
+					const int d = block[i * 4 + j] - palette[k][j];
+					dist += d * d;
+				}
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = k;
+				}
+			}
+			indices |= (uint32)best << (i << 1);
+		}
+	}
+
+	dest[0] = c0 & 0xff;
+	dest[1] = c0 >> 8;
+	dest[2] = c1 & 0xff;
+	dest[3] = c1 >> 8;
+	dest[4] = indices & 0xff;
+	dest[5] = (indices >> 8) & 0xff;
+	dest[6] = (indices >> 16) & 0xff;
+	dest[7] = (indices >> 24) & 0xff;
+}
+
+static
+void compressAlphaBlock(const uint8 *block, uint8 *dest)
+{
+	int a0 = 0, a1 = 255;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		const int a = block[i * 4 + 3];
+		if (a > a0) a0 = a;
+		if (a < a1) a1 = a;
+	}
+
+	uint64 indices = 0;
+	if (a0 != a1) {
+		int palette[8];
+		palette[0] = a0;
+		palette[1] = a1;
+		for (i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		for (i = 0; i < 16; i++) {
+			const int a = block[i * 4 + 3];
+			int best = 0;
+			int bestDist = 256;
+			for (int k = 0; k < 8; k++) {
+				const int dist = abs(a - palette[k]);
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = k;
+				}
+			}
+			indices |= (uint64)best << (i * 3);
+		}
+	}
+
+	dest[0] = (uint8)a0;
+	dest[1] = (uint8)a1;
+	for (i = 0; i < 6; i++)
+		dest[2 + i] = (uint8)((indices >> (i << 3)) & 0xff);
+}
+
+boolean
+TxQuantize::compress(uint8* src, uint8* dest, int width, int height, ColorFormat destformat)
+{
+	const boolean bc3 = destformat == graphics::internalcolorFormat::COMPRESSED_RGBA_BC3;
+	if (!bc3 && destformat != graphics::internalcolorFormat::COMPRESSED_RGBA_BC1)
+		return 0;
+
+	uint8 block[64];
+	for (int y = 0; y < height; y += 4) {
+		for (int x = 0; x < width; x += 4) {
+			/* clamp to the texture edge for partial blocks */
+			for (int by = 0; by < 4; by++) {
+				const int sy = (y + by < height) ? y + by : height - 1;
+				for (int bx = 0; bx < 4; bx++) {
+					const int sx = (x + bx < width) ? x + bx : width - 1;
+					memcpy(block + ((by << 2) + bx) * 4, src + (sy * width + sx) * 4, 4);
+				}
+			}
+			if (bc3) {
+				compressAlphaBlock(block, dest);
+				dest += 8;
+			}
+			compressColorBlock(block, dest);
+			dest += 8;
+		}
+	}
+
+	return 1;
+}
@@ -63,6 +63,9 @@ public:
   void P8_16BPP(uint32* src, uint32* dst, int width, int height, uint32* palette);
 
   boolean quantize(uint8* src, uint8* dest, int width, int height, ColorFormat srcformat, ColorFormat destformat, boolean fastQuantizer = 1);
+
+  /* RGBA8888 to BC1 or BC3 blocks */
+  boolean compress(uint8* src, uint8* dest, int width, int height, ColorFormat destformat);
 };
 
 #endif /* __TXQUANTIZE_H__ */
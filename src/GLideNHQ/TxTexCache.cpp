@@ -34,7 +34,7 @@ TxTexCache::~TxTexCache()
 {
 }
 
-TxTexCache::TxTexCache(int options, int cachesize, const wchar_t *cachePath, const wchar_t *ident,
+TxTexCache::TxTexCache(int options, int cachesize, int diskcachesize, const wchar_t *cachePath, const wchar_t *ident,
 					   dispInfoFuncExt callback
 					   ) : TxCache((options & ~GZ_HIRESTEXCACHE), cachesize, cachePath, ident, callback)
 {
@@ -44,6 +44,12 @@ TxTexCache::TxTexCache(int options, int cachesize, const wchar_t *cachePath, con
 
 	_cacheDumped = 0;
 
+	if (!_ident.empty()) {
+		tx_wstring diskCacheName = _ident + wst("_MEMORYCACHE_DISK");
+		removeColon(diskCacheName);
+		initDiskCache(diskcachesize, diskCacheName);
+	}
+
 	if (_options & DUMP_TEXCACHE) {
 		/* find it on disk */
 		_cacheDumped = TxCache::load(_cachePath.c_str(), _getFileName().c_str(), _getConfig(), 0);
@@ -36,7 +36,7 @@ private:
 
 public:
   ~TxTexCache();
-  TxTexCache(int options, int cachesize, const wchar_t *cachePath, const wchar_t *ident,
+  TxTexCache(int options, int cachesize, int diskcachesize, const wchar_t *cachePath, const wchar_t *ident,
              dispInfoFuncExt callback);
   boolean add(uint64 checksum, /* checksum hi:palette low:texture */
               GHQTexInfo *info);
@@ -69,6 +69,12 @@ TxUtil::sizeofTx(int width, int height, ColorFormat format)
 		dataSize = (width * height) << 1;
 	} else if (format == graphics::internalcolorFormat::RGBA8) {
 		dataSize = (width * height) << 2;
+	} else if (format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC1) {
+		/* 8 bytes per 4x4 block */
+		dataSize = ((width + 3) >> 2) * ((height + 3) >> 2) << 3;
+	} else if (isCompressedTx(format)) {
+		/* 16 bytes per 4x4 block */
+		dataSize = ((width + 3) >> 2) * ((height + 3) >> 2) << 4;
 	} else {
 		/* unsupported format */
 		DBG_INFO(80, wst("Error: cannot get size. unsupported gfmt:%x\n"), format);
@@ -77,6 +83,33 @@ TxUtil::sizeofTx(int width, int height, ColorFormat format)
 	return dataSize;
 }
 
+boolean
+TxUtil::isCompressedTx(ColorFormat format)
+{
+	return format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC1 ||
+		   format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC2 ||
+		   format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC3 ||
+		   format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC7 ||
+		   format == graphics::internalcolorFormat::COMPRESSED_RGBA8_ETC2 ||
+		   format == graphics::internalcolorFormat::COMPRESSED_RGBA_ASTC_4x4;
+}
+
+boolean
+TxUtil::isCompressedTxSupported(ColorFormat format, int options)
+{
+	if (format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC1 ||
+		format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC2 ||
+		format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC3)
+		return (options & S3TC_HIRESTEX) != 0;
+	if (format == graphics::internalcolorFormat::COMPRESSED_RGBA_BC7)
+		return (options & BPTC_HIRESTEX) != 0;
+	if (format == graphics::internalcolorFormat::COMPRESSED_RGBA8_ETC2)
+		return (options & ETC2_HIRESTEX) != 0;
+	if (format == graphics::internalcolorFormat::COMPRESSED_RGBA_ASTC_4x4)
+		return (options & ASTC_HIRESTEX) != 0;
+	return 0;
+}
+
 uint32
 TxUtil::checksum(uint8 *src, int width, int height, int size, int rowStride)
 {
@@ -44,6 +44,8 @@ private:
 						  uint32* crc32, uint32* cimax);
 public:
 	static int sizeofTx(int width, int height, ColorFormat format);
+	static boolean isCompressedTx(ColorFormat format);
+	static boolean isCompressedTxSupported(ColorFormat format, int options);
 	static uint32 checksumTx(uint8 *data, int width, int height, ColorFormat format);
 #if 0 /* unused */
 	static uint32 chkAlpha(uint32* src, int width, int height);
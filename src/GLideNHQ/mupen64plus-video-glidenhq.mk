@@ -23,7 +23,10 @@ LOCAL_SRC_FILES :=                          \
     $(SRCDIR)/TextureFilters_hq4x.cpp       \
     $(SRCDIR)/TextureFilters_xbrz.cpp       \
     $(SRCDIR)/TxCache.cpp                   \
+    $(SRCDIR)/TxCodec.cpp                   \
     $(SRCDIR)/TxDbg.cpp                     \
+    $(SRCDIR)/TxDiskCache.cpp               \
+    $(SRCDIR)/TxDumpQueue.cpp               \
     $(SRCDIR)/TxFilter.cpp                  \
     $(SRCDIR)/TxFilterExport.cpp            \
     $(SRCDIR)/TxHiResCache.cpp              \
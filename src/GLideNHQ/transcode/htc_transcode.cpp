@@ -0,0 +1,94 @@
+/* Encodes the RGBA8 textures of a hires texture cache to BC1, or BC3 if
+ * they have alpha, and rewrites the cache. The plugin then uploads them
+ * as they are, without the RGBA8 upload. The cache keeps its config, so
+ * the plugin loads it with the same settings as before.
+ * Usage: htc_transcode <cache path>/<ROM name>_HIRESTEXTURES.htc */
+
+#include "../TxHiResCache.h"
+#include <zlib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string>
+
+static const char cacheSuffix[] = "_HIRESTEXTURES.htc";
+
+static
+void displayProgress(const wchar_t *format, ...)
+{
+	wchar_t wbuf[INFO_BUF];
+	char buf[INFO_BUF];
+
+	va_list args;
+	va_start(args, format);
+	vswprintf(wbuf, INFO_BUF, format, args);
+	va_end(args);
+
+	wcstombs(buf, wbuf, INFO_BUF);
+	printf("%s", buf);
+}
+
+/* the config the cache was written with, see TxCache::load */
+static
+boolean readConfig(const char *file, int *config)
+{
+	gzFile gzfp = gzopen(file, "rb");
+	if (gzfp == nullptr)
+		return 0;
+
+	int header[3] = { 0, 0, 0 };
+	boolean res = gzread(gzfp, &header[0], 4) == 4;
+	if (res && header[0] == TXCACHE_TAG) {
+		res = gzread(gzfp, &header[1], 8) == 8 && header[1] <= TXCACHE_VERSION;
+		*config = header[2];
+	} else
+		*config = header[0];
+	gzclose(gzfp);
+	return res;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2) {
+		printf("Usage: %s <cache path>/<ROM name>%s\n", argv[0], cacheSuffix);
+		return 2;
+	}
+
+	const std::string file(argv[1]);
+	const size_t nameStart = file.find_last_of("/\\") + 1;
+	const size_t suffixLen = sizeof(cacheSuffix) - 1;
+	if (file.size() < nameStart + suffixLen + 1 || file.compare(file.size() - suffixLen, suffixLen, cacheSuffix) != 0) {
+		printf("%s is not a hires texture cache\n", argv[1]);
+		return 2;
+	}
+
+	int config = 0;
+	if (!readConfig(file.c_str(), &config)) {
+		printf("Cannot read %s\n", argv[1]);
+		return 2;
+	}
+
+	wchar_t path[MAX_PATH];
+	wchar_t ident[MAX_PATH];
+	const std::string dir = nameStart == 0 ? std::string(".") : file.substr(0, nameStart - 1);
+	mbstowcs(path, dir.c_str(), MAX_PATH);
+	mbstowcs(ident, file.substr(nameStart, file.size() - nameStart - suffixLen).c_str(), MAX_PATH);
+
+	/* buffers for the zlib and lz4 codecs, as the plugin allocates them */
+	if (!TxMemBuf::getInstance()->init(4096, 4096)) {
+		printf("Out of memory\n");
+		return 2;
+	}
+
+	/* no texture pack path: the cache is loaded whatever the pack settings are */
+	TxHiResCache cache(4096, 4096, 32, config | DUMP_HIRESTEXCACHE | S3TC_HIRESTEX, 0, 0,
+					   path, nullptr, ident, displayProgress);
+	if (cache.empty()) {
+		printf("%s has no textures\n", argv[1]);
+		return 2;
+	}
+
+	const boolean res = cache.transcode();
+	printf("%s %s\n", argv[1], res ? "transcoded" : "not written");
+	return res ? 0 : 1;
+}
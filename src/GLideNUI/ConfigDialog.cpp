@@ -486,7 +486,10 @@ void ConfigDialog::accept()
 	config.textureFilter.txHresAltCRC = ui->alternativeCRCCheckBox->isChecked() ? 1 : 0;
 	config.textureFilter.txDump = ui->textureDumpCheckBox->isChecked() ? 1 : 0;
 
-	config.textureFilter.txCacheCompression = ui->compressCacheCheckBox->isChecked() ? 1 : 0;
+	if (!ui->compressCacheCheckBox->isChecked())
+		config.textureFilter.txCacheCompression = Config::tccNone;
+	else if (config.textureFilter.txCacheCompression == Config::tccNone)
+		config.textureFilter.txCacheCompression = Config::tccLZ4;
 	config.textureFilter.txForce16bpp = ui->force16bppCheckBox->isChecked() ? 1 : 0;
 	config.textureFilter.txSaveCache = ui->saveTextureCacheCheckBox->isChecked() ? 1 : 0;
 
@@ -58,6 +58,7 @@ void _loadSettings(QSettings & settings)
 	config.frameBufferEmulation.copyToRDRAM = settings.value("copyToRDRAM", config.frameBufferEmulation.copyToRDRAM).toInt();
 	config.frameBufferEmulation.copyDepthToRDRAM = settings.value("copyDepthToRDRAM", config.frameBufferEmulation.copyDepthToRDRAM).toInt();
 	config.frameBufferEmulation.copyFromRDRAM = settings.value("copyFromRDRAM", config.frameBufferEmulation.copyFromRDRAM).toInt();
+	config.frameBufferEmulation.hashedValidityCheck = settings.value("hashedValidityCheck", config.frameBufferEmulation.hashedValidityCheck).toInt();
 	config.frameBufferEmulation.fbInfoDisabled = settings.value("fbInfoDisabled", config.frameBufferEmulation.fbInfoDisabled).toInt();
 	config.frameBufferEmulation.fbInfoReadColorChunk = settings.value("fbInfoReadColorChunk", config.frameBufferEmulation.fbInfoReadColorChunk).toInt();
 	config.frameBufferEmulation.fbInfoReadDepthChunk = settings.value("fbInfoReadDepthChunk", config.frameBufferEmulation.fbInfoReadDepthChunk).toInt();
@@ -78,10 +79,13 @@ void _loadSettings(QSettings & settings)
 	config.textureFilter.txDeposterize = settings.value("txDeposterize", config.textureFilter.txDeposterize).toInt();
 	config.textureFilter.txFilterIgnoreBG = settings.value("txFilterIgnoreBG", config.textureFilter.txFilterIgnoreBG).toInt();
 	config.textureFilter.txCacheSize = settings.value("txCacheSize", config.textureFilter.txCacheSize).toInt();
+	config.textureFilter.txHiresCacheSize = settings.value("txHiresCacheSize", config.textureFilter.txHiresCacheSize).toInt();
+	config.textureFilter.txDiskCacheSize = settings.value("txDiskCacheSize", config.textureFilter.txDiskCacheSize).toInt();
 	config.textureFilter.txHiresEnable = settings.value("txHiresEnable", config.textureFilter.txHiresEnable).toInt();
 	config.textureFilter.txHiresFullAlphaChannel = settings.value("txHiresFullAlphaChannel", config.textureFilter.txHiresFullAlphaChannel).toInt();
 	config.textureFilter.txHresAltCRC = settings.value("txHresAltCRC", config.textureFilter.txHresAltCRC).toInt();
 	config.textureFilter.txDump = settings.value("txDump", config.textureFilter.txDump).toInt();
+	config.textureFilter.txDumpCompressionLevel = settings.value("txDumpCompressionLevel", config.textureFilter.txDumpCompressionLevel).toInt();
 	config.textureFilter.txForce16bpp = settings.value("txForce16bpp", config.textureFilter.txForce16bpp).toInt();
 	config.textureFilter.txCacheCompression = settings.value("txCacheCompression", config.textureFilter.txCacheCompression).toInt();
 	config.textureFilter.txSaveCache = settings.value("txSaveCache", config.textureFilter.txSaveCache).toInt();
@@ -124,6 +128,8 @@ void _loadSettings(QSettings & settings)
 
 	settings.beginGroup("debug");
 	config.debug.dumpMode = settings.value("dumpMode", config.debug.dumpMode).toInt();
+	config.debug.gbiTrace = settings.value("gbiTrace", config.debug.gbiTrace).toInt();
+	config.debug.captureFrames = settings.value("captureFrames", config.debug.captureFrames).toInt();
 	settings.endGroup();
 }
 
@@ -219,6 +225,7 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("forceDepthBufferClear", config.frameBufferEmulation.forceDepthBufferClear);
 	settings.setValue("copyAuxToRDRAM", config.frameBufferEmulation.copyAuxToRDRAM);
 	settings.setValue("copyFromRDRAM", config.frameBufferEmulation.copyFromRDRAM);
+	settings.setValue("hashedValidityCheck", config.frameBufferEmulation.hashedValidityCheck);
 	settings.setValue("copyToRDRAM", config.frameBufferEmulation.copyToRDRAM);
 	settings.setValue("copyDepthToRDRAM", config.frameBufferEmulation.copyDepthToRDRAM);
 	settings.setValue("fbInfoDisabled", config.frameBufferEmulation.fbInfoDisabled);
@@ -241,10 +248,13 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("txDeposterize", config.textureFilter.txDeposterize);
 	settings.setValue("txFilterIgnoreBG", config.textureFilter.txFilterIgnoreBG);
 	settings.setValue("txCacheSize", config.textureFilter.txCacheSize);
+	settings.setValue("txHiresCacheSize", config.textureFilter.txHiresCacheSize);
+	settings.setValue("txDiskCacheSize", config.textureFilter.txDiskCacheSize);
 	settings.setValue("txHiresEnable", config.textureFilter.txHiresEnable);
 	settings.setValue("txHiresFullAlphaChannel", config.textureFilter.txHiresFullAlphaChannel);
 	settings.setValue("txHresAltCRC", config.textureFilter.txHresAltCRC);
 	settings.setValue("txDump", config.textureFilter.txDump);
+	settings.setValue("txDumpCompressionLevel", config.textureFilter.txDumpCompressionLevel);
 	settings.setValue("txForce16bpp", config.textureFilter.txForce16bpp);
 	settings.setValue("txCacheCompression", config.textureFilter.txCacheCompression);
 	settings.setValue("txSaveCache", config.textureFilter.txSaveCache);
@@ -275,6 +285,8 @@ void writeSettings(const QString & _strIniFolder)
 
 	settings.beginGroup("debug");
 	settings.setValue("dumpMode", config.debug.dumpMode);
+	settings.setValue("gbiTrace", config.debug.gbiTrace);
+	settings.setValue("captureFrames", config.debug.captureFrames);
 	settings.endGroup();
 
 	settings.endGroup();
@@ -400,6 +412,7 @@ void saveCustomRomSettings(const QString & _strIniFolder, const char * _strRomNa
 	WriteCustomSetting(frameBufferEmulation, forceDepthBufferClear);
 	WriteCustomSetting(frameBufferEmulation, copyAuxToRDRAM);
 	WriteCustomSetting(frameBufferEmulation, copyFromRDRAM);
+	WriteCustomSetting(frameBufferEmulation, hashedValidityCheck);
 	WriteCustomSetting(frameBufferEmulation, copyToRDRAM);
 	WriteCustomSetting(frameBufferEmulation, copyDepthToRDRAM);
 	WriteCustomSetting(frameBufferEmulation, fbInfoDisabled);
@@ -422,10 +435,13 @@ void saveCustomRomSettings(const QString & _strIniFolder, const char * _strRomNa
 	WriteCustomSetting(textureFilter, txDeposterize);
 	WriteCustomSetting(textureFilter, txFilterIgnoreBG);
 	WriteCustomSetting(textureFilter, txCacheSize);
+	WriteCustomSetting(textureFilter, txHiresCacheSize);
+	WriteCustomSetting(textureFilter, txDiskCacheSize);
 	WriteCustomSetting(textureFilter, txHiresEnable);
 	WriteCustomSetting(textureFilter, txHiresFullAlphaChannel);
 	WriteCustomSetting(textureFilter, txHresAltCRC);
 	WriteCustomSetting(textureFilter, txDump);
+	WriteCustomSetting(textureFilter, txDumpCompressionLevel);
 	WriteCustomSetting(textureFilter, txForce16bpp);
 	WriteCustomSetting(textureFilter, txCacheCompression);
 	WriteCustomSetting(textureFilter, txSaveCache);
@@ -94,4 +94,27 @@ namespace graphics {
 												params.colorFormatBytes);
 		}
 	}
+
+	const u8 * ColorBufferReader::readRawPixels(s32 _x0, s32 _y0, u32 _width, u32 _height, bool _sync, u32 & _rowBytes)
+	{
+		ReadColorBufferParams params;
+		params.x0 = _x0;
+		params.y0 = _y0;
+		params.width = _width;
+		params.height = _height;
+		params.sync = _sync;
+		params.colorFormat = colorFormat::RGBA;
+		params.colorType = datatype::UNSIGNED_BYTE;
+		params.colorFormatBytes = 4;
+
+		u32 heightOffset = 0;
+		u32 stride = 0;
+		const u8* pixelData = _readPixels(params, heightOffset, stride);
+
+		if (pixelData == nullptr)
+			return nullptr;
+
+		_rowBytes = stride * params.colorFormatBytes;
+		return pixelData + heightOffset * _rowBytes;
+	}
 }
\ No newline at end of file
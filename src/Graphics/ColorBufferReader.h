@@ -12,6 +12,9 @@ public:
 	virtual ~ColorBufferReader() = default;
 
 	virtual const u8 * readPixels(s32 _x0, s32 _y0, u32 _width, u32 _height, u32 _size, bool _sync);
+	// Reads RGBA8 texels without conversion. Result may point right to mapped GPU memory,
+	// which stays valid until cleanUp(). _rowBytes receives the distance between rows.
+	const u8 * readRawPixels(s32 _x0, s32 _y0, u32 _width, u32 _height, bool _sync, u32 & _rowBytes);
 	virtual void cleanUp() = 0;
 
 protected:
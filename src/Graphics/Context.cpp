@@ -15,6 +15,10 @@ bool Context::IntegerTextures = false;
 bool Context::ClipControl = false;
 bool Context::FramebufferFetch = false;
 bool Context::TextureBarrier = false;
+bool Context::TextureCompressionS3TC = false;
+bool Context::TextureCompressionBPTC = false;
+bool Context::TextureCompressionETC2 = false;
+bool Context::TextureCompressionASTC = false;
 
 Context::Context() {}
 
@@ -38,6 +42,10 @@ void Context::init()
 	ClipControl = m_impl->isSupported(SpecialFeatures::ClipControl);
 	FramebufferFetch = m_impl->isSupported(SpecialFeatures::FramebufferFetch);
 	TextureBarrier = m_impl->isSupported(SpecialFeatures::TextureBarrier);
+	TextureCompressionS3TC = m_impl->isSupported(SpecialFeatures::TextureCompressionS3TC);
+	TextureCompressionBPTC = m_impl->isSupported(SpecialFeatures::TextureCompressionBPTC);
+	TextureCompressionETC2 = m_impl->isSupported(SpecialFeatures::TextureCompressionETC2);
+	TextureCompressionASTC = m_impl->isSupported(SpecialFeatures::TextureCompressionASTC);
 }
 
 void Context::destroy()
@@ -116,6 +124,16 @@ void Context::setPolygonOffset(f32 _factor, f32 _units)
 	m_impl->setPolygonOffset(_factor, _units);
 }
 
+Context::RenderStateStatistics Context::getRenderStateStatistics() const
+{
+	return m_impl->getRenderStateStatistics();
+}
+
+void Context::resetRenderStateStatistics()
+{
+	m_impl->resetRenderStateStatistics();
+}
+
 ObjectHandle Context::createTexture(Parameter _target)
 {
 	return m_impl->createTexture(_target);
@@ -136,6 +154,11 @@ void Context::update2DTexture(const UpdateTextureDataParams & _params)
 	m_impl->update2DTexture(_params);
 }
 
+void Context::init2DCompressedTexture(const InitCompressedTextureParams & _params)
+{
+	m_impl->init2DCompressedTexture(_params);
+}
+
 void Context::setTextureParameters(const TexParameters & _parameters)
 {
 	m_impl->setTextureParameters(_parameters);
@@ -228,6 +251,11 @@ PixelReadBuffer * Context::createPixelReadBuffer(size_t _sizeInBytes)
 	return m_impl->createPixelReadBuffer(_sizeInBytes);
 }
 
+PixelWriteBuffer * Context::createPixelWriteBuffer(size_t _sizeInBytes)
+{
+	return m_impl->createPixelWriteBuffer(_sizeInBytes);
+}
+
 ColorBufferReader * Context::createColorBufferReader(CachedTexture * _pTexture)
 {
 	return m_impl->createColorBufferReader(_pTexture);
@@ -301,6 +329,16 @@ TextDrawerShaderProgram * Context::createTextDrawerShader()
 	return m_impl->createTextDrawerShader();
 }
 
+BufferPackShaderProgram * Context::createColorBufferPackShader()
+{
+	return m_impl->createColorBufferPackShader();
+}
+
+BufferPackShaderProgram * Context::createDepthBufferPackShader()
+{
+	return m_impl->createDepthBufferPackShader();
+}
+
 void Context::resetShaderProgram()
 {
 	m_impl->resetShaderProgram();
@@ -25,7 +25,11 @@ namespace graphics {
 		IntegerTextures,
 		ClipControl,
 		FramebufferFetch,
-		TextureBarrier
+		TextureBarrier,
+		TextureCompressionS3TC,
+		TextureCompressionBPTC,
+		TextureCompressionETC2,
+		TextureCompressionASTC
 	};
 
 	enum class ClampMode {
@@ -75,6 +79,19 @@ namespace graphics {
 
 		void setPolygonOffset(f32 _factor, f32 _units);
 
+		// Render state and texture parameter changes since the last reset,
+		// split into the GL calls made for them and the redundant ones which were dropped.
+		struct RenderStateStatistics {
+			u32 stateCalls = 0;
+			u32 stateElided = 0;
+			u32 texParamsCalls = 0;
+			u32 texParamsElided = 0;
+		};
+
+		RenderStateStatistics getRenderStateStatistics() const;
+
+		void resetRenderStateStatistics();
+
 		/*---------------Texture-------------*/
 
 		ObjectHandle createTexture(Parameter _target);
@@ -113,6 +130,19 @@ namespace graphics {
 
 		void update2DTexture(const UpdateTextureDataParams & _params);
 
+		struct InitCompressedTextureParams {
+			ObjectHandle handle;
+			TextureUnitParam textureUnitIndex{0};
+			u32 width = 0;
+			u32 height = 0;
+			u32 mipMapLevel = 0;
+			InternalColorFormatParam internalFormat;
+			u32 dataSize = 0;
+			const void * data = nullptr;
+		};
+
+		void init2DCompressedTexture(const InitCompressedTextureParams & _params);
+
 		struct TexParameters {
 			ObjectHandle handle;
 			TextureUnitParam textureUnitIndex{0};
@@ -200,6 +230,8 @@ namespace graphics {
 			s32 dstY1;
 			Parameter mask;
 			Parameter filter;
+			// Blit to exactly these coordinates, without the Adreno coordinate fix
+			bool exactCoords = false;
 		};
 
 		bool blitFramebuffers(const BlitFramebuffersParams & _params);
@@ -210,6 +242,8 @@ namespace graphics {
 
 		PixelReadBuffer * createPixelReadBuffer(size_t _sizeInBytes);
 
+		PixelWriteBuffer * createPixelWriteBuffer(size_t _sizeInBytes);
+
 		ColorBufferReader * createColorBufferReader(CachedTexture * _pTexture);
 
 		/*---------------Shaders-------------*/
@@ -240,6 +274,10 @@ namespace graphics {
 
 		TextDrawerShaderProgram * createTextDrawerShader();
 
+		BufferPackShaderProgram * createColorBufferPackShader();
+
+		BufferPackShaderProgram * createDepthBufferPackShader();
+
 		void resetShaderProgram();
 
 		/*---------------Draw-------------*/
@@ -289,6 +327,10 @@ namespace graphics {
 		static bool ClipControl;
 		static bool FramebufferFetch;
 		static bool TextureBarrier;
+		static bool TextureCompressionS3TC;
+		static bool TextureCompressionBPTC;
+		static bool TextureCompressionETC2;
+		static bool TextureCompressionASTC;
 
 	private:
 		std::unique_ptr<ContextImpl> m_impl;
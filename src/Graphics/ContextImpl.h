@@ -26,10 +26,13 @@ namespace graphics {
 		virtual void clearColorBuffer(f32 _red, f32 _green, f32 _blue, f32 _alpha) = 0;
 		virtual void clearDepthBuffer() = 0;
 		virtual void setPolygonOffset(f32 _factor, f32 _units) = 0;
+		virtual Context::RenderStateStatistics getRenderStateStatistics() const = 0;
+		virtual void resetRenderStateStatistics() = 0;
 		virtual ObjectHandle createTexture(Parameter _target) = 0;
 		virtual void deleteTexture(ObjectHandle _name) = 0;
 		virtual void init2DTexture(const Context::InitTextureParams & _params) = 0;
 		virtual void update2DTexture(const Context::UpdateTextureDataParams & _params) = 0;
+		virtual void init2DCompressedTexture(const Context::InitCompressedTextureParams & _params) = 0;
 		virtual void setTextureParameters(const Context::TexParameters & _parameters) = 0;
 		virtual void bindTexture(const Context::BindTextureParameters & _params) = 0;
 		virtual void setTextureUnpackAlignment(s32 _param) = 0;
@@ -48,6 +51,7 @@ namespace graphics {
 		virtual bool blitFramebuffers(const Context::BlitFramebuffersParams & _params) = 0;
 		virtual void setDrawBuffers(u32 _num) = 0;
 		virtual PixelReadBuffer * createPixelReadBuffer(size_t _sizeInBytes) = 0;
+		virtual PixelWriteBuffer * createPixelWriteBuffer(size_t _sizeInBytes) = 0;
 		virtual ColorBufferReader * createColorBufferReader(CachedTexture * _pTexture) = 0;
 		virtual bool isCombinerProgramBuilderObsolete() = 0;
 		virtual void resetCombinerProgramBuilder() = 0;
@@ -62,6 +66,8 @@ namespace graphics {
 		virtual ShaderProgram * createOrientationCorrectionShader() = 0;
 		virtual ShaderProgram * createFXAAShader() = 0;
 		virtual TextDrawerShaderProgram * createTextDrawerShader() = 0;
+		virtual BufferPackShaderProgram * createColorBufferPackShader() = 0;
+		virtual BufferPackShaderProgram * createDepthBufferPackShader() = 0;
 		virtual void resetShaderProgram() = 0;
 		virtual void drawTriangles(const Context::DrawTriangleParameters & _params) = 0;
 		virtual void drawRects(const Context::DrawRectParameters & _params) = 0;
@@ -172,6 +172,7 @@ PFNGLGETACTIVEUNIFORMBLOCKIVPROC g_glGetActiveUniformBlockiv;
 PFNGLGETUNIFORMINDICESPROC g_glGetUniformIndices;
 PFNGLGETACTIVEUNIFORMSIVPROC g_glGetActiveUniformsiv;
 PFNGLBINDBUFFERBASEPROC g_glBindBufferBase;
+PFNGLBINDBUFFERRANGEPROC g_glBindBufferRange;
 PFNGLBUFFERSUBDATAPROC g_glBufferSubData;
 
 PFNGLGETPROGRAMBINARYPROC g_glGetProgramBinary;
@@ -179,6 +180,7 @@ PFNGLPROGRAMBINARYPROC g_glProgramBinary;
 PFNGLPROGRAMPARAMETERIPROC g_glProgramParameteri;
 
 PFNGLTEXSTORAGE2DPROC g_glTexStorage2D;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC g_glCompressedTexImage2D;
 PFNGLTEXTURESTORAGE2DPROC g_glTextureStorage2D;
 PFNGLTEXTURESUBIMAGE2DPROC g_glTextureSubImage2D;
 PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC g_glTextureStorage2DMultisample;
@@ -316,6 +318,7 @@ void initGLFunctions()
 	GL_GET_PROC_ADR(PFNGLGETUNIFORMINDICESPROC, glGetUniformIndices);
 	GL_GET_PROC_ADR(PFNGLGETACTIVEUNIFORMSIVPROC, glGetActiveUniformsiv);
 	GL_GET_PROC_ADR(PFNGLBINDBUFFERBASEPROC, glBindBufferBase);
+	GL_GET_PROC_ADR(PFNGLBINDBUFFERRANGEPROC, glBindBufferRange);
 	GL_GET_PROC_ADR(PFNGLBUFFERSUBDATAPROC, glBufferSubData);
 
 	GL_GET_PROC_ADR(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary);
@@ -323,6 +326,7 @@ void initGLFunctions()
 	GL_GET_PROC_ADR(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri);
 
 	GL_GET_PROC_ADR(PFNGLTEXSTORAGE2DPROC, glTexStorage2D);
+	GL_GET_PROC_ADR(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESTORAGE2DPROC, glTextureStorage2D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESUBIMAGE2DPROC, glTextureSubImage2D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC, glTextureStorage2DMultisample);
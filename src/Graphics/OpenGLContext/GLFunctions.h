@@ -196,6 +196,7 @@ extern PFNGLBLENDCOLORPROC g_glBlendColor;
 #define glGetUniformIndices(...) CHECKED_GL_FUNCTION(g_glGetUniformIndices, __VA_ARGS__)
 #define glGetActiveUniformsiv(...) CHECKED_GL_FUNCTION(g_glGetActiveUniformsiv, __VA_ARGS__)
 #define glBindBufferBase(...) CHECKED_GL_FUNCTION(g_glBindBufferBase, __VA_ARGS__)
+#define glBindBufferRange(...) CHECKED_GL_FUNCTION(g_glBindBufferRange, __VA_ARGS__)
 #define glBufferSubData(...) CHECKED_GL_FUNCTION(g_glBufferSubData, __VA_ARGS__)
 
 #define glGetProgramBinary(...) CHECKED_GL_FUNCTION(g_glGetProgramBinary, __VA_ARGS__)
@@ -203,6 +204,7 @@ extern PFNGLBLENDCOLORPROC g_glBlendColor;
 #define glProgramParameteri(...) CHECKED_GL_FUNCTION(g_glProgramParameteri, __VA_ARGS__)
 
 #define glTexStorage2D(...) CHECKED_GL_FUNCTION(g_glTexStorage2D, __VA_ARGS__)
+#define glCompressedTexImage2D(...) CHECKED_GL_FUNCTION(g_glCompressedTexImage2D, __VA_ARGS__)
 #define glTextureStorage2D(...) CHECKED_GL_FUNCTION(g_glTextureStorage2D, __VA_ARGS__)
 #define glTextureSubImage2D(...) CHECKED_GL_FUNCTION(g_glTextureSubImage2D, __VA_ARGS__)
 #define glTextureStorage2DMultisample(...) CHECKED_GL_FUNCTION(g_glTextureStorage2DMultisample, __VA_ARGS__)
@@ -295,6 +297,7 @@ extern PFNGLGETACTIVEUNIFORMBLOCKIVPROC g_glGetActiveUniformBlockiv;
 extern PFNGLGETUNIFORMINDICESPROC g_glGetUniformIndices;
 extern PFNGLGETACTIVEUNIFORMSIVPROC g_glGetActiveUniformsiv;
 extern PFNGLBINDBUFFERBASEPROC g_glBindBufferBase;
+extern PFNGLBINDBUFFERRANGEPROC g_glBindBufferRange;
 extern PFNGLBUFFERSUBDATAPROC g_glBufferSubData;
 
 extern PFNGLGETPROGRAMBINARYPROC g_glGetProgramBinary;
@@ -302,6 +305,7 @@ extern PFNGLPROGRAMBINARYPROC g_glProgramBinary;
 extern PFNGLPROGRAMPARAMETERIPROC g_glProgramParameteri;
 
 extern PFNGLTEXSTORAGE2DPROC g_glTexStorage2D;
+extern PFNGLCOMPRESSEDTEXIMAGE2DPROC g_glCompressedTexImage2D;
 extern PFNGLTEXTURESTORAGE2DPROC g_glTextureStorage2D;
 extern PFNGLTEXTURESUBIMAGE2DPROC g_glTextureSubImage2D;
 extern PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC g_glTextureStorage2DMultisample;
@@ -7,6 +7,7 @@
 #include "glsl_CombinerProgramImpl.h"
 #include "glsl_CombinerProgramBuilder.h"
 #include "glsl_CombinerProgramUniformFactory.h"
+#include "glsl_CombinerUniformBlocks.h"
 
 using namespace glsl;
 
@@ -249,7 +250,8 @@ class VertexShaderTexturedTriangle : public ShaderPart
 public:
 	VertexShaderTexturedTriangle(const opengl::GLInfo & _glinfo)
 	{
-		m_part =
+		m_part = CombinerUniformBlocks::getDeclarations(_glinfo);
+		m_part +=
 			"IN highp vec4 aPosition;							\n"
 			"IN lowp vec4 aColor;								\n"
 			"IN highp vec2 aTexCoord;							\n"
@@ -258,11 +260,6 @@ public:
 			"													\n"
 			"uniform int uTexturePersp;							\n"
 			"													\n"
-			"uniform lowp int uFogUsage;						\n"
-			"uniform mediump vec2 uFogScale;					\n"
-			"uniform mediump vec2 uScreenCoordsScale;			\n"
-			"													\n"
-			"uniform mediump vec2 uTexScale;					\n"
 			"uniform mediump vec2 uTexOffset[2];				\n"
 			"uniform mediump vec2 uCacheScale[2];				\n"
 			"uniform mediump vec2 uCacheOffset[2];				\n"
@@ -324,16 +321,13 @@ class VertexShaderTriangle : public ShaderPart
 public:
 	VertexShaderTriangle(const opengl::GLInfo & _glinfo)
 	{
-		m_part =
+		m_part = CombinerUniformBlocks::getDeclarations(_glinfo);
+		m_part +=
 			"IN highp vec4 aPosition;			\n"
 			"IN lowp vec4 aColor;				\n"
 			"IN lowp float aNumLights;			\n"
 			"IN highp vec4 aModify;				\n"
 			"									\n"
-			"uniform lowp int uFogUsage;		\n"
-			"uniform mediump vec2 uFogScale;	\n"
-			"uniform mediump vec2 uScreenCoordsScale;\n"
-			"									\n"
 			"OUT lowp vec4 vShadeColor;			\n"
 			"OUT lowp float vNumLights;			\n"
 			"																\n"
@@ -727,18 +721,10 @@ class ShaderFragmentGlobalVariablesTex : public ShaderPart
 public:
 	ShaderFragmentGlobalVariablesTex(const opengl::GLInfo & _glinfo)
 	{
-		m_part =
+		m_part = CombinerUniformBlocks::getDeclarations(_glinfo);
+		m_part +=
 			"uniform sampler2D uTex0;		\n"
 			"uniform sampler2D uTex1;		\n"
-			"uniform lowp vec4 uFogColor;	\n"
-			"uniform lowp vec4 uCenterColor;\n"
-			"uniform lowp vec4 uScaleColor;	\n"
-			"uniform lowp vec4 uBlendColor;	\n"
-			"uniform lowp vec4 uEnvColor;	\n"
-			"uniform lowp vec4 uPrimColor;	\n"
-			"uniform lowp float uPrimLod;	\n"
-			"uniform lowp float uK4;		\n"
-			"uniform lowp float uK5;		\n"
 			"uniform lowp int uAlphaCompareMode;	\n"
 			"uniform lowp ivec2 uFbMonochrome;		\n"
 			"uniform lowp ivec2 uFbFixedAlpha;		\n"
@@ -748,8 +734,6 @@ public:
 			"uniform lowp float uAlphaTestValue;	\n"
 			"uniform lowp int uDepthSource;			\n"
 			"uniform highp float uPrimDepth;		\n"
-			"uniform mediump vec2 uScreenScale;		\n"
-			"uniform lowp int uFogUsage;			\n"
 			;
 
 		if (config.generalEmulation.enableLegacyBlending == 0) {
@@ -813,16 +797,8 @@ class ShaderFragmentGlobalVariablesNotex : public ShaderPart
 public:
 	ShaderFragmentGlobalVariablesNotex(const opengl::GLInfo & _glinfo)
 	{
-		m_part =
-			"uniform lowp vec4 uFogColor;	\n"
-			"uniform lowp vec4 uCenterColor;\n"
-			"uniform lowp vec4 uScaleColor;	\n"
-			"uniform lowp vec4 uBlendColor;	\n"
-			"uniform lowp vec4 uEnvColor;	\n"
-			"uniform lowp vec4 uPrimColor;	\n"
-			"uniform lowp float uPrimLod;	\n"
-			"uniform lowp float uK4;		\n"
-			"uniform lowp float uK5;		\n"
+		m_part = CombinerUniformBlocks::getDeclarations(_glinfo);
+		m_part +=
 			"uniform lowp int uAlphaCompareMode;	\n"
 			"uniform lowp ivec2 uFbMonochrome;		\n"
 			"uniform lowp ivec2 uFbFixedAlpha;		\n"
@@ -832,14 +808,9 @@ public:
 			"uniform lowp float uAlphaTestValue;	\n"
 			"uniform lowp int uDepthSource;			\n"
 			"uniform highp float uPrimDepth;		\n"
-			"uniform mediump vec2 uScreenScale;		\n"
 			;
 
-		if (config.generalEmulation.enableLegacyBlending != 0) {
-			m_part +=
-				"uniform lowp int uFogUsage;		\n"
-				;
-		} else {
+		if (config.generalEmulation.enableLegacyBlending == 0) {
 			m_part +=
 				"uniform lowp ivec4 uBlendMux1;		\n"
 				"uniform lowp int uForceBlendCycle1;\n"
@@ -2380,7 +2351,8 @@ GLuint _createVertexShader(ShaderPart * _header, ShaderPart * _body, ShaderPart
 	return shader_object;
 }
 
-CombinerProgramBuilder::CombinerProgramBuilder(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram)
+CombinerProgramBuilder::CombinerProgramBuilder(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram,
+											   CombinerUniformBlocks * _uniformBlocks)
 : m_blender1(new ShaderBlender1)
 , m_blender2(new ShaderBlender2)
 , m_legacyBlender(new ShaderLegacyBlender)
@@ -2435,7 +2407,7 @@ CombinerProgramBuilder::CombinerProgramBuilder(const opengl::GLInfo & _glinfo, o
 	m_vertexShaderTriangle = _createVertexShader(m_vertexHeader.get(), m_vertexTriangle.get(), m_vertexEnd.get());
 	m_vertexShaderTexturedRect = _createVertexShader(m_vertexHeader.get(), m_vertexTexturedRect.get(), m_vertexEnd.get());
 	m_vertexShaderTexturedTriangle = _createVertexShader(m_vertexHeader.get(), m_vertexTexturedTriangle.get(), m_vertexEnd.get());
-	m_uniformFactory.reset(new CombinerProgramUniformFactory(_glinfo));
+	m_uniformFactory.reset(new CombinerProgramUniformFactory(_glinfo, _uniformBlocks));
 }
 
 CombinerProgramBuilder::~CombinerProgramBuilder()
@@ -16,11 +16,13 @@ namespace glsl {
 	class ShaderPart;
 	class CombinerInputs;
 	class CombinerProgramUniformFactory;
+	class CombinerUniformBlocks;
 
 	class CombinerProgramBuilder
 	{
 	public:
-		CombinerProgramBuilder(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram);
+		CombinerProgramBuilder(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram,
+			CombinerUniformBlocks * _uniformBlocks);
 		~CombinerProgramBuilder();
 
 		graphics::CombinerProgram * buildCombinerProgram(Combiner & _color, Combiner & _alpha, const CombinerKey & _key);
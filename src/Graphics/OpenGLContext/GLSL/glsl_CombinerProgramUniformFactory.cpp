@@ -1,5 +1,6 @@
 #include <Config.h>
 #include "glsl_CombinerProgramUniformFactory.h"
+#include "glsl_CombinerUniformBlocks.h"
 #include <Graphics/Parameters.h>
 #include <Graphics/Context.h>
 
@@ -928,6 +929,68 @@ private:
 };
 
 
+class UUniformBlocks : public UniformGroup
+{
+public:
+	UUniformBlocks(GLuint _program, CombinerUniformBlocks * _blocks)
+	: m_blocks(_blocks)
+	{
+		m_blocks->bindProgram(_program);
+	}
+
+	// The blocks are shared by all programs, so _force is not needed
+	void update(bool _force) override
+	{
+		CombinerUniformBlocks::TargetBlock & target = m_blocks->getTargetBlock();
+		FrameBuffer * pBuffer = frameBufferList().getCurrent();
+		if (dwnd().getDrawer().isTexrectDrawerMode()) {
+			target.uScreenScale[0] = target.uScreenScale[1] = 1.0f;
+		} else if (pBuffer == nullptr) {
+			target.uScreenScale[0] = dwnd().getScaleX();
+			target.uScreenScale[1] = dwnd().getScaleY();
+		} else {
+			target.uScreenScale[0] = target.uScreenScale[1] = pBuffer->m_scale;
+		}
+		f32 scaleX, scaleY;
+		calcCoordsScales(pBuffer, scaleX, scaleY);
+		target.uScreenCoordsScale[0] = 2.0f*scaleX;
+		target.uScreenCoordsScale[1] = -2.0f*scaleY;
+
+		CombinerUniformBlocks::StateBlock & state = m_blocks->getStateBlock();
+		memcpy(state.uFogColor, &gDP.fogColor.r, sizeof(state.uFogColor));
+		memcpy(state.uCenterColor, &gDP.key.center.r, sizeof(state.uCenterColor));
+		memcpy(state.uScaleColor, &gDP.key.scale.r, sizeof(state.uScaleColor));
+		memcpy(state.uBlendColor, &gDP.blendColor.r, sizeof(state.uBlendColor));
+		memcpy(state.uEnvColor, &gDP.envColor.r, sizeof(state.uEnvColor));
+		memcpy(state.uPrimColor, &gDP.primColor.r, sizeof(state.uPrimColor));
+		state.uPrimLod = gDP.primColor.l;
+		state.uK4 = _FIXED2FLOATCOLOR(gDP.convert.k4, 8 );
+		state.uK5 = _FIXED2FLOATCOLOR(gDP.convert.k5, 8 );
+		state.uTexScale[0] = gSP.texture.scales;
+		state.uTexScale[1] = gSP.texture.scalet;
+
+		if (RSP.LLE) {
+			state.uFogUsage = 0;
+		} else {
+			state.uFogUsage = ((gSP.geometryMode & G_FOG) != 0) ? 1 : 0;
+			if (GBI.getMicrocodeType() == F3DAM) {
+				const s16 fogMode = ((gSP.geometryMode >> 13) & 9) + 0xFFF8;
+				if (fogMode == 0)
+					state.uFogUsage = 1;
+				else if (fogMode > 0)
+					state.uFogUsage = 2;
+			}
+			state.uFogScale[0] = gSP.fog.multiplierf;
+			state.uFogScale[1] = gSP.fog.offsetf;
+		}
+
+		m_blocks->update();
+	}
+
+private:
+	CombinerUniformBlocks * m_blocks;
+};
+
 /*---------------CombinerProgramUniformFactory-------------*/
 
 void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
@@ -968,7 +1031,10 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 			_uniforms.emplace_back(new UTextureParams(_program, _inputs.usesTile(0), _inputs.usesTile(1)));
 	}
 
-	_uniforms.emplace_back(new UFog(_program));
+	if (m_uniformBlocks != nullptr)
+		_uniforms.emplace_back(new UUniformBlocks(_program, m_uniformBlocks));
+	else
+		_uniforms.emplace_back(new UFog(_program));
 
 	if (config.generalEmulation.enableLegacyBlending == 0) {
 		switch (_key.getCycleType()) {
@@ -983,7 +1049,8 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 
 	_uniforms.emplace_back(new UDitherMode(_program, _inputs.usesNoise()));
 
-	_uniforms.emplace_back(new UScreenScale(_program));
+	if (m_uniformBlocks == nullptr)
+		_uniforms.emplace_back(new UScreenScale(_program));
 
 	_uniforms.emplace_back(new UAlphaTestInfo(_program));
 
@@ -1004,9 +1071,10 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 		_uniforms.emplace_back(new UPolygonOffset(_program));
 	}
 
-	_uniforms.emplace_back(new UScreenCoordsScale(_program));
-
-	_uniforms.emplace_back(new UColors(_program));
+	if (m_uniformBlocks == nullptr) {
+		_uniforms.emplace_back(new UScreenCoordsScale(_program));
+		_uniforms.emplace_back(new UColors(_program));
+	}
 
 	if (_key.isRectKey())
 		_uniforms.emplace_back(new URectColor(_program));
@@ -1015,8 +1083,10 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 		_uniforms.emplace_back(new ULights(_program));
 }
 
-CombinerProgramUniformFactory::CombinerProgramUniformFactory(const opengl::GLInfo & _glInfo)
+CombinerProgramUniformFactory::CombinerProgramUniformFactory(const opengl::GLInfo & _glInfo,
+															 CombinerUniformBlocks * _uniformBlocks)
 : m_glInfo(_glInfo)
+, m_uniformBlocks(_uniformBlocks)
 {
 }
 
@@ -4,10 +4,12 @@
 
 namespace glsl {
 
+	class CombinerUniformBlocks;
+
 	class CombinerProgramUniformFactory
 	{
 	public:
-		CombinerProgramUniformFactory(const opengl::GLInfo & _glInfo);
+		CombinerProgramUniformFactory(const opengl::GLInfo & _glInfo, CombinerUniformBlocks * _uniformBlocks);
 
 		void buildUniforms(GLuint _program,
 							const CombinerInputs & _inputs,
@@ -16,6 +18,7 @@ namespace glsl {
 
 	private:
 		const opengl::GLInfo & m_glInfo;
+		CombinerUniformBlocks * m_uniformBlocks;
 	};
 
 }
@@ -0,0 +1,166 @@
+#include <string.h>
+#include <Graphics/Parameter.h>
+#include <Graphics/ObjectHandle.h>
+#include "glsl_CombinerUniformBlocks.h"
+
+using namespace glsl;
+
+const u32 CombinerUniformBlocks::m_bufSize = 4194304;
+const u32 CombinerUniformBlocks::m_segmentSize = m_bufSize / m_segmentsNum;
+
+static const char * const strBlockNames[] = { "TargetBlock", "StateBlock" };
+
+bool CombinerUniformBlocks::Check(const opengl::GLInfo & _glinfo)
+{
+	return !_glinfo.isGLES2;
+}
+
+std::string CombinerUniformBlocks::getDeclarations(const opengl::GLInfo & _glinfo)
+{
+	if (!Check(_glinfo)) {
+		return
+			"uniform mediump vec2 uScreenScale;			\n"
+			"uniform mediump vec2 uScreenCoordsScale;	\n"
+			"uniform lowp vec4 uFogColor;				\n"
+			"uniform lowp vec4 uCenterColor;			\n"
+			"uniform lowp vec4 uScaleColor;				\n"
+			"uniform lowp vec4 uBlendColor;				\n"
+			"uniform lowp vec4 uEnvColor;				\n"
+			"uniform lowp vec4 uPrimColor;				\n"
+			"uniform mediump vec2 uFogScale;			\n"
+			"uniform mediump vec2 uTexScale;			\n"
+			"uniform lowp float uPrimLod;				\n"
+			"uniform lowp float uK4;					\n"
+			"uniform lowp float uK5;					\n"
+			"uniform lowp int uFogUsage;				\n"
+			;
+	}
+
+	// Must match TargetBlock and StateBlock
+	return
+		"layout (std140) uniform TargetBlock {		\n"
+		"  mediump vec2 uScreenScale;				\n"
+		"  mediump vec2 uScreenCoordsScale;			\n"
+		"};											\n"
+		"layout (std140) uniform StateBlock {		\n"
+		"  lowp vec4 uFogColor;						\n"
+		"  lowp vec4 uCenterColor;					\n"
+		"  lowp vec4 uScaleColor;					\n"
+		"  lowp vec4 uBlendColor;					\n"
+		"  lowp vec4 uEnvColor;						\n"
+		"  lowp vec4 uPrimColor;					\n"
+		"  mediump vec2 uFogScale;					\n"
+		"  mediump vec2 uTexScale;					\n"
+		"  lowp float uPrimLod;						\n"
+		"  lowp float uK4;							\n"
+		"  lowp float uK5;							\n"
+		"  lowp int uFogUsage;						\n"
+		"};											\n"
+		;
+}
+
+CombinerUniformBlocks::CombinerUniformBlocks(const opengl::GLInfo & _glinfo, opengl::CachedBindBuffer * _bindBuffer)
+: m_glInfo(_glinfo)
+, m_bindBuffer(_bindBuffer)
+{
+	memset(&m_target, 0, sizeof(m_target));
+	memset(&m_state, 0, sizeof(m_state));
+	for (u32 i = 0; i < bCount; ++i)
+		m_bound[i] = false;
+
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0)
+		m_alignment = alignment;
+
+	glGenBuffers(1, &m_handle);
+	m_bindBuffer->bind(graphics::Parameter(GL_UNIFORM_BUFFER), graphics::ObjectHandle(m_handle));
+	if (m_glInfo.bufferStorage) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_UNIFORM_BUFFER, m_bufSize, nullptr, flags);
+		m_data = (GLubyte*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, m_bufSize, flags);
+	} else {
+		glBufferData(GL_UNIFORM_BUFFER, m_bufSize, nullptr, GL_DYNAMIC_DRAW);
+	}
+}
+
+CombinerUniformBlocks::~CombinerUniformBlocks()
+{
+	for (GLsync fence : m_fences) {
+		if (fence != nullptr)
+			glDeleteSync(fence);
+	}
+	m_bindBuffer->bind(graphics::Parameter(GL_UNIFORM_BUFFER), graphics::ObjectHandle::null);
+	glDeleteBuffers(1, &m_handle);
+}
+
+void CombinerUniformBlocks::bindProgram(GLuint _program) const
+{
+	for (u32 i = 0; i < bCount; ++i) {
+		const GLuint index = glGetUniformBlockIndex(_program, strBlockNames[i]);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(_program, index, i);
+	}
+}
+
+void CombinerUniformBlocks::update()
+{
+	const bool targetChanged = !m_bound[bTarget] || memcmp(&m_target, &m_boundTarget, sizeof(TargetBlock)) != 0;
+	const bool stateChanged = !m_bound[bState] || memcmp(&m_state, &m_boundState, sizeof(StateBlock)) != 0;
+	if (!targetChanged && !stateChanged)
+		return;
+
+	// Room for both blocks, whatever the alignment
+	const GLintptr segmentEnd = GLintptr(m_segment + 1) * m_segmentSize;
+	if (m_offset + 2 * m_alignment + GLintptr(sizeof(TargetBlock) + sizeof(StateBlock)) > segmentEnd)
+		_nextSegment();
+
+	if (!m_bound[bTarget] || targetChanged) {
+		m_boundTarget = m_target;
+		_upload(bTarget, &m_target, sizeof(TargetBlock));
+	}
+
+	if (!m_bound[bState] || stateChanged) {
+		m_boundState = m_state;
+		_upload(bState, &m_state, sizeof(StateBlock));
+	}
+}
+
+void CombinerUniformBlocks::_nextSegment()
+{
+	// Covers every draw which reads from the current segment. Both blocks are written
+	// to the next segment, so later draws do not read from this one.
+	m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	for (u32 i = 0; i < bCount; ++i)
+		m_bound[i] = false;
+
+	m_segment = (m_segment + 1) % m_segmentsNum;
+	m_offset = GLintptr(m_segment) * m_segmentSize;
+
+	const GLsync fence = m_fences[m_segment];
+	if (fence == nullptr)
+		return;
+	GLenum res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+	while (res == GL_TIMEOUT_EXPIRED)
+		res = glClientWaitSync(fence, 0, 100000000);
+	glDeleteSync(fence);
+	m_fences[m_segment] = nullptr;
+}
+
+void CombinerUniformBlocks::_upload(Binding _binding, const void * _data, u32 _size)
+{
+	m_offset = (m_offset + m_alignment - 1) / m_alignment * m_alignment;
+
+	if (m_data != nullptr) {
+		memcpy(m_data + m_offset, _data, _size);
+	} else {
+		m_bindBuffer->bind(graphics::Parameter(GL_UNIFORM_BUFFER), graphics::ObjectHandle(m_handle));
+		void * bufferPointer = glMapBufferRange(GL_UNIFORM_BUFFER, m_offset, _size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		memcpy(bufferPointer, _data, _size);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+	}
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, _binding, m_handle, m_offset, _size);
+	m_bound[_binding] = true;
+	m_offset += _size;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <Graphics/OpenGLContext/opengl_GLInfo.h>
+#include <Graphics/OpenGLContext/opengl_CachedFunctions.h>
+
+namespace glsl {
+
+	// Combiner uniforms which do not depend on the program, kept in std140 uniform blocks.
+	// All combiner programs read the blocks from the same binding points, so switching
+	// programs does not send them again. A block which changed is written to the next
+	// free place of a ring buffer and bound there. The ring is split in segments, and a
+	// segment is reused only after the draws which read from it are done.
+	// The target block changes a few times per frame, the state block with RDP commands.
+	// Uniforms which change with each draw, like alpha test, blend mode and texture
+	// parameters, depend on the program's inputs and stay plain uniforms: a per-draw
+	// block would be written and bound again for every draw.
+	class CombinerUniformBlocks
+	{
+	public:
+		// Changes with the render target
+		struct TargetBlock {
+			f32 uScreenScale[2];
+			f32 uScreenCoordsScale[2];
+		};
+
+		// Changes with the RDP and RSP state
+		struct StateBlock {
+			f32 uFogColor[4];
+			f32 uCenterColor[4];
+			f32 uScaleColor[4];
+			f32 uBlendColor[4];
+			f32 uEnvColor[4];
+			f32 uPrimColor[4];
+			f32 uFogScale[2];
+			f32 uTexScale[2];
+			f32 uPrimLod;
+			f32 uK4;
+			f32 uK5;
+			s32 uFogUsage;
+		};
+
+		static bool Check(const opengl::GLInfo & _glinfo);
+
+		// Declarations of the shared uniforms for vertex and fragment shaders.
+		// Plain uniforms where uniform blocks are not supported.
+		static std::string getDeclarations(const opengl::GLInfo & _glinfo);
+
+		CombinerUniformBlocks(const opengl::GLInfo & _glinfo, opengl::CachedBindBuffer * _bindBuffer);
+		~CombinerUniformBlocks();
+
+		void bindProgram(GLuint _program) const;
+
+		TargetBlock & getTargetBlock() { return m_target; }
+
+		StateBlock & getStateBlock() { return m_state; }
+
+		// Sends the blocks which changed since the last update
+		void update();
+
+	private:
+		enum Binding {
+			bTarget,
+			bState,
+			bCount
+		};
+
+		void _nextSegment();
+		void _upload(Binding _binding, const void * _data, u32 _size);
+
+		const opengl::GLInfo & m_glInfo;
+		opengl::CachedBindBuffer * m_bindBuffer;
+		TargetBlock m_target;
+		TargetBlock m_boundTarget;
+		StateBlock m_state;
+		StateBlock m_boundState;
+		bool m_bound[bCount];
+		GLuint m_handle = 0;
+		GLubyte * m_data = nullptr;
+		GLintptr m_offset = 0;
+		GLintptr m_alignment = 256;
+		static const u32 m_segmentsNum = 4;
+		u32 m_segment = 0;
+		GLsync m_fences[m_segmentsNum] = {};
+
+		static const u32 m_bufSize;
+		static const u32 m_segmentSize;
+	};
+
+}
@@ -319,7 +319,7 @@ bool ShaderStorage::loadShadersStorage(graphics::Combiners & _combiners)
 			return _loadFromCombinerKeys(_combiners);
 
 		displayLoadProgress(L"LOAD COMBINER SHADERS %.1f%%", 0.0f);
-		CombinerProgramUniformFactory uniformFactory(m_glinfo);
+		CombinerProgramUniformFactory uniformFactory(m_glinfo, m_uniformBlocks);
 
 		fin.read((char*)&len, sizeof(len));
 		const f32 percent = len / 100.0f;
@@ -346,8 +346,10 @@ bool ShaderStorage::loadShadersStorage(graphics::Combiners & _combiners)
 }
 
 
-ShaderStorage::ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram)
+ShaderStorage::ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram,
+							 CombinerUniformBlocks * _uniformBlocks)
 : m_glinfo(_glinfo)
 , m_useProgram(_useProgram)
+, m_uniformBlocks(_uniformBlocks)
 {
 }
@@ -7,10 +7,13 @@ namespace opengl {
 
 namespace glsl {
 
+	class CombinerUniformBlocks;
+
 	class ShaderStorage
 	{
 	public:
-		ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram);
+		ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram,
+			CombinerUniformBlocks * _uniformBlocks);
 
 		bool saveShadersStorage(const graphics::Combiners & _combiners) const;
 
@@ -20,10 +23,11 @@ namespace glsl {
 		bool _saveCombinerKeys(const graphics::Combiners & _combiners) const;
 		bool _loadFromCombinerKeys(graphics::Combiners & _combiners);
 
-		const u32 m_formatVersion = 0x22U;
+		const u32 m_formatVersion = 0x23U;
 		const u32 m_keysFormatVersion = 0x04;
 		const opengl::GLInfo & m_glinfo;
 		opengl::CachedUseProgram * m_useProgram;
+		CombinerUniformBlocks * m_uniformBlocks;
 	};
 
 }
@@ -6,6 +6,7 @@
 #include <Config.h>
 #include <PaletteTexture.h>
 #include <ZlutTexture.h>
+#include <Graphics/Context.h>
 #include <Graphics/Parameters.h>
 #include <Graphics/ObjectHandle.h>
 #include <Graphics/ShaderProgram.h>
@@ -407,6 +408,66 @@ namespace glsl {
 		}
 	};
 
+	/*---------------ColorBufferPackShaderPart-------------*/
+
+	class ColorBufferPack : public ShaderPart
+	{
+	public:
+		ColorBufferPack(const opengl::GLInfo & _glinfo)
+		{
+			// Each fragment is one dword of N64 frame buffer as it lies in RDRAM:
+			// 32bit: R8G8B8A8, 16bit: two RGBA5551 pixels with halfwords swapped.
+			m_part =
+				"uniform sampler2D uTex0;														\n"
+				"uniform lowp int uPackSize;													\n"
+				"uniform mediump int uSrcY0;													\n"
+				"OUT lowp vec4 fragColor;														\n"
+				"highp uint packRGBA5551(in lowp vec4 color)									\n"
+				"{																				\n"
+				"  highp uvec4 c = uvec4(floor(color * 255.0 + 0.5));							\n"
+				"  return ((c.r >> 3) << 11) | ((c.g >> 3) << 6) | ((c.b >> 3) << 1) | (c.a == 0u ? 0u : 1u);	\n"
+				"}																				\n"
+				"void main()																	\n"
+				"{																				\n"
+				"  mediump ivec2 coord = ivec2(gl_FragCoord.xy) + ivec2(0, uSrcY0);				\n"
+				"  if (uPackSize == 3) {														\n"
+				"    fragColor = texelFetch(uTex0, coord, 0).abgr;								\n"
+				"  } else {																		\n"
+				"    highp uint p0 = packRGBA5551(texelFetch(uTex0, ivec2(coord.x * 2, coord.y), 0));		\n"
+				"    highp uint p1 = packRGBA5551(texelFetch(uTex0, ivec2(coord.x * 2 + 1, coord.y), 0));	\n"
+				"    fragColor = vec4(float(p1 & 255u), float(p1 >> 8), float(p0 & 255u), float(p0 >> 8)) / 255.0;	\n"
+				"  }																			\n"
+			;
+		}
+	};
+
+	class DepthBufferPack : public ShaderPart
+	{
+	public:
+		DepthBufferPack(const opengl::GLInfo & _glinfo)
+		{
+			// Each fragment is one dword of N64 depth buffer as it lies in RDRAM:
+			// two depth values in N64 format, converted with ZLUT, with halfwords swapped.
+			m_part =
+				"uniform sampler2D uTex0;														\n"
+				"uniform highp usampler2D uZlutImage;											\n"
+				"uniform mediump int uSrcY0;													\n"
+				"OUT lowp vec4 fragColor;														\n"
+				"highp uint encodeDepth(in highp float z)										\n"
+				"{																				\n"
+				"  highp int idx = z < 1.0 ? min(262143, int(floor(max(z, 0.0) * 262144.0 + 0.5))) : 262143;	\n"
+				"  return texelFetch(uZlutImage, ivec2(idx & 511, idx >> 9), 0).r;				\n"
+				"}																				\n"
+				"void main()																	\n"
+				"{																				\n"
+				"  mediump ivec2 coord = ivec2(gl_FragCoord.xy) + ivec2(0, uSrcY0);				\n"
+				"  highp uint z0 = encodeDepth(texelFetch(uTex0, ivec2(coord.x * 2, coord.y), 0).r);		\n"
+				"  highp uint z1 = encodeDepth(texelFetch(uTex0, ivec2(coord.x * 2 + 1, coord.y), 0).r);	\n"
+				"  fragColor = vec4(float(z1 & 255u), float(z1 >> 8), float(z0 & 255u), float(z0 >> 8)) / 255.0;	\n"
+			;
+		}
+	};
+
 	/*---------------TextDrawerShaderPart-------------*/
 
 	class TextDraw : public ShaderPart
@@ -505,7 +566,7 @@ namespace glsl {
 			glUniform1i(m_locZlut, int(graphics::textureIndices::ZLUTTex));
 			glUniform1i(m_locTlut, int(graphics::textureIndices::PaletteTex));
 			glUniform1i(m_locDepthImage, 0);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			gfxContext.setBlending(graphics::blend::SRC_ALPHA, graphics::blend::ONE_MINUS_SRC_ALPHA);
 			g_paletteTexture.update();
 		}
 
@@ -740,6 +801,71 @@ namespace glsl {
 		int m_colorLoc;
 	};
 
+	/*---------------ColorBufferPackShader-------------*/
+
+	typedef SpecialShader<VertexShaderTexturedRect, ColorBufferPack, graphics::BufferPackShaderProgram> ColorBufferPackShaderBase;
+
+	class ColorBufferPackShader : public ColorBufferPackShaderBase
+	{
+	public:
+		ColorBufferPackShader(const opengl::GLInfo & _glinfo,
+			opengl::CachedUseProgram * _useProgram,
+			const ShaderPart * _vertexHeader,
+			const ShaderPart * _fragmentHeader,
+			const ShaderPart * _fragmentEnd)
+			: ColorBufferPackShaderBase(_glinfo, _useProgram, _vertexHeader, _fragmentHeader, _fragmentEnd)
+		{
+			m_useProgram->useProgram(m_program);
+			const int texLoc = glGetUniformLocation(GLuint(m_program), "uTex0");
+			glUniform1i(texLoc, 0);
+			m_packSizeLoc = glGetUniformLocation(GLuint(m_program), "uPackSize");
+			m_srcY0Loc = glGetUniformLocation(GLuint(m_program), "uSrcY0");
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+		}
+
+		void setPackParams(u32 _size, s32 _srcY0) override {
+			m_useProgram->useProgram(m_program);
+			glUniform1i(m_packSizeLoc, _size);
+			glUniform1i(m_srcY0Loc, _srcY0);
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+		}
+
+	private:
+		int m_packSizeLoc;
+		int m_srcY0Loc;
+	};
+
+	typedef SpecialShader<VertexShaderTexturedRect, DepthBufferPack, graphics::BufferPackShaderProgram> DepthBufferPackShaderBase;
+
+	class DepthBufferPackShader : public DepthBufferPackShaderBase
+	{
+	public:
+		DepthBufferPackShader(const opengl::GLInfo & _glinfo,
+			opengl::CachedUseProgram * _useProgram,
+			const ShaderPart * _vertexHeader,
+			const ShaderPart * _fragmentHeader,
+			const ShaderPart * _fragmentEnd)
+			: DepthBufferPackShaderBase(_glinfo, _useProgram, _vertexHeader, _fragmentHeader, _fragmentEnd)
+		{
+			m_useProgram->useProgram(m_program);
+			const int texLoc = glGetUniformLocation(GLuint(m_program), "uTex0");
+			glUniform1i(texLoc, 0);
+			const int zlutLoc = glGetUniformLocation(GLuint(m_program), "uZlutImage");
+			glUniform1i(zlutLoc, int(graphics::textureIndices::ZLUTTex));
+			m_srcY0Loc = glGetUniformLocation(GLuint(m_program), "uSrcY0");
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+		}
+
+		void setPackParams(u32 _size, s32 _srcY0) override {
+			m_useProgram->useProgram(m_program);
+			glUniform1i(m_srcY0Loc, _srcY0);
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+		}
+
+	private:
+		int m_srcY0Loc;
+	};
+
 	/*---------------SpecialShadersFactory-------------*/
 
 	SpecialShadersFactory::SpecialShadersFactory(const opengl::GLInfo & _glinfo,
@@ -798,4 +924,21 @@ namespace glsl {
 		return new TextDrawerShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
 	}
 
+	graphics::BufferPackShaderProgram * SpecialShadersFactory::createColorBufferPackShader() const
+	{
+		if (m_glinfo.isGLES2)
+			return nullptr;
+
+		return new ColorBufferPackShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
+	}
+
+	graphics::BufferPackShaderProgram * SpecialShadersFactory::createDepthBufferPackShader() const
+	{
+		// ZLUT texture needs integer textures
+		if (m_glinfo.isGLES2)
+			return nullptr;
+
+		return new DepthBufferPackShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
+	}
+
 }
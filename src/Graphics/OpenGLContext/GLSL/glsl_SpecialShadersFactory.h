@@ -38,6 +38,10 @@ namespace glsl {
 
 		graphics::TextDrawerShaderProgram * createTextDrawerShader() const;
 
+		graphics::BufferPackShaderProgram * createColorBufferPackShader() const;
+
+		graphics::BufferPackShaderProgram * createDepthBufferPackShader() const;
+
 	private:
 		const opengl::GLInfo & m_glinfo;
 		const ShaderPart * m_vertexHeader;
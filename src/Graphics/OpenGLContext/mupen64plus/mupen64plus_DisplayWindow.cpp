@@ -30,8 +30,7 @@ private:
 	bool _start() override;
 	void _stop() override;
 	void _swapBuffers() override;
-	void _saveScreenshot() override;
-	void _saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture *_pTexture) override;
+	void _saveScreenshot(u32 _width, u32 _height, const u8 * _data) override;
 	bool _resizeWindow() override;
 	void _changeWindow() override;
 	void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) override {}
@@ -122,11 +121,7 @@ void DisplayWindowMupen64plus::_swapBuffers()
 	CoreVideo_GL_SwapBuffers();
 }
 
-void DisplayWindowMupen64plus::_saveScreenshot()
-{
-}
-
-void DisplayWindowMupen64plus::_saveBufferContent(graphics::ObjectHandle /*_fbo*/, CachedTexture* /*_pTexture*/)
+void DisplayWindowMupen64plus::_saveScreenshot(u32 /*_width*/, u32 /*_height*/, const u8 * /*_data*/)
 {
 }
 
@@ -198,10 +198,10 @@ public:
 	}
 
 	BlitFramebuffersImpl(CachedBindFramebuffer * _bind,
-		CachedEnable * _enableScissor,
+		CachedRenderState * _renderState,
 		Renderer _renderer)
 		: m_bind(_bind)
-		, m_enableScissor(_enableScissor)
+		, m_renderState(_renderState)
 		, m_renderer(_renderer) {
 	}
 
@@ -210,23 +210,24 @@ public:
 		m_bind->bind(graphics::bufferTarget::READ_FRAMEBUFFER, _params.readBuffer);
 		m_bind->bind(graphics::bufferTarget::DRAW_FRAMEBUFFER, _params.drawBuffer);
 
-		const s32 adrenoCoordFix = (m_renderer == Renderer::Adreno) ? 1 : 0;
+		const s32 adrenoCoordFix = (m_renderer == Renderer::Adreno && !_params.exactCoords) ? 1 : 0;
 
-		m_enableScissor->enable(false);
+		m_renderState->enable(graphics::enable::SCISSOR_TEST, false);
+		m_renderState->apply();
 
 		glBlitFramebuffer(
 			adrenoCoordFix + _params.srcX0, _params.srcY0, _params.srcX1, _params.srcY1,
 			adrenoCoordFix + _params.dstX0, _params.dstY0, _params.dstX1, _params.dstY1,
 			GLbitfield(_params.mask), GLenum(_params.filter)
 		);
-		m_enableScissor->enable(true);
+		m_renderState->enable(graphics::enable::SCISSOR_TEST, true);
 
 		return !Utils::isGLError();
 	}
 
 private:
 	CachedBindFramebuffer * m_bind;
-	CachedEnable * m_enableScissor;
+	CachedRenderState * m_renderState;
 	Renderer m_renderer;
 };
 
@@ -441,7 +442,7 @@ BlitFramebuffers * BufferManipulationObjectFactory::getBlitFramebuffers() const
 {
 	if (BlitFramebuffersImpl::Check(m_glInfo))
 		return new BlitFramebuffersImpl(m_cachedFunctions.getCachedBindFramebuffer(),
-										m_cachedFunctions.getCachedEnable(graphics::enable::SCISSOR_TEST),
+										m_cachedFunctions.getCachedRenderState(),
 										m_glInfo.renderer);
 
 	return new DummyBlitFramebuffers;
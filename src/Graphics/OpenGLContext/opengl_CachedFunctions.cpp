@@ -1,3 +1,4 @@
+#include <string.h>
 #include <Graphics/Parameters.h>
 
 #include "GLFunctions.h"
@@ -14,13 +15,13 @@ CachedEnable::CachedEnable(Parameter _parameter)
 {
 }
 
-void CachedEnable::enable(bool _enable)
+bool CachedEnable::enable(bool _enable)
 {
 	if (!m_parameter.isValid())
-		return;
+		return false;
 
 	if (!update(u32(_enable)))
-		return;
+		return false;
 
 	if (_enable) {
 		if (m_parameter == enable::BLEND && IS_GL_FUNCTION_VALID(glEnablei))
@@ -33,6 +34,7 @@ void CachedEnable::enable(bool _enable)
 		else
 			glDisable(GLenum(m_parameter));
 	}
+	return true;
 }
 
 u32 CachedEnable::get()
@@ -52,58 +54,82 @@ void CachedBindTexture::bind(Parameter _tmuIndex, Parameter _target, ObjectHandl
 
 /*---------------CachedCullFace-------------*/
 
-void CachedCullFace::setCullFace(Parameter _mode)
+bool CachedCullFace::setCullFace(Parameter _mode)
 {
-	if (update(_mode))
-		glCullFace(GLenum(_mode));
+	if (!update(_mode))
+		return false;
+	glCullFace(GLenum(_mode));
+	return true;
 }
 
 /*---------------CachedDepthMask-------------*/
 
-void CachedDepthMask::setDepthMask(bool _enable)
+bool CachedDepthMask::setDepthMask(bool _enable)
 {
-	if (update(Parameter(u32(_enable))))
-		glDepthMask(GLboolean(_enable));
+	if (!update(Parameter(u32(_enable))))
+		return false;
+	glDepthMask(GLboolean(_enable));
+	return true;
 }
 
 /*---------------CachedDepthMask-------------*/
 
-void CachedDepthCompare::setDepthCompare(Parameter _mode)
+bool CachedDepthCompare::setDepthCompare(Parameter _mode)
 {
-	if (update(_mode))
-		glDepthFunc(GLenum(_mode));
+	if (!update(_mode))
+		return false;
+	glDepthFunc(GLenum(_mode));
+	return true;
 }
 
 /*---------------CachedViewport-------------*/
 
-void CachedViewport::setViewport(s32 _x, s32 _y, s32 _width, s32 _height)
+bool CachedViewport::setViewport(s32 _x, s32 _y, s32 _width, s32 _height)
 {
-	if (update(Parameter(_x), Parameter(_y), Parameter(_width), Parameter(_height)))
-		glViewport(_x, _y, _width, _height);
+	if (!update(Parameter(_x), Parameter(_y), Parameter(_width), Parameter(_height)))
+		return false;
+	glViewport(_x, _y, _width, _height);
+	return true;
 }
 
 /*---------------CachedScissor-------------*/
 
-void CachedScissor::setScissor(s32 _x, s32 _y, s32 _width, s32 _height)
+bool CachedScissor::setScissor(s32 _x, s32 _y, s32 _width, s32 _height)
 {
-	if (update(Parameter(_x), Parameter(_y), Parameter(_width), Parameter(_height)))
-		glScissor(_x, _y, _width, _height);
+	if (!update(Parameter(_x), Parameter(_y), Parameter(_width), Parameter(_height)))
+		return false;
+	glScissor(_x, _y, _width, _height);
+	return true;
 }
 
 /*---------------CachedBlending-------------*/
 
-void CachedBlending::setBlending(Parameter _sfactor, Parameter _dfactor)
+bool CachedBlending::setBlending(Parameter _sfactor, Parameter _dfactor)
 {
-	if (update(_sfactor, _dfactor))
-		glBlendFunc(GLenum(_sfactor), GLenum(_dfactor));
+	if (!update(_sfactor, _dfactor))
+		return false;
+	glBlendFunc(GLenum(_sfactor), GLenum(_dfactor));
+	return true;
 }
 
 /*---------------CachedBlendColor-------------*/
 
-void CachedBlendColor::setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha)
+bool CachedBlendColor::setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 {
-	if (update(Parameter(_red), Parameter(_green), Parameter(_blue), Parameter(_alpha)))
-		glBlendColor(_red, _green, _blue, _alpha);
+	if (!update(Parameter(_red), Parameter(_green), Parameter(_blue), Parameter(_alpha)))
+		return false;
+	glBlendColor(_red, _green, _blue, _alpha);
+	return true;
+}
+
+/*---------------CachedPolygonOffset-------------*/
+
+bool CachedPolygonOffset::setPolygonOffset(f32 _factor, f32 _units)
+{
+	if (!update(Parameter(_factor), Parameter(_units)))
+		return false;
+	glPolygonOffset(_factor, _units);
+	return true;
 }
 
 /*---------------CachedClearColor-------------*/
@@ -149,12 +175,208 @@ void CachedTextureUnpackAlignment::setTextureUnpackAlignment(s32 _param)
 		glPixelStorei(GL_UNPACK_ALIGNMENT, _param);
 }
 
+/*---------------CachedRenderState-------------*/
+
+static const u32 trackedEnablesCount = 5;
+
+static Parameter trackedEnable(u32 _index)
+{
+	switch (_index) {
+	case 0: return enable::BLEND;
+	case 1: return enable::CULL_FACE;
+	case 2: return enable::DEPTH_TEST;
+	case 3: return enable::POLYGON_OFFSET_FILL;
+	case 4: return enable::SCISSOR_TEST;
+	}
+	return Parameter();
+}
+
+CachedRenderState::CachedRenderState(CachedFunctions & _cachedFunctions, RenderStateCounters & _counters)
+: m_cachedFunctions(_cachedFunctions)
+, m_counters(_counters)
+, m_fields(0)
+, m_boundValid(false)
+{
+	memset(&m_pending, 0, sizeof(State));
+	memset(&m_bound, 0, sizeof(State));
+}
+
+u32 CachedRenderState::_enableBit(Parameter _parameter) const
+{
+	for (u32 i = 0; i < trackedEnablesCount; ++i) {
+		if (trackedEnable(i) == _parameter)
+			return 1 << i;
+	}
+	return 0;
+}
+
+bool CachedRenderState::enable(Parameter _parameter, bool _enable)
+{
+	const u32 bit = _enableBit(_parameter);
+	if (bit == 0)
+		return false;
+	if (_enable)
+		m_pending.enables |= bit;
+	else
+		m_pending.enables &= ~bit;
+	m_pending.enablesSet |= bit;
+	m_fields |= fEnables;
+	++m_counters.stateRequests;
+	return true;
+}
+
+bool CachedRenderState::isEnabled(Parameter _parameter, u32 & _enabled) const
+{
+	const u32 bit = _enableBit(_parameter);
+	if ((m_pending.enablesSet & bit) == 0)
+		return false;
+	_enabled = (m_pending.enables & bit) != 0 ? 1 : 0;
+	return true;
+}
+
+void CachedRenderState::setCullFace(Parameter _mode)
+{
+	m_pending.cullFace = u32(_mode);
+	m_fields |= fCullFace;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setDepthMask(bool _enable)
+{
+	m_pending.depthMask = u32(_enable);
+	m_fields |= fDepthMask;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setDepthCompare(Parameter _mode)
+{
+	m_pending.depthCompare = u32(_mode);
+	m_fields |= fDepthCompare;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setViewport(s32 _x, s32 _y, s32 _width, s32 _height)
+{
+	m_pending.viewport[0] = _x;
+	m_pending.viewport[1] = _y;
+	m_pending.viewport[2] = _width;
+	m_pending.viewport[3] = _height;
+	m_fields |= fViewport;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setScissor(s32 _x, s32 _y, s32 _width, s32 _height)
+{
+	m_pending.scissor[0] = _x;
+	m_pending.scissor[1] = _y;
+	m_pending.scissor[2] = _width;
+	m_pending.scissor[3] = _height;
+	m_fields |= fScissor;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setBlending(Parameter _sfactor, Parameter _dfactor)
+{
+	m_pending.blending[0] = u32(_sfactor);
+	m_pending.blending[1] = u32(_dfactor);
+	m_fields |= fBlending;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha)
+{
+	m_pending.blendColor[0] = _red;
+	m_pending.blendColor[1] = _green;
+	m_pending.blendColor[2] = _blue;
+	m_pending.blendColor[3] = _alpha;
+	m_fields |= fBlendColor;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::setPolygonOffset(f32 _factor, f32 _units)
+{
+	m_pending.polygonOffset[0] = _factor;
+	m_pending.polygonOffset[1] = _units;
+	m_fields |= fPolygonOffset;
+	++m_counters.stateRequests;
+}
+
+void CachedRenderState::apply()
+{
+	if (m_boundValid && memcmp(&m_pending, &m_bound, sizeof(State)) == 0)
+		return;
+
+	// Without a valid bound state every requested field is passed on,
+	// the cached functions drop what GL already has.
+	const bool all = !m_boundValid;
+	auto changed = [this, all](u32 _field, const void * _pending, const void * _bound, size_t _size) {
+		return (m_fields & _field) != 0 && (all || memcmp(_pending, _bound, _size) != 0);
+	};
+	u32 calls = 0;
+
+	if ((m_fields & fEnables) != 0) {
+		const u32 enables = all ? m_pending.enablesSet :
+			((m_pending.enables ^ m_bound.enables) | (m_pending.enablesSet & ~m_bound.enablesSet)) & m_pending.enablesSet;
+		for (u32 i = 0; i < trackedEnablesCount; ++i) {
+			const u32 bit = 1 << i;
+			if ((enables & bit) != 0 &&
+				m_cachedFunctions.getCachedEnable(trackedEnable(i))->enable((m_pending.enables & bit) != 0))
+				++calls;
+		}
+	}
+
+	if (changed(fCullFace, &m_pending.cullFace, &m_bound.cullFace, sizeof(u32)) &&
+		m_cachedFunctions.getCachedCullFace()->setCullFace(Parameter(m_pending.cullFace)))
+		++calls;
+
+	if (changed(fDepthMask, &m_pending.depthMask, &m_bound.depthMask, sizeof(u32)) &&
+		m_cachedFunctions.getCachedDepthMask()->setDepthMask(m_pending.depthMask != 0))
+		++calls;
+
+	if (changed(fDepthCompare, &m_pending.depthCompare, &m_bound.depthCompare, sizeof(u32)) &&
+		m_cachedFunctions.getCachedDepthCompare()->setDepthCompare(Parameter(m_pending.depthCompare)))
+		++calls;
+
+	if (changed(fViewport, m_pending.viewport, m_bound.viewport, sizeof(m_pending.viewport)) &&
+		m_cachedFunctions.getCachedViewport()->setViewport(m_pending.viewport[0], m_pending.viewport[1],
+			m_pending.viewport[2], m_pending.viewport[3]))
+		++calls;
+
+	if (changed(fScissor, m_pending.scissor, m_bound.scissor, sizeof(m_pending.scissor)) &&
+		m_cachedFunctions.getCachedScissor()->setScissor(m_pending.scissor[0], m_pending.scissor[1],
+			m_pending.scissor[2], m_pending.scissor[3]))
+		++calls;
+
+	if (changed(fBlending, m_pending.blending, m_bound.blending, sizeof(m_pending.blending)) &&
+		m_cachedFunctions.getCachedBlending()->setBlending(Parameter(m_pending.blending[0]), Parameter(m_pending.blending[1])))
+		++calls;
+
+	if (changed(fBlendColor, m_pending.blendColor, m_bound.blendColor, sizeof(m_pending.blendColor)) &&
+		m_cachedFunctions.getCachedBlendColor()->setBlendColor(m_pending.blendColor[0], m_pending.blendColor[1],
+			m_pending.blendColor[2], m_pending.blendColor[3]))
+		++calls;
+
+	if (changed(fPolygonOffset, m_pending.polygonOffset, m_bound.polygonOffset, sizeof(m_pending.polygonOffset)) &&
+		m_cachedFunctions.getCachedPolygonOffset()->setPolygonOffset(m_pending.polygonOffset[0], m_pending.polygonOffset[1]))
+		++calls;
+
+	m_counters.stateCalls += calls;
+	m_bound = m_pending;
+	m_boundValid = true;
+}
+
+void CachedRenderState::reset()
+{
+	m_boundValid = false;
+}
+
 /*---------------CachedFunctions-------------*/
 
 CachedFunctions::CachedFunctions(const GLInfo & _glinfo)
 : m_bindFramebuffer(GET_GL_FUNCTION(glBindFramebuffer))
 , m_bindRenderbuffer(GET_GL_FUNCTION(glBindRenderbuffer))
-, m_bindBuffer(GET_GL_FUNCTION(glBindBuffer)) {
+, m_bindBuffer(GET_GL_FUNCTION(glBindBuffer))
+, m_renderState(*this, m_counters) {
 	if (_glinfo.isGLESX) {
 		// Disable parameters, not avalible for GLESX
 		m_enables.emplace(GL_DEPTH_CLAMP, Parameter());
@@ -167,7 +389,7 @@ CachedFunctions::~CachedFunctions()
 
 void CachedFunctions::reset()
 {
-	for (auto it : m_enables)
+	for (auto & it : m_enables)
 		it.second.reset();
 
 	m_texparams.clear();
@@ -182,9 +404,11 @@ void CachedFunctions::reset()
 	m_scissor.reset();
 	m_blending.reset();
 	m_blendColor.reset();
+	m_polygonOffset.reset();
 	m_clearColor.reset();
 	m_attribArray.reset();
 	m_useProgram.reset();
+	m_renderState.reset();
 }
 
 CachedEnable * CachedFunctions::getCachedEnable(Parameter _parameter)
@@ -255,6 +479,11 @@ CachedBlendColor * CachedFunctions::getCachedBlendColor()
 	return &m_blendColor;
 }
 
+CachedPolygonOffset * CachedFunctions::getCachedPolygonOffset()
+{
+	return &m_polygonOffset;
+}
+
 CachedClearColor * CachedFunctions::getCachedClearColor()
 {
 	return &m_clearColor;
@@ -279,3 +508,13 @@ TextureParams * CachedFunctions::getTexParams()
 {
 	return &m_texparams;
 }
+
+CachedRenderState * CachedFunctions::getCachedRenderState()
+{
+	return &m_renderState;
+}
+
+RenderStateCounters * CachedFunctions::getRenderStateCounters()
+{
+	return &m_counters;
+}
@@ -101,7 +101,7 @@ namespace opengl {
 	public:
 		CachedEnable(graphics::Parameter _parameter);
 
-		void enable(bool _enable);
+		bool enable(bool _enable);
 
 		u32 get();
 
@@ -140,43 +140,49 @@ namespace opengl {
 	class CachedCullFace : public Cached1<graphics::Parameter>
 	{
 	public:
-		void setCullFace(graphics::Parameter _mode);
+		bool setCullFace(graphics::Parameter _mode);
 	};
 
 	class CachedDepthMask : public Cached1<graphics::Parameter>
 	{
 	public:
-		void setDepthMask(bool _enable);
+		bool setDepthMask(bool _enable);
 	};
 
 	class CachedDepthCompare : public Cached1<graphics::Parameter>
 	{
 	public:
-		void setDepthCompare(graphics::Parameter m_mode);
+		bool setDepthCompare(graphics::Parameter m_mode);
 	};
 
 	class CachedViewport : public Cached4
 	{
 	public:
-		void setViewport(s32 _x, s32 _y, s32 _width, s32 _height);
+		bool setViewport(s32 _x, s32 _y, s32 _width, s32 _height);
 	};
 
 	class CachedScissor : public Cached4
 	{
 	public:
-		void setScissor(s32 _x, s32 _y, s32 _width, s32 _height);
+		bool setScissor(s32 _x, s32 _y, s32 _width, s32 _height);
 	};
 
 	class CachedBlending : public Cached2<graphics::Parameter, graphics::Parameter>
 	{
 	public:
-		void setBlending(graphics::Parameter _sfactor, graphics::Parameter _dfactor);
+		bool setBlending(graphics::Parameter _sfactor, graphics::Parameter _dfactor);
 	};
 
 	class CachedBlendColor : public Cached4
 	{
 	public:
-		void setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha);
+		bool setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha);
+	};
+
+	class CachedPolygonOffset : public Cached2<graphics::Parameter, graphics::Parameter>
+	{
+	public:
+		bool setPolygonOffset(f32 _factor, f32 _units);
 	};
 
 	class CachedClearColor : public Cached4
@@ -207,17 +213,92 @@ namespace opengl {
 		void setTextureUnpackAlignment(s32 _param);
 	};
 
+	// -1 stands for a parameter which was not set yet
 	struct texture_params {
-		GLint magFilter;
-		GLint minFilter;
-		GLint wrapS;
-		GLint wrapT;
-		GLint maxMipmapLevel;
-		GLfloat maxAnisotropy;
+		GLint magFilter = -1;
+		GLint minFilter = -1;
+		GLint wrapS = -1;
+		GLint wrapT = -1;
+		GLint maxMipmapLevel = -1;
+		GLfloat maxAnisotropy = -1.0f;
 	};
 
 	typedef std::unordered_map<u32, texture_params> TextureParams;
 
+	/*---------------CachedRenderState-------------*/
+
+	class CachedFunctions;
+
+	struct RenderStateCounters {
+		u32 stateRequests = 0;
+		u32 stateCalls = 0;
+		u32 texParamsElided = 0;
+		u32 texParamsCalls = 0;
+	};
+
+	// Fixed function state requested through the context.
+	// The setters only record the requested values. apply() compares the whole state block
+	// with the one last sent to GL and passes the fields which differ to the cached functions.
+	// It is called right before GL uses the state, so that changes made and undone
+	// between two draws cost nothing.
+	class CachedRenderState
+	{
+	public:
+		CachedRenderState(CachedFunctions & _cachedFunctions, RenderStateCounters & _counters);
+
+		// False for capabilities which are not part of the state block
+		bool enable(graphics::Parameter _parameter, bool _enable);
+		bool isEnabled(graphics::Parameter _parameter, u32 & _enabled) const;
+
+		void setCullFace(graphics::Parameter _mode);
+		void setDepthMask(bool _enable);
+		void setDepthCompare(graphics::Parameter _mode);
+		void setViewport(s32 _x, s32 _y, s32 _width, s32 _height);
+		void setScissor(s32 _x, s32 _y, s32 _width, s32 _height);
+		void setBlending(graphics::Parameter _sfactor, graphics::Parameter _dfactor);
+		void setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha);
+		void setPolygonOffset(f32 _factor, f32 _units);
+
+		void apply();
+		void reset();
+
+	private:
+		enum Field {
+			fEnables = 1 << 0,
+			fCullFace = 1 << 1,
+			fDepthMask = 1 << 2,
+			fDepthCompare = 1 << 3,
+			fViewport = 1 << 4,
+			fScissor = 1 << 5,
+			fBlending = 1 << 6,
+			fBlendColor = 1 << 7,
+			fPolygonOffset = 1 << 8
+		};
+
+		// Plain data without padding, compared with memcmp
+		struct State {
+			u32 enables;
+			u32 enablesSet;
+			u32 cullFace;
+			u32 depthMask;
+			u32 depthCompare;
+			s32 viewport[4];
+			s32 scissor[4];
+			u32 blending[2];
+			f32 blendColor[4];
+			f32 polygonOffset[2];
+		};
+
+		u32 _enableBit(graphics::Parameter _parameter) const;
+
+		CachedFunctions & m_cachedFunctions;
+		RenderStateCounters & m_counters;
+		State m_pending;
+		State m_bound;
+		u32 m_fields;
+		bool m_boundValid;
+	};
+
 	/*---------------CachedFunctions-------------*/
 
 	class CachedFunctions
@@ -252,6 +333,8 @@ namespace opengl {
 
 		CachedBlendColor * getCachedBlendColor();
 
+		CachedPolygonOffset * getCachedPolygonOffset();
+
 		CachedClearColor * getCachedClearColor();
 
 		CachedVertexAttribArray * getCachedVertexAttribArray();
@@ -262,6 +345,10 @@ namespace opengl {
 
 		TextureParams * getTexParams();
 
+		CachedRenderState * getCachedRenderState();
+
+		RenderStateCounters * getRenderStateCounters();
+
 	private:
 		typedef std::unordered_map<u32, CachedEnable> EnableParameters;
 
@@ -278,10 +365,13 @@ namespace opengl {
 		CachedScissor m_scissor;
 		CachedBlending m_blending;
 		CachedBlendColor m_blendColor;
+		CachedPolygonOffset m_polygonOffset;
 		CachedClearColor m_clearColor;
 		CachedVertexAttribArray m_attribArray;
 		CachedUseProgram m_useProgram;
 		CachedTextureUnpackAlignment m_unpackAlignment;
+		RenderStateCounters m_counters;
+		CachedRenderState m_renderState;
 	};
 
 }
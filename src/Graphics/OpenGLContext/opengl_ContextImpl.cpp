@@ -9,10 +9,12 @@
 #include "opengl_ColorBufferReaderWithBufferStorage.h"
 #include "opengl_ColorBufferReaderWithEGLImage.h"
 #include "opengl_ColorBufferReaderWithReadPixels.h"
+#include "opengl_PixelWriteBufferWithBufferStorage.h"
 #include "opengl_Utils.h"
 #include "GLSL/glsl_CombinerProgramBuilder.h"
 #include "GLSL/glsl_SpecialShadersFactory.h"
 #include "GLSL/glsl_ShaderStorage.h"
+#include "GLSL/glsl_CombinerUniformBlocks.h"
 
 using namespace opengl;
 
@@ -67,6 +69,9 @@ void ContextImpl::init()
 			m_graphicsDrawer.reset(new UnbufferedDrawer(m_glInfo, m_cachedFunctions->getCachedVertexAttribArray()));
 	}
 
+	if (glsl::CombinerUniformBlocks::Check(m_glInfo))
+		m_uniformBlocks.reset(new glsl::CombinerUniformBlocks(m_glInfo, m_cachedFunctions->getCachedBindBuffer()));
+
 	resetCombinerProgramBuilder();
 }
 
@@ -82,6 +87,7 @@ void ContextImpl::destroy()
 	m_addFramebufferRenderTarget.reset();
 	m_graphicsDrawer.reset();
 	m_combinerProgramBuilder.reset();
+	m_uniformBlocks.reset();
 
 	m_cachedFunctions.reset();
 }
@@ -114,53 +120,58 @@ graphics::ClampMode ContextImpl::getClampMode()
 
 void ContextImpl::enable(graphics::EnableParam _parameter, bool _enable)
 {
-	m_cachedFunctions->getCachedEnable(_parameter)->enable(_enable);
+	if (!m_cachedFunctions->getCachedRenderState()->enable(_parameter, _enable))
+		m_cachedFunctions->getCachedEnable(_parameter)->enable(_enable);
 }
 
 u32 ContextImpl::isEnabled(graphics::EnableParam _parameter)
 {
+	u32 enabled = 0;
+	if (m_cachedFunctions->getCachedRenderState()->isEnabled(_parameter, enabled))
+		return enabled;
 	return m_cachedFunctions->getCachedEnable(_parameter)->get();
 }
 
 void ContextImpl::cullFace(graphics::CullModeParam _mode)
 {
-	m_cachedFunctions->getCachedCullFace()->setCullFace(_mode);
+	m_cachedFunctions->getCachedRenderState()->setCullFace(_mode);
 }
 
 void ContextImpl::enableDepthWrite(bool _enable)
 {
-	m_cachedFunctions->getCachedDepthMask()->setDepthMask(_enable);
+	m_cachedFunctions->getCachedRenderState()->setDepthMask(_enable);
 }
 
 void ContextImpl::setDepthCompare(graphics::CompareParam _mode)
 {
-	m_cachedFunctions->getCachedDepthCompare()->setDepthCompare(_mode);
+	m_cachedFunctions->getCachedRenderState()->setDepthCompare(_mode);
 }
 
 void ContextImpl::setViewport(s32 _x, s32 _y, s32 _width, s32 _height)
 {
-	m_cachedFunctions->getCachedViewport()->setViewport(_x, _y, _width, _height);
+	m_cachedFunctions->getCachedRenderState()->setViewport(_x, _y, _width, _height);
 }
 
 void ContextImpl::setScissor(s32 _x, s32 _y, s32 _width, s32 _height)
 {
-	m_cachedFunctions->getCachedScissor()->setScissor(_x, _y, _width, _height);
+	m_cachedFunctions->getCachedRenderState()->setScissor(_x, _y, _width, _height);
 }
 
 void ContextImpl::setBlending(graphics::BlendParam _sfactor, graphics::BlendParam _dfactor)
 {
-	m_cachedFunctions->getCachedBlending()->setBlending(_sfactor, _dfactor);
+	m_cachedFunctions->getCachedRenderState()->setBlending(_sfactor, _dfactor);
 }
 
 void ContextImpl::setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 {
-	m_cachedFunctions->getCachedBlendColor()->setBlendColor(_red, _green, _blue, _alpha);
+	m_cachedFunctions->getCachedRenderState()->setBlendColor(_red, _green, _blue, _alpha);
 }
 
 void ContextImpl::clearColorBuffer(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 {
-	CachedEnable * enableScissor = m_cachedFunctions->getCachedEnable(graphics::enable::SCISSOR_TEST);
-	enableScissor->enable(false);
+	CachedRenderState * renderState = m_cachedFunctions->getCachedRenderState();
+	renderState->enable(graphics::enable::SCISSOR_TEST, false);
+	renderState->apply();
 
 	if (m_glInfo.isGLES2) {
 		m_cachedFunctions->getCachedClearColor()->setClearColor(_red, _green, _blue, _alpha);
@@ -170,29 +181,46 @@ void ContextImpl::clearColorBuffer(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 		glClearBufferfv(GL_COLOR, 0, values);
 	}
 
-	enableScissor->enable(true);
+	renderState->enable(graphics::enable::SCISSOR_TEST, true);
 }
 
 void ContextImpl::clearDepthBuffer()
 {
-	CachedEnable * enableScissor = m_cachedFunctions->getCachedEnable(graphics::enable::SCISSOR_TEST);
-	CachedDepthMask * depthMask = m_cachedFunctions->getCachedDepthMask();
-	enableScissor->enable(false);
+	CachedRenderState * renderState = m_cachedFunctions->getCachedRenderState();
+	renderState->enable(graphics::enable::SCISSOR_TEST, false);
 
 	if (m_glInfo.renderer == Renderer::PowerVR) {
-		depthMask->setDepthMask(false);
+		renderState->setDepthMask(false);
+		renderState->apply();
 		glClear(GL_DEPTH_BUFFER_BIT);
 	}
 
-	depthMask->setDepthMask(true);
+	renderState->setDepthMask(true);
+	renderState->apply();
 	glClear(GL_DEPTH_BUFFER_BIT);
 
-	enableScissor->enable(true);
+	renderState->enable(graphics::enable::SCISSOR_TEST, true);
 }
 
 void ContextImpl::setPolygonOffset(f32 _factor, f32 _units)
 {
-	glPolygonOffset(_factor, _units);
+	m_cachedFunctions->getCachedRenderState()->setPolygonOffset(_factor, _units);
+}
+
+graphics::Context::RenderStateStatistics ContextImpl::getRenderStateStatistics() const
+{
+	const RenderStateCounters * counters = m_cachedFunctions->getRenderStateCounters();
+	graphics::Context::RenderStateStatistics statistics;
+	statistics.stateCalls = counters->stateCalls;
+	statistics.stateElided = counters->stateRequests > counters->stateCalls ? counters->stateRequests - counters->stateCalls : 0;
+	statistics.texParamsCalls = counters->texParamsCalls;
+	statistics.texParamsElided = counters->texParamsElided;
+	return statistics;
+}
+
+void ContextImpl::resetRenderStateStatistics()
+{
+	*m_cachedFunctions->getRenderStateCounters() = RenderStateCounters();
 }
 
 /*---------------Texture-------------*/
@@ -221,6 +249,19 @@ void ContextImpl::update2DTexture(const graphics::Context::UpdateTextureDataPara
 	m_update2DTexture->update2DTexture(_params);
 }
 
+void ContextImpl::init2DCompressedTexture(const graphics::Context::InitCompressedTextureParams & _params)
+{
+	m_cachedFunctions->getCachedBindTexture()->bind(_params.textureUnitIndex, graphics::textureTarget::TEXTURE_2D, _params.handle);
+	glCompressedTexImage2D(GL_TEXTURE_2D,
+						   _params.mipMapLevel,
+						   GLenum(_params.internalFormat),
+						   _params.width,
+						   _params.height,
+						   0,
+						   _params.dataSize,
+						   _params.data);
+}
+
 void ContextImpl::setTextureParameters(const graphics::Context::TexParameters & _parameters)
 {
 	m_set2DTextureParameters->setTextureParameters(_parameters);
@@ -303,8 +344,9 @@ void ContextImpl::deleteFramebuffer(graphics::ObjectHandle _name)
 void ContextImpl::bindFramebuffer(graphics::BufferTargetParam _target, graphics::ObjectHandle _name)
 {
 	if (m_glInfo.renderer == Renderer::VideoCore) {
-		CachedDepthMask * depthMask = m_cachedFunctions->getCachedDepthMask();
-		depthMask->setDepthMask(true);
+		CachedRenderState * renderState = m_cachedFunctions->getCachedRenderState();
+		renderState->setDepthMask(true);
+		renderState->apply();
 		glClear(GL_DEPTH_BUFFER_BIT);
 	}
 	m_cachedFunctions->getCachedBindFramebuffer()->bind(_target, _name);
@@ -343,6 +385,13 @@ graphics::PixelReadBuffer * ContextImpl::createPixelReadBuffer(size_t _sizeInByt
 	return nullptr;
 }
 
+graphics::PixelWriteBuffer * ContextImpl::createPixelWriteBuffer(size_t _sizeInBytes)
+{
+	if (m_glInfo.bufferStorage && !m_glInfo.isGLES2)
+		return new PixelWriteBufferWithBufferStorage(_sizeInBytes, m_cachedFunctions->getCachedBindBuffer());
+	return nullptr;
+}
+
 graphics::ColorBufferReader * ContextImpl::createColorBufferReader(CachedTexture * _pTexture)
 {
 	if (m_glInfo.bufferStorage && m_glInfo.renderer != Renderer::Intel)
@@ -372,7 +421,8 @@ void ContextImpl::resetCombinerProgramBuilder()
 {
 	if (!isCombinerProgramBuilderObsolete())
 		return;
-	m_combinerProgramBuilder.reset(new glsl::CombinerProgramBuilder(m_glInfo, m_cachedFunctions->getCachedUseProgram()));
+	m_combinerProgramBuilder.reset(new glsl::CombinerProgramBuilder(m_glInfo, m_cachedFunctions->getCachedUseProgram(),
+		m_uniformBlocks.get()));
 	m_specialShadersFactory.reset(new glsl::SpecialShadersFactory(m_glInfo,
 		m_cachedFunctions->getCachedUseProgram(),
 		m_combinerProgramBuilder->getVertexShaderHeader(),
@@ -387,13 +437,13 @@ graphics::CombinerProgram * ContextImpl::createCombinerProgram(Combiner & _color
 
 bool ContextImpl::saveShadersStorage(const graphics::Combiners & _combiners)
 {
-	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram());
+	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram(), m_uniformBlocks.get());
 	return storage.saveShadersStorage(_combiners);
 }
 
 bool ContextImpl::loadShadersStorage(graphics::Combiners & _combiners)
 {
-	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram());
+	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram(), m_uniformBlocks.get());
 	return storage.loadShadersStorage(_combiners);
 }
 
@@ -437,6 +487,16 @@ graphics::TextDrawerShaderProgram * ContextImpl::createTextDrawerShader()
 	return m_specialShadersFactory->createTextDrawerShader();
 }
 
+graphics::BufferPackShaderProgram * ContextImpl::createColorBufferPackShader()
+{
+	return m_specialShadersFactory->createColorBufferPackShader();
+}
+
+graphics::BufferPackShaderProgram * ContextImpl::createDepthBufferPackShader()
+{
+	return m_specialShadersFactory->createDepthBufferPackShader();
+}
+
 void ContextImpl::resetShaderProgram()
 {
 	m_cachedFunctions->getCachedUseProgram()->useProgram(graphics::ObjectHandle::null);
@@ -444,16 +504,19 @@ void ContextImpl::resetShaderProgram()
 
 void ContextImpl::drawTriangles(const graphics::Context::DrawTriangleParameters & _params)
 {
+	m_cachedFunctions->getCachedRenderState()->apply();
 	m_graphicsDrawer->drawTriangles(_params);
 }
 
 void ContextImpl::drawRects(const graphics::Context::DrawRectParameters & _params)
 {
+	m_cachedFunctions->getCachedRenderState()->apply();
 	m_graphicsDrawer->drawRects(_params);
 }
 
 void ContextImpl::drawLine(f32 _width, SPVertex * _vertices)
 {
+	m_cachedFunctions->getCachedRenderState()->apply();
 	m_graphicsDrawer->drawLine(_width, _vertices);
 }
 
@@ -488,6 +551,14 @@ bool ContextImpl::isSupported(graphics::SpecialFeatures _feature) const
 		return m_glInfo.ext_fetch;
 	case graphics::SpecialFeatures::TextureBarrier:
 		return m_glInfo.texture_barrier || m_glInfo.texture_barrierNV;
+	case graphics::SpecialFeatures::TextureCompressionS3TC:
+		return m_glInfo.s3tc;
+	case graphics::SpecialFeatures::TextureCompressionBPTC:
+		return m_glInfo.bptc;
+	case graphics::SpecialFeatures::TextureCompressionETC2:
+		return m_glInfo.etc2;
+	case graphics::SpecialFeatures::TextureCompressionASTC:
+		return m_glInfo.astc;
 	}
 	return false;
 }
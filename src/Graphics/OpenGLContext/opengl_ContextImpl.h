@@ -9,6 +9,7 @@
 
 namespace glsl {
 	class CombinerProgramBuilder;
+	class CombinerUniformBlocks;
 	class SpecialShadersFactory;
 }
 
@@ -52,6 +53,10 @@ namespace opengl {
 
 		void setPolygonOffset(f32 _factor, f32 _units) override;
 
+		graphics::Context::RenderStateStatistics getRenderStateStatistics() const override;
+
+		void resetRenderStateStatistics() override;
+
 		/*---------------Texture-------------*/
 
 		graphics::ObjectHandle createTexture(graphics::Parameter _target) override;
@@ -62,6 +67,8 @@ namespace opengl {
 
 		void update2DTexture(const graphics::Context::UpdateTextureDataParams & _params) override;
 
+		void init2DCompressedTexture(const graphics::Context::InitCompressedTextureParams & _params) override;
+
 		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override;
 
 		void bindTexture(const graphics::Context::BindTextureParameters & _params) override;
@@ -102,6 +109,8 @@ namespace opengl {
 
 		graphics::PixelReadBuffer * createPixelReadBuffer(size_t _sizeInBytes) override;
 
+		graphics::PixelWriteBuffer * createPixelWriteBuffer(size_t _sizeInBytes) override;
+
 		graphics::ColorBufferReader * createColorBufferReader(CachedTexture * _pTexture) override;
 
 		/*---------------Shaders-------------*/
@@ -132,6 +141,10 @@ namespace opengl {
 
 		graphics::TextDrawerShaderProgram * createTextDrawerShader() override;
 
+		graphics::BufferPackShaderProgram * createColorBufferPackShader() override;
+
+		graphics::BufferPackShaderProgram * createDepthBufferPackShader() override;
+
 		void resetShaderProgram() override;
 
 		void drawTriangles(const graphics::Context::DrawTriangleParameters & _params) override;
@@ -165,6 +178,7 @@ namespace opengl {
 
 		std::unique_ptr<GraphicsDrawer> m_graphicsDrawer;
 
+		std::unique_ptr<glsl::CombinerUniformBlocks> m_uniformBlocks;
 		std::unique_ptr<glsl::CombinerProgramBuilder> m_combinerProgramBuilder;
 		std::unique_ptr<glsl::SpecialShadersFactory> m_specialShadersFactory;
 		GLInfo m_glInfo;
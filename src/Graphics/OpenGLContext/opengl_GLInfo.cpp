@@ -142,6 +142,14 @@ void GLInfo::init() {
 
 	ext_fetch = Utils::isExtensionSupported(*this, "GL_EXT_shader_framebuffer_fetch") && !isGLES2 && (!isGLESX || ext_draw_buffers_indexed) && !imageTextures;
 
+	s3tc = Utils::isExtensionSupported(*this, "GL_EXT_texture_compression_s3tc");
+	bptc = (!isGLESX && numericVersion >= 42) || Utils::isExtensionSupported(*this, "GL_ARB_texture_compression_bptc") ||
+		Utils::isExtensionSupported(*this, "GL_EXT_texture_compression_bptc");
+	etc2 = (isGLESX && numericVersion >= 30) || (!isGLESX && numericVersion >= 43) ||
+		Utils::isExtensionSupported(*this, "GL_ARB_ES3_compatibility");
+	astc = (isGLESX && numericVersion >= 32) || Utils::isExtensionSupported(*this, "GL_KHR_texture_compression_astc_ldr");
+	LOG(LOG_VERBOSE, "Compressed textures: S3TC %d, BPTC %d, ETC2 %d, ASTC %d\n", s3tc, bptc, etc2, astc);
+
 	if (config.frameBufferEmulation.N64DepthCompare != 0) {
 		if (!imageTextures && !ext_fetch) {
 			config.frameBufferEmulation.N64DepthCompare = 0;
@@ -33,6 +33,10 @@ struct GLInfo {
 	bool fragment_interlockNV = false;
 	bool fragment_ordering = false;
 	bool ext_fetch = false;
+	bool s3tc = false;
+	bool bptc = false;
+	bool etc2 = false;
+	bool astc = false;
 	Renderer renderer = Renderer::Other;
 
 	void init();
@@ -24,6 +24,12 @@ namespace graphics {
 		InternalColorFormatParam RG32F(GL_RG32F);
 		InternalColorFormatParam LUMINANCE(0x1909);
 		InternalColorFormatParam COLOR_INDEX8(0x80E5);
+		InternalColorFormatParam COMPRESSED_RGBA_BC1(0x83F1);
+		InternalColorFormatParam COMPRESSED_RGBA_BC2(0x83F2);
+		InternalColorFormatParam COMPRESSED_RGBA_BC3(0x83F3);
+		InternalColorFormatParam COMPRESSED_RGBA_BC7(0x8E8C);
+		InternalColorFormatParam COMPRESSED_RGBA8_ETC2(0x9278);
+		InternalColorFormatParam COMPRESSED_RGBA_ASTC_4x4(0x93B0);
 	}
 
 	namespace datatype {
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <Graphics/Parameter.h>
+#include "opengl_PixelWriteBufferWithBufferStorage.h"
+
+using namespace graphics;
+using namespace opengl;
+
+static const size_t writeAlignment = 16;
+// Writes start at this offset or later. getData() returns the offset as a pointer,
+// and texture upload paths treat a null pointer as "no data".
+static const size_t ringStart = writeAlignment;
+
+PixelWriteBufferWithBufferStorage::PixelWriteBufferWithBufferStorage(size_t _size, CachedBindBuffer * _bindBuffer)
+	: m_bindBuffer(_bindBuffer)
+	, m_PBO(0)
+	, m_pData(nullptr)
+	, m_size(_size + ringStart)
+	, m_head(ringStart)
+	, m_writeStart(ringStart)
+	, m_writeSize(0)
+{
+	glGenBuffers(1, &m_PBO);
+	m_bindBuffer->bind(Parameter(GL_PIXEL_UNPACK_BUFFER), ObjectHandle(m_PBO));
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_size, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+	m_pData = reinterpret_cast<u8*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_size,
+		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+	m_bindBuffer->bind(Parameter(GL_PIXEL_UNPACK_BUFFER), ObjectHandle::null);
+}
+
+PixelWriteBufferWithBufferStorage::~PixelWriteBufferWithBufferStorage()
+{
+	for (const Region & region : m_regions)
+		glDeleteSync(region.fence);
+	m_regions.clear();
+
+	glDeleteBuffers(1, &m_PBO);
+	m_PBO = 0;
+	m_pData = nullptr;
+}
+
+void PixelWriteBufferWithBufferStorage::_waitForRegions(size_t _start, size_t _end)
+{
+	// Regions are released in the order they were written, so every region up to
+	// the last one overlapping [_start, _end) is waited for.
+	auto overlaps = [_start, _end](const Region & _region) {
+		return _region.start < _end && _region.end > _start;
+	};
+	while (std::any_of(m_regions.begin(), m_regions.end(), overlaps)) {
+		const GLsync fence = m_regions.front().fence;
+		GLenum res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+		while (res == GL_TIMEOUT_EXPIRED)
+			res = glClientWaitSync(fence, 0, 100000000);
+		glDeleteSync(fence);
+		m_regions.pop_front();
+	}
+}
+
+void * PixelWriteBufferWithBufferStorage::getWriteBuffer(size_t _size)
+{
+	if (m_pData == nullptr || _size == 0 || _size > m_size - ringStart)
+		return nullptr;
+
+	size_t start = (m_head + writeAlignment - 1) & ~(writeAlignment - 1);
+	if (start + _size > m_size)
+		start = ringStart;
+
+	_waitForRegions(start, start + _size);
+
+	m_writeStart = start;
+	m_writeSize = _size;
+	return m_pData + start;
+}
+
+const void * PixelWriteBufferWithBufferStorage::getData() const
+{
+	return reinterpret_cast<const void*>(m_writeStart);
+}
+
+void PixelWriteBufferWithBufferStorage::closeWriteBuffer()
+{
+	if (m_writeSize == 0)
+		return;
+
+	const size_t end = m_writeStart + m_writeSize;
+	m_regions.push_back({ m_writeStart, end, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+	m_head = end;
+	m_writeSize = 0;
+}
+
+void PixelWriteBufferWithBufferStorage::bind()
+{
+	m_bindBuffer->bind(Parameter(GL_PIXEL_UNPACK_BUFFER), ObjectHandle(m_PBO));
+}
+
+void PixelWriteBufferWithBufferStorage::unbind()
+{
+	m_bindBuffer->bind(Parameter(GL_PIXEL_UNPACK_BUFFER), ObjectHandle::null);
+}
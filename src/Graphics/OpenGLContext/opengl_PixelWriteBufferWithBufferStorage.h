@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+#include <Graphics/PixelBuffer.h>
+#include "opengl_CachedFunctions.h"
+
+namespace opengl {
+
+	// Persistently mapped pixel unpack buffer used as a ring.
+	// Each closed write is fenced; its range is reused once the fence signals.
+	class PixelWriteBufferWithBufferStorage : public graphics::PixelWriteBuffer
+	{
+	public:
+		PixelWriteBufferWithBufferStorage(size_t _size, CachedBindBuffer * _bindBuffer);
+		~PixelWriteBufferWithBufferStorage();
+
+		void * getWriteBuffer(size_t _size) override;
+
+		const void * getData() const override;
+
+		void closeWriteBuffer() override;
+
+		void bind() override;
+
+		void unbind() override;
+
+	private:
+		struct Region
+		{
+			size_t start;
+			size_t end;
+			GLsync fence;
+		};
+
+		void _waitForRegions(size_t _start, size_t _end);
+
+		CachedBindBuffer * m_bindBuffer;
+		GLuint m_PBO;
+		u8 * m_pData;
+		size_t m_size;
+		size_t m_head;
+		size_t m_writeStart;
+		size_t m_writeSize;
+		std::deque<Region> m_regions; // oldest in the front
+	};
+
+}
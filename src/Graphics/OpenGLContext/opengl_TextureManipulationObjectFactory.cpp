@@ -258,51 +258,70 @@ namespace opengl {
 
 	/*---------------Set2DTextureParameters-------------*/
 
+	// Passes on the parameters which differ from the ones cached for the texture
+	template<typename SetInt, typename SetFloat>
+	static void updateTextureParameters(TextureParams * _texparams,
+		RenderStateCounters * _counters,
+		const graphics::Context::TexParameters & _parameters,
+		bool _supportMipmapLevel,
+		SetInt _setInt,
+		SetFloat _setFloat)
+	{
+		texture_params & cached = (*_texparams)[u32(_parameters.handle)];
+		auto update = [_counters, &_setInt](GLenum _name, GLint & _cached, const graphics::Parameter & _value) {
+			if (!_value.isValid())
+				return;
+			if (_cached == GLint(_value)) {
+				++_counters->texParamsElided;
+				return;
+			}
+			_cached = GLint(_value);
+			_setInt(_name, _cached);
+			++_counters->texParamsCalls;
+		};
+
+		update(GL_TEXTURE_MAG_FILTER, cached.magFilter, _parameters.magFilter);
+		update(GL_TEXTURE_MIN_FILTER, cached.minFilter, _parameters.minFilter);
+		update(GL_TEXTURE_WRAP_S, cached.wrapS, _parameters.wrapS);
+		update(GL_TEXTURE_WRAP_T, cached.wrapT, _parameters.wrapT);
+		if (_supportMipmapLevel)
+			update(GL_TEXTURE_MAX_LEVEL, cached.maxMipmapLevel, _parameters.maxMipmapLevel);
+		if (_parameters.maxAnisotropy.isValid()) {
+			if (cached.maxAnisotropy == GLfloat(_parameters.maxAnisotropy)) {
+				++_counters->texParamsElided;
+			} else {
+				cached.maxAnisotropy = GLfloat(_parameters.maxAnisotropy);
+				_setFloat(GL_TEXTURE_MAX_ANISOTROPY_EXT, cached.maxAnisotropy);
+				++_counters->texParamsCalls;
+			}
+		}
+	}
+
 	class SetTexParameters : public Set2DTextureParameters
 	{
 	public:
-		SetTexParameters(CachedBindTexture* _bind, TextureParams * _texparams, bool _supportMipmapLevel)
+		SetTexParameters(CachedBindTexture* _bind, TextureParams * _texparams,
+			RenderStateCounters * _counters, bool _supportMipmapLevel)
 			: m_bind(_bind)
 			, m_texparams(_texparams)
+			, m_counters(_counters)
 			, m_supportMipmapLevel(_supportMipmapLevel) {
 		}
 
 		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override
 		{
-			TextureParams::const_iterator iter = m_texparams->find(u32(_parameters.handle));
 			m_bind->bind(_parameters.textureUnitIndex, _parameters.target, _parameters.handle);
 
-			const bool iterValid = iter != m_texparams->end();
 			const GLenum target(_parameters.target);
-			if (_parameters.magFilter.isValid() && !(iterValid && iter->second.magFilter == GLint(_parameters.magFilter))) {
-				glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GLint(_parameters.magFilter));
-				(*m_texparams)[u32(_parameters.handle)].magFilter = GLint(_parameters.magFilter);
-			}
-			if (_parameters.minFilter.isValid() && !(iterValid && iter->second.minFilter == GLint(_parameters.minFilter))) {
-				glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GLint(_parameters.minFilter));
-				(*m_texparams)[u32(_parameters.handle)].minFilter = GLint(_parameters.minFilter);
-			}
-			if (_parameters.wrapS.isValid() && !(iterValid && iter->second.wrapS == GLint(_parameters.wrapS))) {
-				glTexParameteri(target, GL_TEXTURE_WRAP_S, GLint(_parameters.wrapS));
-				(*m_texparams)[u32(_parameters.handle)].wrapS = GLint(_parameters.wrapS);
-			}
-			if (_parameters.wrapT.isValid() && !(iterValid && iter->second.wrapT == GLint(_parameters.wrapT))) {
-				glTexParameteri(target, GL_TEXTURE_WRAP_T, GLint(_parameters.wrapT));
-				(*m_texparams)[u32(_parameters.handle)].wrapT = GLint(_parameters.wrapT);
-			}
-			if (m_supportMipmapLevel && _parameters.maxMipmapLevel.isValid() && !(iterValid && iter->second.maxMipmapLevel == GLint(_parameters.maxMipmapLevel))) {
-				glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, GLint(_parameters.maxMipmapLevel));
-				(*m_texparams)[u32(_parameters.handle)].maxMipmapLevel = GLint(_parameters.maxMipmapLevel);
-			}
-			if (_parameters.maxAnisotropy.isValid() && !(iterValid && iter->second.maxAnisotropy == GLfloat(_parameters.maxAnisotropy))) {
-				glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, GLfloat(_parameters.maxMipmapLevel));
-				(*m_texparams)[u32(_parameters.handle)].maxAnisotropy = GLfloat(_parameters.maxMipmapLevel);
-			}
+			updateTextureParameters(m_texparams, m_counters, _parameters, m_supportMipmapLevel,
+				[target](GLenum _name, GLint _value) { glTexParameteri(target, _name, _value); },
+				[target](GLenum _name, GLfloat _value) { glTexParameterf(target, _name, _value); });
 		}
 
 	private:
 		CachedBindTexture* m_bind;
 		TextureParams* m_texparams;
+		RenderStateCounters * m_counters;
 		bool m_supportMipmapLevel;
 	};
 
@@ -318,36 +337,22 @@ namespace opengl {
 #endif
 		}
 
-		SetTextureParameters() {}
+		SetTextureParameters(TextureParams * _texparams, RenderStateCounters * _counters)
+			: m_texparams(_texparams)
+			, m_counters(_counters) {
+		}
 
 		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override
 		{
-			const u32 handle(_parameters.handle);
-			auto it = m_parameters.find(handle);
-			// TODO make cacheable
-			if (it == m_parameters.end()) {
-				auto res = m_parameters.emplace(handle, _parameters);
-				if (res.second)
-					it = res.first;
-			}
-
-			if (_parameters.magFilter.isValid())
-				glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GLint(_parameters.magFilter));
-			if (_parameters.minFilter.isValid())
-				glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GLint(_parameters.minFilter));
-			if (_parameters.wrapS.isValid())
-				glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GLint(_parameters.wrapS));
-			if (_parameters.wrapT.isValid())
-				glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GLint(_parameters.wrapT));
-			if (_parameters.maxMipmapLevel.isValid())
-				glTextureParameteri(handle, GL_TEXTURE_MAX_LEVEL, GLint(_parameters.maxMipmapLevel));
-			if (_parameters.maxAnisotropy.isValid())
-				glTextureParameterf(handle, GL_TEXTURE_MAX_ANISOTROPY_EXT, GLfloat(_parameters.maxAnisotropy));
+			const GLuint handle(_parameters.handle);
+			updateTextureParameters(m_texparams, m_counters, _parameters, true,
+				[handle](GLenum _name, GLint _value) { glTextureParameteri(handle, _name, _value); },
+				[handle](GLenum _name, GLfloat _value) { glTextureParameterf(handle, _name, _value); });
 		}
 
 	private:
-		typedef std::unordered_map<u32, graphics::Context::TexParameters> TextureParameters;
-		TextureParameters m_parameters;
+		TextureParams* m_texparams;
+		RenderStateCounters * m_counters;
 	};
 
 	/*---------------TextureManipulationObjectFactory-------------*/
@@ -393,9 +398,10 @@ namespace opengl {
 	Set2DTextureParameters * TextureManipulationObjectFactory::getSet2DTextureParameters() const
 	{
 		if (SetTextureParameters::Check(m_glInfo))
-			return new SetTextureParameters;
+			return new SetTextureParameters(m_cachedFunctions.getTexParams(), m_cachedFunctions.getRenderStateCounters());
 
-		return new SetTexParameters(m_cachedFunctions.getCachedBindTexture(), m_cachedFunctions.getTexParams(), !m_glInfo.isGLES2);
+		return new SetTexParameters(m_cachedFunctions.getCachedBindTexture(), m_cachedFunctions.getTexParams(),
+			m_cachedFunctions.getRenderStateCounters(), !m_glInfo.isGLES2);
 	}
 
 }
@@ -21,8 +21,7 @@ private:
 	bool _start() override;
 	void _stop() override;
 	void _swapBuffers() override;
-	void _saveScreenshot() override;
-	void _saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture *_pTexture) override;
+	void _saveScreenshot(u32 _width, u32 _height, const u8 * _data) override;
 	bool _resizeWindow() override;
 	void _changeWindow() override;
 	void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) override;
@@ -159,41 +158,9 @@ void DisplayWindowWindows::_swapBuffers()
 		SwapBuffers( hDC );
 }
 
-void DisplayWindowWindows::_saveScreenshot()
+void DisplayWindowWindows::_saveScreenshot(u32 _width, u32 _height, const u8 * _data)
 {
-	unsigned char * pixelData = NULL;
-	GLint oldMode;
-	glGetIntegerv(GL_READ_BUFFER, &oldMode);
-	gfxContext.bindFramebuffer(graphics::bufferTarget::READ_FRAMEBUFFER, graphics::ObjectHandle::defaultFramebuffer);
-	glReadBuffer(GL_FRONT);
-	pixelData = (unsigned char*)malloc(m_screenWidth * m_screenHeight * 3);
-	glReadPixels(0, m_heightOffset, m_screenWidth, m_screenHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelData);
-	if (graphics::BufferAttachmentParam(oldMode) == graphics::bufferAttachment::COLOR_ATTACHMENT0) {
-		FrameBuffer * pBuffer = frameBufferList().getCurrent();
-		if (pBuffer != nullptr)
-			gfxContext.bindFramebuffer(graphics::bufferTarget::READ_FRAMEBUFFER, pBuffer->m_FBO);
-	}
-	glReadBuffer(oldMode);
-	SaveScreenshot(m_strScreenDirectory, RSP.romname, m_screenWidth, m_screenHeight, pixelData);
-	free( pixelData );
-}
-
-void DisplayWindowWindows::_saveBufferContent(graphics::ObjectHandle _fbo, CachedTexture *_pTexture)
-{
-	unsigned char * pixelData = NULL;
-	GLint oldMode;
-	glGetIntegerv(GL_READ_BUFFER, &oldMode);
-	gfxContext.bindFramebuffer(graphics::bufferTarget::READ_FRAMEBUFFER, _fbo);
-	pixelData = (unsigned char*)malloc(_pTexture->realWidth * _pTexture->realHeight * 3);
-	glReadPixels(0, 0, _pTexture->realWidth, _pTexture->realHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelData);
-	if (graphics::BufferAttachmentParam(oldMode) == graphics::bufferAttachment::COLOR_ATTACHMENT0) {
-		FrameBuffer * pCurrentBuffer = frameBufferList().getCurrent();
-		if (pCurrentBuffer != nullptr)
-			gfxContext.bindFramebuffer(graphics::bufferTarget::READ_FRAMEBUFFER, pCurrentBuffer->m_FBO);
-	}
-	glReadBuffer(oldMode);
-	SaveScreenshot(m_strScreenDirectory, RSP.romname, _pTexture->realWidth, _pTexture->realHeight, pixelData);
-	free(pixelData);
+	SaveScreenshot(m_strScreenDirectory, RSP.romname, _width, _height, _data);
 }
 
 void DisplayWindowWindows::_changeWindow()
@@ -24,6 +24,12 @@ namespace graphics {
 		extern InternalColorFormatParam RG32F;
 		extern InternalColorFormatParam LUMINANCE;
 		extern InternalColorFormatParam COLOR_INDEX8;
+		extern InternalColorFormatParam COMPRESSED_RGBA_BC1;
+		extern InternalColorFormatParam COMPRESSED_RGBA_BC2;
+		extern InternalColorFormatParam COMPRESSED_RGBA_BC3;
+		extern InternalColorFormatParam COMPRESSED_RGBA_BC7;
+		extern InternalColorFormatParam COMPRESSED_RGBA8_ETC2;
+		extern InternalColorFormatParam COMPRESSED_RGBA_ASTC_4x4;
 	}
 
 	namespace datatype {
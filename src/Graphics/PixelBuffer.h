@@ -14,6 +14,22 @@ namespace graphics {
 		virtual void unbind() = 0;
 	};
 
+	// Ring of texel memory the driver reads texture data from.
+	// Texels are written straight into it and uploaded from there.
+	class PixelWriteBuffer
+	{
+	public:
+		virtual ~PixelWriteBuffer() {}
+		// Memory for _size bytes of texels, nullptr if they do not fit.
+		virtual void * getWriteBuffer(size_t _size) = 0;
+		// Texture data parameter for the texels of the last getWriteBuffer, valid while bound.
+		virtual const void * getData() const = 0;
+		// Keeps the texels of the last getWriteBuffer until the driver has read them.
+		virtual void closeWriteBuffer() = 0;
+		virtual void bind() = 0;
+		virtual void unbind() = 0;
+	};
+
 	template<class T>
 	class PixelBufferBinder
 	{
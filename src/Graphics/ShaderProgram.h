@@ -31,4 +31,10 @@ namespace graphics {
 	public:
 		virtual void setTextColor(float * _color) = 0;
 	};
+
+	class BufferPackShaderProgram : public ShaderProgram
+	{
+	public:
+		virtual void setPackParams(u32 _size, s32 _srcY0) = 0;
+	};
 }
@@ -96,6 +96,38 @@ void GraphicsDrawer::addTriangle(int _v0, int _v1, int _v2)
 	}
 }
 
+u32 GraphicsDrawer::rejectTriangles(const s32 * _v, u32 _num) const
+{
+	// Same choice as _updateCullFace. Vertex positions already hold the viewport flips and the
+	// shaders flip y, so a triangle faces back when its clip space area is positive.
+	const u32 cullMode = gSP.geometryMode & G_CULL_BOTH;
+	const bool cullBoth = cullMode == G_CULL_BOTH && GBI.isCullBoth();
+	f32 cullSign = 0.0f;
+	if (!cullBoth && cullMode != 0)
+		cullSign = (cullMode & G_CULL_BACK) == G_CULL_BACK ? 1.0f : -1.0f;
+
+	u32 rejected = 0;
+	for (u32 i = 0; i < _num; ++i) {
+		const SPVertex & vtx0 = triangles.vertices[_v[i * 3]];
+		const SPVertex & vtx1 = triangles.vertices[_v[i * 3 + 1]];
+		const SPVertex & vtx2 = triangles.vertices[_v[i * 3 + 2]];
+		const bool clipped = (vtx0.clip & vtx1.clip & vtx2.clip) != 0;
+
+		// Screen coordinates or a vertex behind the eye: the GPU decides
+		const bool known = (vtx0.modify | vtx1.modify | vtx2.modify) == 0 &&
+			vtx0.w > 0.0f && vtx1.w > 0.0f && vtx2.w > 0.0f;
+
+		// Screen space area times w0*w1*w2, which has the sign of the area
+		const f32 area = vtx0.x * (vtx1.y * vtx2.w - vtx2.y * vtx1.w) -
+			vtx1.x * (vtx0.y * vtx2.w - vtx2.y * vtx0.w) +
+			vtx2.x * (vtx0.y * vtx1.w - vtx1.y * vtx0.w);
+		const bool culled = known && (area == 0.0f || cullBoth || area * cullSign > 0.0f);
+
+		rejected |= u32(clipped || culled) << i;
+	}
+	return rejected;
+}
+
 void GraphicsDrawer::_updateCullFace() const
 {
 	if (gSP.geometryMode & G_CULL_BOTH) {
@@ -709,6 +741,7 @@ void GraphicsDrawer::_updateStates(DrawingState _drawingState) const
 void GraphicsDrawer::_prepareDrawTriangle()
 {
 	m_texrectDrawer.draw();
+	m_texrectAtlas.draw();
 
 	if ((m_modifyVertices & MODIFY_XY) != 0)
 		gSP.changed &= ~CHANGED_VIEWPORT;
@@ -913,6 +946,7 @@ void GraphicsDrawer::_drawThickLine(int _v0, int _v1, float _width)
 void GraphicsDrawer::drawLine(int _v0, int _v1, float _width)
 {
 	m_texrectDrawer.draw();
+	m_texrectAtlas.draw();
 
 	if (!_canDraw())
 		return;
@@ -944,6 +978,7 @@ void GraphicsDrawer::drawLine(int _v0, int _v1, float _width)
 void GraphicsDrawer::drawRect(int _ulx, int _uly, int _lrx, int _lry)
 {
 	m_texrectDrawer.draw();
+	m_texrectAtlas.draw();
 
 	if (!_canDraw())
 		return;
@@ -1145,6 +1180,9 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 	gSP.changed &= ~CHANGED_GEOMETRYMODE; // Don't update cull mode
 	m_drawingState = DrawingState::TexRect;
 
+	if (!_params.texrectCmd || !m_texrectAtlas.canContinue())
+		m_texrectAtlas.draw();
+
 	if (m_texrectDrawer.canContinue()) {
 		CombinerInfo & cmbInfo = CombinerInfo::get();
 		cmbInfo.setPolygonMode(DrawingState::TexRect);
@@ -1154,6 +1192,7 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 	} else {
 		if (!m_texrectDrawer.isEmpty())
 			m_texrectDrawer.draw();
+		m_texrectAtlas.draw();
 		gSP.changed &= ~CHANGED_GEOMETRYMODE; // Don't update cull mode
 		gSP.changed &= ~CHANGED_VIEWPORT; // Don't update viewport
 		if (_params.texrectCmd && (gSP.changed | gDP.changed) != 0)
@@ -1183,6 +1222,16 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 		&& ((cache.current[0]->frameBufferTexture == CachedTexture::fbNone && !cache.current[0]->bHDTexture))
 		&& (cache.current[1] == nullptr || (cache.current[1]->frameBufferTexture == CachedTexture::fbNone && !cache.current[1]->bHDTexture));
 
+	bool bUseTexrectAtlas = !bUseTexrectDrawer
+		&& _params.texrectCmd
+		&& texturedRectSpecial == nullptr
+		&& !g_debugger.isCaptureMode()
+		&& pCurrentCombiner->usesTile(0)
+		&& !pCurrentCombiner->usesTile(1)
+		&& !pCurrentCombiner->usesLOD()
+		&& cache.current[0] != nullptr
+		&& TexrectAtlas::isTextureSupported(cache.current[0]);
+
 	f32 scaleX, scaleY;
 	calcCoordsScales(pCurrentBuffer, scaleX, scaleY);
 	const float Z = (gDP.otherMode.depthSource == G_ZS_PRIM) ? gDP.primDepth.z : 0.0f;
@@ -1290,6 +1339,10 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 					texST[t].t1 >= 0.0f && texST[t].t0 <= (float)cache.current[t]->height))
 					texParams.wrapT = textureParameters::WRAP_CLAMP_TO_EDGE;
 
+				// The atlas keeps clamped textures only
+				if (t == 0 && !(texParams.wrapS.isValid() && texParams.wrapT.isValid()))
+					bUseTexrectAtlas = false;
+
 				if (texParams.wrapS.isValid() || texParams.wrapT.isValid()) {
 					texParams.handle = cache.current[t]->name;
 					texParams.target = textureTarget::TEXTURE_2D;
@@ -1360,6 +1413,13 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 		return;
 
 	_updateScreenCoordsViewport(_params.pBuffer);
+
+	if (bUseTexrectAtlas && m_texrectAtlas.add(m_rect, cache.current[0])) {
+		gSP.changed |= CHANGED_GEOMETRYMODE | CHANGED_VIEWPORT;
+		return;
+	}
+	m_texrectAtlas.draw();
+
 	Context::DrawRectParameters rectParams;
 	rectParams.mode = drawmode::TRIANGLE_STRIP;
 	rectParams.verticesCount = 4;
@@ -1739,6 +1799,7 @@ void GraphicsDrawer::_initData()
 	perf.reset();
 	FBInfo::fbInfo.reset();
 	m_texrectDrawer.init();
+	m_texrectAtlas.init();
 	m_drawingState = DrawingState::Non;
 	m_maxLineWidth = gfxContext.getMaxLineWidth();
 
@@ -1756,6 +1817,7 @@ void GraphicsDrawer::_destroyData()
 {
 	m_drawingState = DrawingState::Non;
 	m_texrectDrawer.destroy();
+	m_texrectAtlas.destroy();
 	g_paletteTexture.destroy();
 	g_zlutTexture.destroy();
 	g_noiseTexture.destroy();
@@ -7,6 +7,7 @@
 #include <string>
 #include "gSP.h"
 #include "TexrectDrawer.h"
+#include "TexrectAtlas.h"
 #include "Graphics/ObjectHandle.h"
 #include "Graphics/Parameters.h"
 
@@ -132,6 +133,10 @@ public:
 		return (triangles.vertices[_v0].clip & triangles.vertices[_v1].clip & triangles.vertices[_v2].clip) != 0;
 	}
 
+	// Returns a bit per triangle of _v which the GPU would not draw:
+	// outside one clip plane, facing the culled side or without area. _num <= 32.
+	u32 rejectTriangles(const s32 * _v, u32 _num) const;
+
 	SPVertex & getVertex(u32 _v) { return triangles.vertices[_v]; }
 
 	SPVertex * getVertexPtr(u32 _v) { return triangles.vertices.data() + _v; }
@@ -149,7 +154,7 @@ public:
 
 	void dropRenderState() { m_drawingState = DrawingState::Non; }
 
-	void flush() { m_texrectDrawer.draw(); }
+	void flush() { m_texrectDrawer.draw(); m_texrectAtlas.draw(); }
 
 	bool isTexrectDrawerMode() const { return !m_texrectDrawer.isEmpty(); }
 
@@ -190,7 +195,8 @@ private:
 	TexturedRectParams m_texrectParams;
 
 	struct {
-		std::array<SPVertex, VERTBUFF_SIZE> vertices;
+		// Cache line aligned, so that most vertices start with their clip data in one line
+		alignas(64) std::array<SPVertex, VERTBUFF_SIZE> vertices;
 		std::array<u16, ELEMBUFF_SIZE> elements;
 		u32 num = 0;
 		int maxElement = 0;
@@ -205,5 +211,6 @@ private:
 	f32 m_maxLineWidth;
 	bool m_bFlatColors;
 	TexrectDrawer m_texrectDrawer;
+	TexrectAtlas m_texrectAtlas;
 	OSDMessages m_osdMessages;
 };
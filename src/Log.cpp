@@ -1,37 +1,397 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <cwchar>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "Log.h"
 #include "PluginAPI.h"
 #include "wst.h"
 
-void LOG(u16 type, const char * format, ...) {
-	if (type > LOG_LEVEL)
-		return;
+namespace {
+
+	const u32 logRingSize = 256 * 1024; // per logging thread, power of two
+	const u32 logMaxMessage = 1024;
+	const long logMaxFileSize = 4 * 1024 * 1024; // then gliden64.log becomes gliden64.log.1
+	const auto logWriteInterval = std::chrono::milliseconds(50);
+
+	struct LogRecord
+	{
+		u64 time; // ms since epoch
+		u32 size;
+		u16 type;
+	};
+
+	// Single producer, single consumer ring of log records.
+	class LogRing
+	{
+	public:
+		bool push(const LogRecord & _record, const char * _message)
+		{
+			const u32 head = m_head.load(std::memory_order_relaxed);
+			const u32 tail = m_tail.load(std::memory_order_acquire);
+			if (logRingSize - (head - tail) < sizeof(LogRecord) + _record.size) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			_write(head, &_record, sizeof(LogRecord));
+			_write(head + sizeof(LogRecord), _message, _record.size);
+			m_head.store(head + sizeof(LogRecord) + _record.size, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(LogRecord & _record, char * _message)
+		{
+			const u32 tail = m_tail.load(std::memory_order_relaxed);
+			if (tail == m_head.load(std::memory_order_acquire))
+				return false;
+			_read(tail, &_record, sizeof(LogRecord));
+			_read(tail + sizeof(LogRecord), _message, _record.size);
+			m_tail.store(tail + sizeof(LogRecord) + _record.size, std::memory_order_release);
+			return true;
+		}
+
+		bool isFilling() const
+		{
+			return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed) > logRingSize / 4;
+		}
+
+		bool isEmpty() const
+		{
+			return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+		}
+
+		std::atomic<u32> m_dropped{0};
+		std::atomic<bool> m_closed{false}; // the thread has exited
+
+	private:
+		void _write(u32 _pos, const void * _src, u32 _size)
+		{
+			const u32 offset = _pos & (logRingSize - 1);
+			const u32 first = std::min(_size, logRingSize - offset);
+			memcpy(m_data + offset, _src, first);
+			memcpy(m_data, static_cast<const u8*>(_src) + first, _size - first);
+		}
+
+		void _read(u32 _pos, void * _dest, u32 _size) const
+		{
+			const u32 offset = _pos & (logRingSize - 1);
+			const u32 first = std::min(_size, logRingSize - offset);
+			memcpy(_dest, m_data + offset, first);
+			memcpy(static_cast<u8*>(_dest) + first, m_data, _size - first);
+		}
+
+		std::atomic<u32> m_head{0};
+		std::atomic<u32> m_tail{0};
+		u8 m_data[logRingSize];
+	};
+
+	// Threads format messages into their own ring, a writer thread
+	// collects them and appends them to gliden64.log in batches.
+	class Logger
+	{
+	public:
+		static Logger & get()
+		{
+			// Never destroyed: thread locals and the writer may outlive static destructors
+			static Logger * logger = new Logger;
+			return *logger;
+		}
+
+		void write(u16 _type, const char * _format, va_list _va)
+		{
+			LogRing * pRing = _getRing();
+			if (pRing == nullptr)
+				return;
+
+			char message[logMaxMessage];
+			const int len = vsnprintf(message, logMaxMessage, _format, _va);
+			if (len < 0)
+				return;
+
+			LogRecord record;
+			record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			record.size = std::min(u32(len), logMaxMessage - 1);
+			record.type = _type;
+			if (m_finished.load(std::memory_order_acquire) && !m_running.load(std::memory_order_acquire)) {
+				_writeNow(record, message);
+				return;
+			}
+			pRing->push(record, message);
+
+			if (!m_running.load(std::memory_order_acquire))
+				_start();
+			else if (_type <= LOG_ERROR || pRing->isFilling())
+				m_condvar.notify_one();
+		}
+
+		void flush()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (!m_thread.joinable())
+				return;
+			m_stop = true;
+			lock.unlock();
+			m_condvar.notify_one();
+			m_thread.join();
+			lock.lock();
+			m_stop = false;
+			m_running.store(false, std::memory_order_release);
+		}
+
+		// Stops the writer for good. The plugin may be unloaded next, and no thread may run its code then.
+		void close()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_finished.store(true, std::memory_order_release);
+			}
+			flush();
+
+			std::unique_lock<std::mutex> lock(m_writeMutex);
+			_collect(); // messages pushed while the writer was stopping
+			_appendNow();
+		}
+
+	private:
+		struct RingHolder
+		{
+			LogRing * pRing = nullptr;
+			~RingHolder()
+			{
+				if (pRing != nullptr)
+					pRing->m_closed.store(true, std::memory_order_release);
+			}
+		};
+
+		Logger() = default;
+
+		LogRing * _getRing()
+		{
+			static thread_local RingHolder holder;
+			if (holder.pRing == nullptr) {
+				std::unique_ptr<LogRing> ring(new LogRing);
+				holder.pRing = ring.get();
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_rings.push_back(std::move(ring));
+			}
+			return holder.pRing;
+		}
+
+		void _start()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_thread.joinable() || m_finished.load(std::memory_order_relaxed))
+				return;
+
+			_setPath();
+			m_thread = std::thread(&Logger::_work, this);
+			m_running.store(true, std::memory_order_release);
+		}
+
+		// Appends the message to the file at once. Used after close().
+		void _writeNow(const LogRecord & _record, const char * _message)
+		{
+			std::unique_lock<std::mutex> lock(m_writeMutex);
+			_collect();
+			_formatRecord(_record, _message);
+			_appendNow();
+		}
+
+		void _appendNow()
+		{
+			if (m_batch.empty())
+				return;
+			if (m_path.empty())
+				_setPath();
+			FILE * logFile = _open("a");
+			if (logFile != nullptr) {
+				fwrite(m_batch.data(), 1, m_batch.size(), logFile);
+				fclose(logFile);
+			}
+			m_batch.clear();
+		}
+
+		void _setPath()
+		{
+			wchar_t logPath[PLUGIN_PATH_SIZE + 16];
+			api().GetUserDataPath(logPath);
+			gln_wcscat(logPath, wst("/gliden64.log"));
+#ifdef OS_WINDOWS
+			m_path = logPath;
+#else
+			constexpr size_t bufSize = PLUGIN_PATH_SIZE * 6;
+			char cbuf[bufSize];
+			wcstombs(cbuf, logPath, bufSize);
+			m_path = cbuf;
+#endif //OS_WINDOWS
+		}
+
+		FILE * _open(const char * _mode)
+		{
+#ifdef OS_WINDOWS
+			return _wfopen(m_path.c_str(), _mode[0] == 'w' ? wst("w") : wst("a"));
+#else
+			return fopen(m_path.c_str(), _mode);
+#endif //OS_WINDOWS
+		}
+
+		void _rotate()
+		{
+#ifdef OS_WINDOWS
+			const std::wstring oldPath = m_path + wst(".1");
+			_wremove(oldPath.c_str());
+			_wrename(m_path.c_str(), oldPath.c_str());
+#else
+			const std::string oldPath = m_path + ".1";
+			remove(oldPath.c_str());
+			rename(m_path.c_str(), oldPath.c_str());
+#endif //OS_WINDOWS
+		}
+
+		void _formatRecord(const LogRecord & _record, const char * _message)
+		{
+			static const char * typeNames[] = { "NONE", "ERROR", "MINIMAL", "WARNING", "VERBOSE", "APIFUNC" };
+
+			const time_t seconds = time_t(_record.time / 1000);
+			if (seconds != m_lastSeconds) {
+				struct tm localTime;
+#ifdef OS_WINDOWS
+				localtime_s(&localTime, &seconds);
+#else
+				localtime_r(&seconds, &localTime);
+#endif //OS_WINDOWS
+				strftime(m_lastTime, sizeof(m_lastTime), "[%Y-%m-%d %H:%M:%S", &localTime);
+				m_lastSeconds = seconds;
+			}
+			char prefix[32];
+			snprintf(prefix, sizeof(prefix), ".%03u] %s: ", u32(_record.time % 1000),
+				_record.type <= LOG_APIFUNC ? typeNames[_record.type] : "UNKNOWN");
+			m_batch.append(m_lastTime);
+			m_batch.append(prefix);
+			m_batch.append(_message, _record.size);
+		}
 
-	wchar_t logPath[PLUGIN_PATH_SIZE + 16];
-	api().GetUserDataPath(logPath);
-	gln_wcscat(logPath, wst("/gliden64.log"));
+		// Moves pending records of all rings into m_batch
+		void _collect()
+		{
+			std::vector<LogRing*> rings;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				// the owners of closed rings are gone, drop them once they are read
+				for (auto iter = m_rings.begin(); iter != m_rings.end();) {
+					if ((*iter)->m_closed.load(std::memory_order_acquire) && (*iter)->isEmpty())
+						iter = m_rings.erase(iter);
+					else
+						rings.push_back((iter++)->get());
+				}
+			}
 
+			LogRecord record;
+			char message[logMaxMessage];
+			for (LogRing * pRing : rings) {
+				while (pRing->pop(record, message))
+					_formatRecord(record, message);
+				const u32 dropped = pRing->m_dropped.exchange(0, std::memory_order_relaxed);
+				if (dropped != 0) {
+					char text[64];
+					snprintf(text, sizeof(text), "%u log messages dropped\n", dropped);
+					m_batch.append(text);
+				}
+			}
+		}
+
+		void _work()
+		{
+			FILE * logFile = _open("a");
+			long fileSize = 0;
+			if (logFile != nullptr) {
+				fseek(logFile, 0, SEEK_END);
+				fileSize = ftell(logFile);
+			}
+
+			bool stop = false;
+			while (!stop) {
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_condvar.wait_for(lock, logWriteInterval, [this] { return m_stop; });
+					stop = m_stop;
+				}
+
+				_collect();
+				if (m_batch.empty() || logFile == nullptr) {
+					m_batch.clear();
+					continue;
+				}
+
+				if (fileSize > logMaxFileSize) {
+					fclose(logFile);
+					_rotate();
+					logFile = _open("w");
+					fileSize = 0;
+					if (logFile == nullptr) {
+						m_batch.clear();
+						continue;
+					}
+				}
+
+				fwrite(m_batch.data(), 1, m_batch.size(), logFile);
+				fflush(logFile);
+				fileSize += long(m_batch.size());
+				m_batch.clear();
+			}
+
+			if (logFile != nullptr)
+				fclose(logFile);
+		}
+
+		std::mutex m_mutex;
+		std::condition_variable m_condvar;
+		std::vector<std::unique_ptr<LogRing>> m_rings;
+		std::thread m_thread;
+		std::atomic<bool> m_running{false};
+		std::atomic<bool> m_finished{false}; // close() was called
+		std::mutex m_writeMutex;
+		bool m_stop = false;
+		std::string m_batch;
+		time_t m_lastSeconds = 0;
+		char m_lastTime[32];
 #ifdef OS_WINDOWS
-	FILE *dumpFile = _wfopen(logPath, wst("a+"));
+		std::wstring m_path;
 #else
-	constexpr size_t bufSize = PLUGIN_PATH_SIZE * 6;
-	char cbuf[bufSize];
-	wcstombs(cbuf, logPath, bufSize);
-	FILE *dumpFile = fopen(cbuf, "a+");
+		std::string m_path;
 #endif //OS_WINDOWS
+	};
+}
 
-	if (dumpFile == nullptr)
+void LOG(u16 type, const char * format, ...) {
+	if (type > LOG_LEVEL)
 		return;
+
 	va_list va;
 	va_start(va, format);
-	vfprintf(dumpFile, format, va);
-	fclose(dumpFile);
+	Logger::get().write(type, format, va);
 	va_end(va);
 }
 
+void flushLog() {
+	Logger::get().flush();
+}
+
+void closeLog() {
+	Logger::get().close();
+}
+
 #if defined(OS_WINDOWS) && !defined(MINGW)
 #include "windows/GLideN64_windows.h"
 void debugPrint(const char * format, ...) {
@@ -16,9 +16,18 @@
 
 void LOG(u16 type, const char * format, ...);
 
+// Writes out pending messages. Logging resumes on the next LOG call.
+void flushLog();
+
+// Writes out pending messages and stops the writer thread before the plugin is unloaded.
+// Later messages are written to the file directly.
+void closeLog();
+
 #else
 
 #define LOG(A, ...)
+#define flushLog()
+#define closeLog()
 
 #endif
 
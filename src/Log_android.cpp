@@ -20,3 +20,9 @@ void LOG(u16 type, const char * format, ...) {
 	__android_log_vprint(androidLogTranslate[type], "GLideN64", format, va);
 	va_end(va);
 }
+
+void flushLog() {
+}
+
+void closeLog() {
+}
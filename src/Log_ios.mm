@@ -11,3 +11,9 @@ void LOG(u16 type, const char * format, ...) {
 	NSLogv(nsformat, va);
 	va_end(va);
 }
+
+void flushLog() {
+}
+
+void closeLog() {
+}
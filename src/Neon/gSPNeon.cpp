@@ -233,11 +233,12 @@ void DotProductMax4FullNeon( float v0[3], float v1[4][3], float lights[4][3], fl
     vtx[2] += d20[0];
 }
 
-void gSPLightVertex_NEON(u32 vnum, u32 v, SPVertex * spVtx)
+void gSPLightVertex_NEON(u32 vnum, u32 v, SPVertex * spVtx, SPNormal * spNorm)
 {
 	if (!isHWLightingAllowed()) {
 		for(int j = 0; j < vnum; ++j) {
 			SPVertex & vtx = spVtx[v + j];
+			SPNormal & nrm = spNorm[v + j];
 			vtx.r = gSP.lights.rgb[gSP.numLights][R];
 			vtx.g = gSP.lights.rgb[gSP.numLights][G];
 			vtx.b = gSP.lights.rgb[gSP.numLights][B];
@@ -245,16 +246,16 @@ void gSPLightVertex_NEON(u32 vnum, u32 v, SPVertex * spVtx)
 
 			s32 count = gSP.numLights-1;
 			while (count >= 6) {
-				DotProductMax7FullNeon(&vtx.nx,(float (*)[3])gSP.lights.i_xyz[gSP.numLights - count - 1],(float (*)[3])gSP.lights.rgb[gSP.numLights - count - 1],&vtx.r);
+				DotProductMax7FullNeon(&nrm.x,(float (*)[3])gSP.lights.i_xyz[gSP.numLights - count - 1],(float (*)[3])gSP.lights.rgb[gSP.numLights - count - 1],&vtx.r);
 				count -= 7;
 			}
 			while (count >= 3) {
-				DotProductMax4FullNeon(&vtx.nx,(float (*)[3])gSP.lights.i_xyz[gSP.numLights - count - 1],(float (*)[3])gSP.lights.rgb[gSP.numLights - count - 1],&vtx.r);
+				DotProductMax4FullNeon(&nrm.x,(float (*)[3])gSP.lights.i_xyz[gSP.numLights - count - 1],(float (*)[3])gSP.lights.rgb[gSP.numLights - count - 1],&vtx.r);
 				count -= 4;
 			}
 			while (count >= 0)
 			{
-				f32 intensity = DotProduct( &vtx.nx, gSP.lights.i_xyz[gSP.numLights - count - 1] );
+				f32 intensity = DotProduct( &nrm.x, gSP.lights.i_xyz[gSP.numLights - count - 1] );
 				if (intensity > 0.0f){
 					vtx.r += gSP.lights.rgb[gSP.numLights - count - 1][R] * intensity;
 					vtx.g += gSP.lights.rgb[gSP.numLights - count - 1][G] * intensity;
@@ -1,12 +1,9 @@
-#ifdef MINGW
-#define _CRT_RAND_S
-#endif
-
 #include <thread>
 #include <algorithm>
 #include <random>
 #include <functional>
 #include <cstdlib>
+#include <cstring>
 #include <Graphics/Context.h>
 #include <Graphics/Parameters.h>
 #include "FrameBuffer.h"
@@ -29,33 +26,35 @@ NoiseTexture::NoiseTexture()
 	: m_DList(0)
 	, m_currTex(0)
 	, m_prevTex(0)
+	, m_randState(0x9E3779B97F4A7C15ULL)
 {
 	for (u32 i = 0; i < NOISE_TEX_NUM; ++i)
 		m_pTexture[i] = nullptr;
 }
 
+// xorshift64* generator, 4 bytes per step
 static
-u32 Rand(u32 rand_value)
+u32 NextRand(u64 & _state)
 {
-#ifdef MINGW
-	rand_s(&rand_value);
-#else
-	rand_value = rand();
-#endif
-	return rand_value;
+	_state ^= _state >> 12;
+	_state ^= _state << 25;
+	_state ^= _state >> 27;
+	return u32((_state * 0x2545F4914F6CDD1DULL) >> 32);
 }
 
 static
 void FillTextureData(u32 _seed, NoiseTexturesData * _pData, u32 _start, u32 _stop)
 {
-	srand(_seed);
+	// Each thread runs its own generator from its own seed.
+	u64 state = (u64(_seed) << 32) ^ 0x9E3779B97F4A7C15ULL;
 	for (u32 i = _start; i < _stop; ++i) {
 		auto & vec = _pData->at(i);
+		u8 * pDst = vec.data();
 		const size_t sz = vec.size();
-		u32 rand_value(0U);
-		for (size_t t = 0; t < sz; ++t) {
-			rand_value = Rand(rand_value);
-			vec[t] = rand_value & 0xFF;
+		for (size_t t = 0; t < sz; t += 4) {
+			const u32 rand_value = NextRand(state);
+			const size_t n = std::min<size_t>(4, sz - t);
+			memcpy(pDst + t, &rand_value, n);
 		}
 	}
 }
@@ -164,11 +163,8 @@ void NoiseTexture::update()
 	if (m_DList == dwnd().getBuffersSwapCount() || config.generalEmulation.enableNoise == 0)
 		return;
 
-	u32 rand_value(0U);
-	while (m_currTex == m_prevTex) {
-		rand_value = Rand(rand_value);
-		m_currTex = rand_value % NOISE_TEX_NUM;
-	}
+	while (m_currTex == m_prevTex)
+		m_currTex = NextRand(m_randState) % NOISE_TEX_NUM;
 	m_prevTex = m_currTex;
 	if (m_pTexture[m_currTex] == nullptr)
 		return;
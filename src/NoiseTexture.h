@@ -24,6 +24,7 @@ private:
 	CachedTexture * m_pTexture[NOISE_TEX_NUM];
 	u32 m_DList;
 	u32 m_currTex, m_prevTex;
+	u64 m_randState;
 	NoiseTexturesData m_texData;
 };
 
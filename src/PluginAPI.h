@@ -11,6 +11,7 @@
 #endif
 
 #ifdef RSPTHREAD
+#include <deque>
 #include <thread>
 #include <condition_variable>
 #endif
@@ -20,14 +21,6 @@ class APICommand;
 class PluginAPI
 {
 public:
-#ifdef RSPTHREAD
-	~PluginAPI()
-	{
-		delete m_pRspThread;
-		m_pRspThread = NULL;
-	}
-#endif
-
 	// Common
 	void MoveScreen(int /*_xpos*/, int /*_ypos*/) {}
 	void ViStatusChanged() {}
@@ -94,7 +87,6 @@ private:
 		: m_bRomOpen(false)
 #ifdef RSPTHREAD
 		, m_pRspThread(NULL)
-		, m_pCommand(nullptr)
 #endif
 	{}
 	PluginAPI(const PluginAPI &) = delete;
@@ -103,13 +95,13 @@ private:
 
 	bool m_bRomOpen;
 #ifdef RSPTHREAD
+	void _rspThreadProc();
 	void _callAPICommand(APICommand & _command);
 	std::mutex m_rspThreadMtx;
-	std::mutex m_pluginThreadMtx;
-	std::condition_variable_any m_rspThreadCv;
-	std::condition_variable_any m_pluginThreadCv;
+	std::condition_variable m_rspThreadCv;
+	std::condition_variable m_pluginThreadCv;
 	std::thread * m_pRspThread;
-	APICommand * m_pCommand;
+	std::deque<APICommand*> m_commands;
 #endif
 };
 
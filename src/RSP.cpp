@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <cstring>
+#include <map>
+#include <unordered_map>
+#include <vector>
 #include "DebugDump.h"
 #include "RSP.h"
 #include "RDP.h"
@@ -17,6 +20,7 @@
 #include "Config.h"
 #include "TextureFilterHandler.h"
 #include "DisplayWindow.h"
+#include "GBITrace.h"
 
 using namespace std;
 
@@ -26,38 +30,168 @@ using namespace std;
 
 RSPInfo		RSP;
 
+// Runs of display list commands, decoded once and cached by the RDRAM address they start at.
+// A run ends at the first command, which may leave the current display list, or where the next run starts.
+// The run is replayed only while its commands match RDRAM.
+struct DListRun
+{
+	struct Command
+	{
+		u32 w0, w1;
+	};
+	std::vector<Command> commands;
+};
+
+static const u32 DListRunMaxLength = 256;
+static const u32 DListRunMaxMisses = 4;
+static const size_t DListCacheMaxSize = 8192;
+static const size_t DListMissesMaxSize = DListCacheMaxSize * 4;
+static std::map<u32, DListRun> s_dlistCache;
+// Kept apart from the runs, so that clearing the cache doesn't forget rebuilt display lists.
+static std::unordered_map<u32, u32> s_dlistMisses;
+
 static
-void _ProcessDList()
+bool _isDListFlowCommand(u32 _cmd)
 {
-	while (!RSP.halt) {
-		if ((RSP.PC[RSP.PCi] + 8) > RDRAMSize) {
-#ifdef DEBUG_DUMP
-			if ((config.debug.dumpMode & DEBUG_DETAIL) != 0)
-				DebugMsg(DEBUG_DETAIL | DEBUG_ERROR, "// Attempting to execute RSP command at invalid RDRAM location\n");
-			else if ((config.debug.dumpMode & DEBUG_NORMAL) != 0)
-				DebugMsg(DEBUG_NORMAL | DEBUG_ERROR, "Attempting to execute RSP command at invalid RDRAM location\n");
-			else if ((config.debug.dumpMode & DEBUG_LOW) != 0)
-				DebugMsg(DEBUG_LOW | DEBUG_ERROR, "ATTEMPTING TO EXECUTE RSP COMMAND AT INVALID RDRAM LOCATION\n");
-#endif
-			break;
+	return _cmd == G_DL || _cmd == G_ENDDL || _cmd == G_CULLDL || _cmd == G_BRANCH_Z || _cmd == G_BRANCH_W;
+}
+
+static
+const DListRun * _getDListRun(u32 _address)
+{
+	auto next = s_dlistCache.upper_bound(_address);
+	if (next != s_dlistCache.begin()) {
+		auto iter = std::prev(next);
+		DListRun & run = iter->second;
+		const u32 size = u32(run.commands.size()) << 3;
+		if (iter->first == _address) {
+			if (memcmp(run.commands.data(), &RDRAM[_address], size) == 0)
+				return &run;
+			// Memory changed: use the regular path this time and decode again on next visit.
+			s_dlistCache.erase(iter);
+			if (s_dlistMisses.size() >= DListMissesMaxSize)
+				s_dlistMisses.clear();
+			++s_dlistMisses[_address];
+			return nullptr;
 		}
+		if (_address - iter->first < size)
+			return nullptr; // entered in the middle of a run, keep the runs from overlapping
+	}
 
-		RSP.w0 = *(u32*)&RDRAM[RSP.PC[RSP.PCi]];
-		RSP.w1 = *(u32*)&RDRAM[RSP.PC[RSP.PCi] + 4];
+	auto misses = s_dlistMisses.find(_address);
+	if (misses != s_dlistMisses.end() && misses->second >= DListRunMaxMisses)
+		return nullptr; // display list is rebuilt too often to be worth caching
+
+	if (s_dlistCache.size() >= DListCacheMaxSize) {
+		s_dlistCache.clear();
+		next = s_dlistCache.end();
+	}
+
+	const u32 end = next != s_dlistCache.end() ? std::min(next->first, RDRAMSize) : RDRAMSize;
+	DListRun run;
+	for (u32 pc = _address; pc + 8 <= end && run.commands.size() < DListRunMaxLength; pc += 8) {
+		const DListRun::Command command = { *(u32*)&RDRAM[pc], *(u32*)&RDRAM[pc + 4] };
+		run.commands.push_back(command);
+		if (_isDListFlowCommand(_SHIFTR(command.w0, 24, 8)))
+			break;
+	}
+	if (run.commands.empty())
+		return nullptr;
+	return &s_dlistCache.emplace_hint(next, _address, std::move(run))->second;
+}
+
+// Replays a cached run starting at its first command.
+// Returns as soon as a command moves PC out of the run or changes display list nesting.
+// Returns false if nothing was run.
+static
+bool _runDList(const DListRun & _run, u32 _address, bool _factor5)
+{
+	const u32 pci = RSP.PCi;
+	const u32 numCommands = u32(_run.commands.size());
+	if (numCommands == 0)
+		return false;
+	u32 idx = 0;
+	while (true) {
+		const DListRun::Command & command = _run.commands[idx];
+		const u32 pc = _address + (idx << 3);
+		RSP.w0 = command.w0;
+		RSP.w1 = command.w1;
 		RSP.cmd = _SHIFTR(RSP.w0, 24, 8);
 
 #ifdef DEBUG_DUMP
-		DebugMsg(DEBUG_LOW, "0x%08lX: CMD=0x%02lX W0=0x%08lX W1=0x%08lX\n", RSP.PC[RSP.PCi], _SHIFTR(RSP.w0, 24, 8), RSP.w0, RSP.w1);
+		DebugMsg(DEBUG_LOW, "0x%08lX: CMD=0x%02lX W0=0x%08lX W1=0x%08lX\n", pc, RSP.cmd, RSP.w0, RSP.w1);
 #endif
 
-		RSP.PC[RSP.PCi] += 8;
-		u32 pci = RSP.PCi;
-		if (RSP.count == 1)
-			--pci;
-		RSP.nextCmd = _SHIFTR(*(u32*)&RDRAM[RSP.PC[pci]], 24, 8);
+		gbiTrace().command(pc, RSP.w0, RSP.w1);
+
+		RSP.PC[pci] = _factor5 ? pc : pc + 8;
+		RSP.nextCmd = idx + 1 < numCommands ?
+			_SHIFTR(_run.commands[idx + 1].w0, 24, 8) :
+			_SHIFTR(*(u32*)&RDRAM[pc + 8], 24, 8);
 
 		GBI.cmd[RSP.cmd](RSP.w0, RSP.w1);
+		if (_factor5)
+			RSP.PC[RSP.PCi] += 8;
 		RSP_CheckDLCounter();
+
+		if (RSP.halt || RSP.PCi != pci || RSP.count != -1)
+			return true;
+		const u32 offset = RSP.PC[pci] - _address;
+		if ((offset & 7) != 0 || (offset >> 3) >= numCommands)
+			return true;
+		idx = offset >> 3;
+	}
+}
+
+static
+bool _processDListCommand()
+{
+	if ((RSP.PC[RSP.PCi] + 8) > RDRAMSize) {
+#ifdef DEBUG_DUMP
+		if ((config.debug.dumpMode & DEBUG_DETAIL) != 0)
+			DebugMsg(DEBUG_DETAIL | DEBUG_ERROR, "// Attempting to execute RSP command at invalid RDRAM location\n");
+		else if ((config.debug.dumpMode & DEBUG_NORMAL) != 0)
+			DebugMsg(DEBUG_NORMAL | DEBUG_ERROR, "Attempting to execute RSP command at invalid RDRAM location\n");
+		else if ((config.debug.dumpMode & DEBUG_LOW) != 0)
+			DebugMsg(DEBUG_LOW | DEBUG_ERROR, "ATTEMPTING TO EXECUTE RSP COMMAND AT INVALID RDRAM LOCATION\n");
+#endif
+		return false;
+	}
+
+	RSP.w0 = *(u32*)&RDRAM[RSP.PC[RSP.PCi]];
+	RSP.w1 = *(u32*)&RDRAM[RSP.PC[RSP.PCi] + 4];
+	RSP.cmd = _SHIFTR(RSP.w0, 24, 8);
+
+#ifdef DEBUG_DUMP
+	DebugMsg(DEBUG_LOW, "0x%08lX: CMD=0x%02lX W0=0x%08lX W1=0x%08lX\n", RSP.PC[RSP.PCi], _SHIFTR(RSP.w0, 24, 8), RSP.w0, RSP.w1);
+#endif
+	gbiTrace().command(RSP.PC[RSP.PCi], RSP.w0, RSP.w1);
+
+	RSP.PC[RSP.PCi] += 8;
+	u32 pci = RSP.PCi;
+	if (RSP.count == 1)
+		--pci;
+	RSP.nextCmd = _SHIFTR(*(u32*)&RDRAM[RSP.PC[pci]], 24, 8);
+
+	GBI.cmd[RSP.cmd](RSP.w0, RSP.w1);
+	RSP_CheckDLCounter();
+	return true;
+}
+
+static
+void _ProcessDList()
+{
+	const bool useCache = config.generalEmulation.enableDListCache != 0;
+	while (!RSP.halt) {
+		if (useCache && RSP.count == -1 && (RSP.PC[RSP.PCi] + 8) <= RDRAMSize) {
+			const u32 address = RSP.PC[RSP.PCi];
+			const DListRun * pRun = _getDListRun(address);
+			if (pRun != nullptr && _runDList(*pRun, address, false))
+				continue;
+		}
+
+		if (!_processDListCommand())
+			break;
 	}
 }
 
@@ -74,11 +208,19 @@ void _ProcessDListFactor5()
 	for (u32 i = 0; i < 7; ++i)
 		pDmem32[vAddrToClear[i]] = 0U;
 
+	const bool useCache = config.generalEmulation.enableDListCache != 0;
 	while (!RSP.halt) {
 		if ((RSP.PC[RSP.PCi] + 8) > RDRAMSize) {
 			break;
 		}
 
+		if (useCache && RSP.count == -1) {
+			const u32 address = RSP.PC[RSP.PCi];
+			const DListRun * pRun = _getDListRun(address);
+			if (pRun != nullptr && _runDList(*pRun, address, true))
+				continue;
+		}
+
 		RSP.w0 = *(u32*)&RDRAM[RSP.PC[RSP.PCi]];
 		RSP.w1 = *(u32*)&RDRAM[RSP.PC[RSP.PCi] + 4];
 		RSP.cmd = _SHIFTR(RSP.w0, 24, 8);
@@ -86,6 +228,7 @@ void _ProcessDListFactor5()
 #ifdef DEBUG_DUMP
 		DebugMsg(DEBUG_LOW, "0x%08lX: CMD=0x%02lX W0=0x%08lX W1=0x%08lX\n", RSP.PC[RSP.PCi], _SHIFTR(RSP.w0, 24, 8), RSP.w0, RSP.w1);
 #endif
+		gbiTrace().command(RSP.PC[RSP.PCi], RSP.w0, RSP.w1);
 
 		RSP.nextCmd = _SHIFTR(*(u32*)&RDRAM[RSP.PC[RSP.PCi] + 8], 24, 8);
 
@@ -115,6 +258,8 @@ void RSP_ProcessDList()
 		return;
 	}
 
+	gbiTrace().beginFrame();
+
 	if (RSP.infloop) {
 		RSP.infloop = false;
 		RSP.halt = false;
@@ -180,6 +325,7 @@ void RSP_ProcessDList()
 	}
 
 	if(RSP.infloop && REG.SP_STATUS) {
+		gbiTrace().endFrame();
 		*REG.SP_STATUS &= ~(SP_STATUS_TASKDONE | SP_STATUS_HALT | SP_STATUS_BROKE);
 		return;
 	}
@@ -194,6 +340,8 @@ void RSP_ProcessDList()
 			FrameBuffer_CopyDepthBuffer(gDP.colorImage.address);
 	}
 
+	gbiTrace().endFrame();
+
 	RSP.busy = false;
 	gDP.changed |= CHANGED_COLORBUFFER;
 }
@@ -265,6 +413,8 @@ void RSP_Init()
 
 	RSP.uc_start = RSP.uc_dstart = 0;
 	RSP.LLE = false;
+	s_dlistCache.clear();
+	s_dlistMisses.clear();
 	RSP.infloop = false;
 
 	// get the name of the ROM
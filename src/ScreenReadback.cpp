@@ -0,0 +1,85 @@
+#include <Graphics/Context.h>
+#include <Graphics/Parameters.h>
+#include <Graphics/PixelBuffer.h>
+#include "FrameBuffer.h"
+#include "ScreenReadback.h"
+
+using namespace graphics;
+
+static const u32 readbackNumReads = 3;
+
+ScreenReadback::ScreenReadback()
+: m_nextRead(0)
+{
+}
+
+ScreenReadback::~ScreenReadback()
+{
+}
+
+void ScreenReadback::start(ObjectHandle _fbo, s32 _x, s32 _y, u32 _width, u32 _height, u32 _swapCount)
+{
+	if (_width == 0 || _height == 0)
+		return;
+
+	if (m_reads.empty())
+		m_reads.resize(readbackNumReads);
+
+	Read & read = m_reads[m_nextRead];
+	read.valid = false;
+
+	const size_t size = size_t(_width) * _height * 4;
+	if (!read.buffer || read.bufferSize < size) {
+		read.buffer.reset(gfxContext.createPixelReadBuffer(size));
+		read.bufferSize = read.buffer ? size : 0;
+		if (!read.buffer)
+			return;
+	}
+
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, _fbo);
+	{
+		PixelBufferBinder<PixelReadBuffer> binder(read.buffer.get());
+		read.buffer->readPixels(_x, _y, _width, _height, colorFormat::RGBA, datatype::UNSIGNED_BYTE);
+	}
+	FrameBuffer * pBuffer = frameBufferList().getCurrent();
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER,
+		pBuffer != nullptr ? pBuffer->m_FBO : ObjectHandle::defaultFramebuffer);
+
+	read.width = _width;
+	read.height = _height;
+	read.swapCount = _swapCount;
+	read.valid = true;
+	m_nextRead = (m_nextRead + 1) % readbackNumReads;
+}
+
+bool ScreenReadback::read(u8 * _dest, u32 _width, u32 _height, u32 _swapCount)
+{
+	for (Read & read : m_reads) {
+		if (!read.valid || read.swapCount != _swapCount || read.width != _width || read.height != _height)
+			continue;
+
+		const u32 numPixels = _width * _height;
+		PixelBufferBinder<PixelReadBuffer> binder(read.buffer.get());
+		const u8 * pixelData = (const u8*)read.buffer->getDataRange(0, numPixels * 4);
+		if (pixelData == nullptr)
+			return false;
+
+		// RGBA to RGB
+		for (u32 i = 0; i < numPixels; ++i) {
+			_dest[0] = pixelData[0];
+			_dest[1] = pixelData[1];
+			_dest[2] = pixelData[2];
+			_dest += 3;
+			pixelData += 4;
+		}
+		read.buffer->closeReadBuffer();
+		return true;
+	}
+	return false;
+}
+
+void ScreenReadback::destroy()
+{
+	m_reads.clear();
+	m_nextRead = 0;
+}
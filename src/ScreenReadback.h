@@ -0,0 +1,44 @@
+#ifndef SCREENREADBACK_H
+#define SCREENREADBACK_H
+
+#include <memory>
+#include <vector>
+#include "Types.h"
+#include "Graphics/ObjectHandle.h"
+
+namespace graphics {
+	class PixelReadBuffer;
+}
+
+// Keeps the frames shown on screen in a ring of pixel buffers, so that
+// frontends which read the front buffer every frame get it without waiting
+// for the GPU. The price is one frame of lag: a read returns the frame
+// shown before the one on screen now.
+class ScreenReadback
+{
+public:
+	ScreenReadback();
+	~ScreenReadback();
+
+	// Starts reading the frame about to be shown at buffer swap _swapCount
+	void start(graphics::ObjectHandle _fbo, s32 _x, s32 _y, u32 _width, u32 _height, u32 _swapCount);
+	// Copies the frame shown at buffer swap _swapCount as RGB rows, bottom row first.
+	// Returns false if that frame was not read at this size.
+	bool read(u8 * _dest, u32 _width, u32 _height, u32 _swapCount);
+	void destroy();
+
+private:
+	struct Read {
+		std::unique_ptr<graphics::PixelReadBuffer> buffer;
+		size_t bufferSize = 0;
+		u32 width = 0;
+		u32 height = 0;
+		u32 swapCount = 0;
+		bool valid = false;
+	};
+
+	std::vector<Read> m_reads;
+	u32 m_nextRead;
+};
+
+#endif // SCREENREADBACK_H
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <Graphics/Context.h>
+#include <Graphics/Parameters.h>
+#include "Combiner.h"
+#include "DisplayWindow.h"
+#include "GraphicsDrawer.h"
+#include "Textures.h"
+#include "FrameBuffer.h"
+#include "GBI.h"
+#include "RDP.h"
+#include "RSP.h"
+#include "TexrectAtlas.h"
+
+using namespace graphics;
+
+static const u32 atlasPageSize = 1024;
+static const u32 atlasNumPages = 2;
+static const u32 atlasMaxTextureSize = 64;
+static const u32 atlasMaxRects = 256;
+
+TexrectAtlas::TexrectAtlas()
+: m_curPage(0)
+, m_shelfX(0)
+, m_shelfY(0)
+, m_shelfHeight(0)
+, m_generation(0)
+, m_batchPage(0)
+, m_pCombiner(nullptr)
+, m_pBuffer(nullptr)
+{}
+
+TexrectAtlas::~TexrectAtlas()
+{
+}
+
+void TexrectAtlas::init()
+{
+	if (!Context::BlitFramebuffer)
+		return;
+
+	m_readFBO = gfxContext.createFramebuffer();
+
+	m_pages.resize(atlasNumPages);
+	for (Page & page : m_pages) {
+		page.pTexture = textureCache().addFrameBufferTexture(false);
+		page.pTexture->format = G_IM_FMT_RGBA;
+		page.pTexture->clampS = 1;
+		page.pTexture->clampT = 1;
+		page.pTexture->frameBufferTexture = CachedTexture::fbOneSample;
+		page.pTexture->maskS = 0;
+		page.pTexture->maskT = 0;
+		page.pTexture->mirrorS = 0;
+		page.pTexture->mirrorT = 0;
+		page.pTexture->realWidth = atlasPageSize;
+		page.pTexture->realHeight = atlasPageSize;
+		page.pTexture->textureBytes = atlasPageSize * atlasPageSize * 4;
+
+		Context::InitTextureParams initParams;
+		initParams.handle = page.pTexture->name;
+		initParams.textureUnitIndex = textureIndices::Tex[0];
+		initParams.width = atlasPageSize;
+		initParams.height = atlasPageSize;
+		initParams.internalFormat = gfxContext.convertInternalTextureFormat(u32(internalcolorFormat::RGBA8));
+		initParams.format = colorFormat::RGBA;
+		initParams.dataType = datatype::UNSIGNED_BYTE;
+		gfxContext.init2DTexture(initParams);
+
+		Context::TexParameters texParams;
+		texParams.handle = page.pTexture->name;
+		texParams.target = textureTarget::TEXTURE_2D;
+		texParams.textureUnitIndex = textureIndices::Tex[0];
+		texParams.minFilter = textureParameters::FILTER_NEAREST;
+		texParams.magFilter = textureParameters::FILTER_NEAREST;
+		texParams.wrapS = textureParameters::WRAP_CLAMP_TO_EDGE;
+		texParams.wrapT = textureParameters::WRAP_CLAMP_TO_EDGE;
+		texParams.maxMipmapLevel = Parameter(0);
+		gfxContext.setTextureParameters(texParams);
+
+		page.FBO = gfxContext.createFramebuffer();
+		Context::FrameBufferRenderTarget bufTarget;
+		bufTarget.bufferHandle = page.FBO;
+		bufTarget.bufferTarget = bufferTarget::DRAW_FRAMEBUFFER;
+		bufTarget.attachment = bufferAttachment::COLOR_ATTACHMENT0;
+		bufTarget.textureTarget = textureTarget::TEXTURE_2D;
+		bufTarget.textureHandle = page.pTexture->name;
+		gfxContext.addFrameBufferRenderTarget(bufTarget);
+	}
+	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::defaultFramebuffer);
+
+	m_vertices.reserve(atlasMaxRects * 6);
+	_reset();
+}
+
+void TexrectAtlas::destroy()
+{
+	m_vertices.clear();
+	for (Page & page : m_pages) {
+		gfxContext.deleteFramebuffer(page.FBO);
+		textureCache().removeFrameBufferTexture(page.pTexture);
+	}
+	m_pages.clear();
+	if (m_readFBO.isNotNull()) {
+		gfxContext.deleteFramebuffer(m_readFBO);
+		m_readFBO.reset();
+	}
+}
+
+bool TexrectAtlas::isTextureSupported(const CachedTexture * _pTexture)
+{
+	return _pTexture->frameBufferTexture == CachedTexture::fbNone &&
+		!_pTexture->bHDTexture &&
+		_pTexture->realWidth <= atlasMaxTextureSize &&
+		_pTexture->realHeight <= atlasMaxTextureSize;
+}
+
+// Starts over with empty pages. Textures placed before are copied again when used.
+void TexrectAtlas::_reset()
+{
+	++m_generation;
+	m_curPage = 0;
+	m_shelfX = 0;
+	m_shelfY = 0;
+	m_shelfHeight = 0;
+}
+
+bool TexrectAtlas::_place(CachedTexture * _pTexture)
+{
+	const u32 width = _pTexture->realWidth + 2;
+	const u32 height = _pTexture->realHeight + 2;
+
+	if (m_shelfX + width > atlasPageSize) {
+		m_shelfX = 0;
+		m_shelfY += m_shelfHeight;
+		m_shelfHeight = 0;
+	}
+	if (m_shelfY + height > atlasPageSize) {
+		if (m_curPage + 1 >= m_pages.size())
+			return false;
+		++m_curPage;
+		m_shelfX = 0;
+		m_shelfY = 0;
+		m_shelfHeight = 0;
+	}
+
+	_pTexture->atlasGeneration = m_generation;
+	_pTexture->atlasPage = u8(m_curPage);
+	_pTexture->atlasX = u16(m_shelfX + 1);
+	_pTexture->atlasY = u16(m_shelfY + 1);
+	m_shelfX += width;
+	m_shelfHeight = std::max(m_shelfHeight, height);
+	return true;
+}
+
+void TexrectAtlas::_copy(CachedTexture * _pTexture)
+{
+	Context::FrameBufferRenderTarget bufTarget;
+	bufTarget.bufferHandle = m_readFBO;
+	bufTarget.bufferTarget = bufferTarget::READ_FRAMEBUFFER;
+	bufTarget.attachment = bufferAttachment::COLOR_ATTACHMENT0;
+	bufTarget.textureTarget = textureTarget::TEXTURE_2D;
+	bufTarget.textureHandle = _pTexture->name;
+	gfxContext.addFrameBufferRenderTarget(bufTarget);
+
+	const s32 w = _pTexture->realWidth;
+	const s32 h = _pTexture->realHeight;
+	const s32 x = _pTexture->atlasX;
+	const s32 y = _pTexture->atlasY;
+
+	Context::BlitFramebuffersParams blitParams;
+	blitParams.readBuffer = m_readFBO;
+	blitParams.drawBuffer = m_pages[_pTexture->atlasPage].FBO;
+	blitParams.mask = blitMask::COLOR_BUFFER;
+	blitParams.filter = textureParameters::FILTER_NEAREST;
+	// The one texel wide border blits must not be shifted
+	blitParams.exactCoords = true;
+
+	// The texture itself, then its edges and corners into the border
+	const s32 src[3][2] = { { 0, w }, { 0, 1 }, { w - 1, w } };
+	const s32 dstX[3][2] = { { x, x + w }, { x - 1, x }, { x + w, x + w + 1 } };
+	const s32 srcT[3][2] = { { 0, h }, { 0, 1 }, { h - 1, h } };
+	const s32 dstY[3][2] = { { y, y + h }, { y - 1, y }, { y + h, y + h + 1 } };
+	for (u32 i = 0; i < 3; ++i) {
+		for (u32 j = 0; j < 3; ++j) {
+			blitParams.srcX0 = src[i][0];
+			blitParams.srcX1 = src[i][1];
+			blitParams.dstX0 = dstX[i][0];
+			blitParams.dstX1 = dstX[i][1];
+			blitParams.srcY0 = srcT[j][0];
+			blitParams.srcY1 = srcT[j][1];
+			blitParams.dstY0 = dstY[j][0];
+			blitParams.dstY1 = dstY[j][1];
+			gfxContext.blitFramebuffers(blitParams);
+		}
+	}
+
+	frameBufferList().setCurrentDrawBuffer();
+}
+
+bool TexrectAtlas::_nextIsTexrect()
+{
+	if (RSP.LLE)
+		return false;
+
+	for (u32 pc = RSP.PC[RSP.PCi]; pc + 8 <= RDRAMSize; pc += 8) {
+		switch (_SHIFTR(*(u32*)&RDRAM[pc], 24, 8)) {
+		case G_RDPLOADSYNC:
+		case G_RDPPIPESYNC:
+		case G_RDPTILESYNC:
+		case G_LOADTLUT:
+		case G_SETTILESIZE:
+		case G_LOADBLOCK:
+		case G_LOADTILE:
+		case G_SETTILE:
+		case G_SETTIMG:
+			break;
+		case G_TEXRECT:
+		case G_TEXRECTFLIP:
+			return true;
+		default:
+			return false;
+		}
+	}
+	return false;
+}
+
+bool TexrectAtlas::add(const RectVertex * _rect, CachedTexture * _pTexture)
+{
+	if (m_pages.empty() || frameBufferList().getCurrent() == nullptr)
+		return false;
+
+	// A single rect gains nothing from the atlas
+	if (isEmpty() && !_nextIsTexrect())
+		return false;
+
+	if (_pTexture->atlasGeneration != m_generation) {
+		if (!_place(_pTexture)) {
+			draw();
+			_reset();
+			_place(_pTexture);
+		}
+		_copy(_pTexture);
+	}
+
+	graphics::CombinerProgram * pCombiner = currentCombiner();
+	if (!isEmpty() && (m_batchPage != _pTexture->atlasPage || m_pCombiner != pCombiner))
+		draw();
+
+	if (isEmpty()) {
+		m_batchPage = _pTexture->atlasPage;
+		m_pCombiner = pCombiner;
+		m_pBuffer = frameBufferList().getCurrent();
+	}
+
+	const f32 scaleS = f32(_pTexture->realWidth) / f32(atlasPageSize);
+	const f32 scaleT = f32(_pTexture->realHeight) / f32(atlasPageSize);
+	const f32 offsetS = f32(_pTexture->atlasX) / f32(atlasPageSize);
+	const f32 offsetT = f32(_pTexture->atlasY) / f32(atlasPageSize);
+
+	// Two triangles in the order of the rect triangle strip
+	static const u32 order[6] = { 0, 1, 2, 2, 1, 3 };
+	for (u32 i = 0; i < 6; ++i) {
+		RectVertex vtx = _rect[order[i]];
+		vtx.s0 = offsetS + vtx.s0 * scaleS;
+		vtx.t0 = offsetT + vtx.t0 * scaleT;
+		m_vertices.push_back(vtx);
+	}
+
+	if (m_vertices.size() >= atlasMaxRects * 6 || !_nextIsTexrect())
+		draw();
+
+	return true;
+}
+
+bool TexrectAtlas::draw()
+{
+	if (isEmpty())
+		return false;
+
+	Context::BindTextureParameters bindParams;
+	bindParams.texture = m_pages[m_batchPage].pTexture->name;
+	bindParams.textureUnitIndex = textureIndices::Tex[0];
+	bindParams.target = textureTarget::TEXTURE_2D;
+	gfxContext.bindTexture(bindParams);
+
+	graphics::CombinerProgram * pCurrentCombiner = currentCombiner();
+	m_pCombiner->activate();
+
+	Context::DrawRectParameters rectParams;
+	rectParams.mode = drawmode::TRIANGLES;
+	rectParams.verticesCount = u32(m_vertices.size());
+	rectParams.vertices = m_vertices.data();
+	rectParams.combiner = m_pCombiner;
+	gfxContext.drawRects(rectParams);
+
+	m_vertices.clear();
+
+	// Give the texture unit and program back to the state the caller set
+	CachedTexture * pTexture = textureCache().current[0];
+	if (pTexture != nullptr) {
+		bindParams.texture = pTexture->name;
+		gfxContext.bindTexture(bindParams);
+	}
+	if (pCurrentCombiner != nullptr)
+		pCurrentCombiner->activate();
+
+	return true;
+}
+
+bool TexrectAtlas::isEmpty() const
+{
+	return m_vertices.empty();
+}
+
+bool TexrectAtlas::canContinue() const
+{
+	return (!isEmpty() &&
+			m_pBuffer == frameBufferList().getCurrent() &&
+			gSP.textureTile[0]->frameBufferAddress == 0 &&
+			gSP.textureTile[1]->frameBufferAddress == 0);
+}
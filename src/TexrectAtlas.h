@@ -0,0 +1,60 @@
+#ifndef TEXRECTATLAS_H
+#define TEXRECTATLAS_H
+
+#include <vector>
+#include "Types.h"
+#include "Graphics/ObjectHandle.h"
+#include "Graphics/CombinerProgram.h"
+
+struct CachedTexture;
+struct FrameBuffer;
+struct RectVertex;
+
+// Batches runs of texture rectangles which use different small textures.
+// Each texture is copied once into an atlas page with a one texel border,
+// which repeats its edges, and the rect texture coordinates are moved to
+// its place. Consecutive rects on the same page then go into one draw call.
+// Only rects with clamped coordinates into one plain texture are batched.
+class TexrectAtlas
+{
+public:
+	TexrectAtlas();
+	~TexrectAtlas();
+
+	void init();
+	void destroy();
+	// Queues the rect. Returns false if it must be drawn as usual.
+	bool add(const RectVertex * _rect, CachedTexture * _pTexture);
+	bool draw();
+	bool isEmpty() const;
+	bool canContinue() const;
+
+	static bool isTextureSupported(const CachedTexture * _pTexture);
+
+private:
+	bool _place(CachedTexture * _pTexture);
+	void _copy(CachedTexture * _pTexture);
+	void _reset();
+	static bool _nextIsTexrect();
+
+	struct Page {
+		CachedTexture * pTexture = nullptr;
+		graphics::ObjectHandle FBO;
+	};
+	std::vector<Page> m_pages;
+	graphics::ObjectHandle m_readFBO;
+
+	// Shelf packing state of the page being filled
+	u32 m_curPage;
+	u32 m_shelfX;
+	u32 m_shelfY;
+	u32 m_shelfHeight;
+	u32 m_generation;
+
+	std::vector<RectVertex> m_vertices;
+	u32 m_batchPage;
+	graphics::CombinerProgram * m_pCombiner;
+	FrameBuffer * m_pBuffer;
+};
+
+#endif // TEXRECTATLAS_H
@@ -10,6 +10,7 @@
 #include "TextureFilterHandler.h"
 #include "DisplayWindow.h"
 #include "DisplayLoadProgress.h"
+#include "Log.h"
 #include "wst.h"
 
 static
@@ -44,12 +45,23 @@ u32 textureEnhancements[] = {
 u32 TextureFilterHandler::_getConfigOptions() const
 {
 	u32 options = textureFilters[config.textureFilter.txFilterMode] | textureEnhancements[config.textureFilter.txEnhancementMode];
-	if (config.textureFilter.txHiresEnable)
+	if (config.textureFilter.txHiresEnable) {
 		options |= RICE_HIRESTEXTURES;
+		if (graphics::Context::TextureCompressionS3TC)
+			options |= S3TC_HIRESTEX;
+		if (graphics::Context::TextureCompressionBPTC)
+			options |= BPTC_HIRESTEX;
+		if (graphics::Context::TextureCompressionETC2)
+			options |= ETC2_HIRESTEX;
+		if (graphics::Context::TextureCompressionASTC)
+			options |= ASTC_HIRESTEX;
+	}
 	if (config.textureFilter.txForce16bpp)
 		options |= FORCE16BPP_TEX | FORCE16BPP_HIRESTEX;
-	if (config.textureFilter.txCacheCompression)
+	if (config.textureFilter.txCacheCompression != Config::tccNone)
 		options |= GZ_TEXCACHE | GZ_HIRESTEXCACHE;
+	if (config.textureFilter.txCacheCompression == Config::tccLZ4)
+		options |= LZ4_TXCACHE;
 	if (config.textureFilter.txSaveCache)
 		options |= (DUMP_TEXCACHE | DUMP_HIRESTEXCACHE);
 	if (config.textureFilter.txHiresFullAlphaChannel)
@@ -105,6 +117,9 @@ void TextureFilterHandler::init()
 		32, // max texture bpp supported by hardware
 		m_options,
 		config.textureFilter.txCacheSize, // cache texture to system memory
+		config.textureFilter.txHiresCacheSize, // memory budget of hires textures
+		config.textureFilter.txDiskCacheSize, // disk budget of textures evicted from memory
+		config.textureFilter.txDumpCompressionLevel, // zlib level of dumped png textures
 		pTexCachePath, // path to store cache files
 		pTexDumpPath, // path to folder with dumped textures
 		pTexPackPath, // path to texture packs folder
@@ -116,6 +131,12 @@ void TextureFilterHandler::init()
 void TextureFilterHandler::shutdown()
 {
 	if (isInited()) {
+		GHQCacheStats texStats, hiresStats;
+		txfilter_cachestats(&texStats, &hiresStats);
+		LOG(LOG_VERBOSE, "Filtered textures cache: memory %u hits %u misses, disk %u hits %u misses\n",
+			texStats.ramHits, texStats.ramMisses, texStats.diskHits, texStats.diskMisses);
+		LOG(LOG_VERBOSE, "Hires textures cache: memory %u hits %u misses, disk %u hits %u misses\n",
+			hiresStats.ramHits, hiresStats.ramMisses, hiresStats.diskHits, hiresStats.diskMisses);
 		txfilter_shutdown();
 		m_inited = m_options = 0;
 	}
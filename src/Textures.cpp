@@ -14,6 +14,7 @@
 #include "FrameBuffer.h"
 #include "Config.h"
 #include "Keys.h"
+#include "Log.h"
 #include "GLideNHQ/Ext_TxFilter.h"
 #include "TextureFilterHandler.h"
 #include "DisplayLoadProgress.h"
@@ -24,6 +25,9 @@
 using namespace std;
 using namespace graphics;
 
+// Ring of unpack memory the driver uploads plain textures from
+static const size_t uploadBufferSize = 8 * 1024 * 1024;
+
 inline u32 GetNone( u64 *src, u16 x, u16 i, u8 palette )
 {
 	return 0x00000000;
@@ -519,11 +523,15 @@ void TextureCache::init()
 		activateMSDummy(1);
 	}
 
+	m_uploadBuffer.reset(gfxContext.createPixelWriteBuffer(uploadBufferSize));
+
 	assert(!gfxContext.isError());
 }
 
 void TextureCache::destroy()
 {
+	LOG(LOG_VERBOSE, "Texture cache: %u hits %u misses\n", m_hits, m_misses);
+
 	current[0] = current[1] = nullptr;
 
 	for (Textures::const_iterator cur = m_textures.cbegin(); cur != m_textures.cend(); ++cur)
@@ -534,6 +542,16 @@ void TextureCache::destroy()
 	for (FBTextures::const_iterator cur = m_fbTextures.cbegin(); cur != m_fbTextures.cend(); ++cur)
 		gfxContext.deleteTexture(cur->second.name);
 	m_fbTextures.clear();
+
+	m_uploadBuffer.reset();
+}
+
+u32 * TextureCache::_getUploadBuffer(u32 * _pDest, u32 _bytes)
+{
+	if (!m_uploadBuffer)
+		return _pDest;
+	u32 * pTexels = reinterpret_cast<u32*>(m_uploadBuffer->getWriteBuffer(_bytes));
+	return pTexels != nullptr ? pTexels : _pDest;
 }
 
 void TextureCache::_checkCacheSize()
@@ -680,19 +698,71 @@ void _calcTileSizes(u32 _t, TileSizes & _sizes, gDPTile * _pLoadTile)
 	}
 }
 
-inline
-void _updateCachedTexture(const GHQTexInfo & _info, CachedTexture *_pTexture, f32 _scale)
+static
+u32 _compressedTextureSize(const GHQTexInfo & _info)
 {
-	_pTexture->textureBytes = _info.width * _info.height;
-
+	// GPU compressed hi-res textures are stored as 4x4 blocks
+	const u32 blocks = ((_info.width + 3) >> 2) * ((_info.height + 3) >> 2);
 	Parameter format(_info.format);
-	if (format == internalcolorFormat::RGB8 ||
-		format == internalcolorFormat::RGBA4 ||
-		format == internalcolorFormat::RGB5_A1) {
-		_pTexture->textureBytes <<= 1;
+	if (format == internalcolorFormat::COMPRESSED_RGBA_BC1)
+		return blocks << 3;
+	if (format == internalcolorFormat::COMPRESSED_RGBA_BC2 ||
+		format == internalcolorFormat::COMPRESSED_RGBA_BC3 ||
+		format == internalcolorFormat::COMPRESSED_RGBA_BC7 ||
+		format == internalcolorFormat::COMPRESSED_RGBA8_ETC2 ||
+		format == internalcolorFormat::COMPRESSED_RGBA_ASTC_4x4)
+		return blocks << 4;
+	return 0;
+}
+
+static
+void _initHiresTexture(const GHQTexInfo & _info, ObjectHandle _handle, u32 _textureUnitIndex)
+{
+	const u32 compressedSize = _compressedTextureSize(_info);
+	if (compressedSize != 0) {
+		Context::InitCompressedTextureParams params;
+		params.handle = _handle;
+		params.textureUnitIndex = textureIndices::Tex[_textureUnitIndex];
+		params.mipMapLevel = 0;
+		params.width = _info.width;
+		params.height = _info.height;
+		params.internalFormat = InternalColorFormatParam(_info.format);
+		params.dataSize = compressedSize;
+		params.data = _info.data;
+		gfxContext.init2DCompressedTexture(params);
+		return;
 	}
-	else {
-		_pTexture->textureBytes <<= 2;
+
+	Context::InitTextureParams params;
+	params.handle = _handle;
+	params.textureUnitIndex = textureIndices::Tex[_textureUnitIndex];
+	params.mipMapLevel = 0;
+	params.msaaLevel = 0;
+	params.width = _info.width;
+	params.height = _info.height;
+	params.internalFormat = InternalColorFormatParam(_info.format);
+	params.format = ColorFormatParam(_info.texture_format);
+	params.dataType = DatatypeParam(_info.pixel_type);
+	params.data = _info.data;
+	gfxContext.init2DTexture(params);
+}
+
+inline
+void _updateCachedTexture(const GHQTexInfo & _info, CachedTexture *_pTexture, f32 _scale)
+{
+	_pTexture->textureBytes = _compressedTextureSize(_info);
+	if (_pTexture->textureBytes == 0) {
+		_pTexture->textureBytes = _info.width * _info.height;
+
+		Parameter format(_info.format);
+		if (format == internalcolorFormat::RGB8 ||
+			format == internalcolorFormat::RGBA4 ||
+			format == internalcolorFormat::RGB5_A1) {
+			_pTexture->textureBytes <<= 1;
+		}
+		else {
+			_pTexture->textureBytes <<= 2;
+		}
 	}
 
 	if (_pTexture->realWidth == _pTexture->width * 2)
@@ -739,17 +809,7 @@ bool TextureCache::_loadHiresBackground(CachedTexture *_pTexture)
 	if (txfilter_hirestex(_pTexture->crc, ricecrc, palette, &ghqTexInfo) &&
 			ghqTexInfo.width != 0 && ghqTexInfo.height != 0) {
 		ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
-		Context::InitTextureParams params;
-		params.handle = _pTexture->name;
-		params.mipMapLevel = 0;
-		params.msaaLevel = 0;
-		params.width = ghqTexInfo.width;
-		params.height = ghqTexInfo.height;
-		params.format = ColorFormatParam(ghqTexInfo.texture_format);
-		params.internalFormat = InternalColorFormatParam(ghqTexInfo.format);
-		params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
-		params.data = ghqTexInfo.data;
-		gfxContext.init2DTexture(params);
+		_initHiresTexture(ghqTexInfo, _pTexture->name, 0);
 
 		assert(!gfxContext.isError());
 		_updateCachedTexture(ghqTexInfo, _pTexture, f32(ghqTexInfo.width) / f32(tile_width));
@@ -800,7 +860,15 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 		free(pSwapped);
 		return;
 	}
-	pDest16 = reinterpret_cast<u16*>(pDest);
+
+	// Texels only read by the driver are decoded straight into the upload buffer
+	const bool bDepthTexture = (config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 &&
+		gDP.colorImage.address == gDP.depthImageAddress;
+	const bool bFilter = (config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0 &&
+		config.textureFilter.txFilterIgnoreBG == 0 &&
+		TFH.isInited();
+	u32 * pTexels = (bDepthTexture || bFilter) ? pDest : _getUploadBuffer(pDest, pTexture->textureBytes);
+	pDest16 = reinterpret_cast<u16*>(pTexels);
 
 	clampSClamp = pTexture->width - 1;
 	clampTClamp = pTexture->height - 1;
@@ -815,13 +883,13 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 			tx = min(x, (u32)clampSClamp);
 
 			if (glInternalFormat == internalcolorFormat::RGBA8)
-				pDest[j++] = GetTexel((u64*)pSrc, tx, 0, pTexture->palette);
+				pTexels[j++] = GetTexel((u64*)pSrc, tx, 0, pTexture->palette);
 			else
 				pDest16[j++] = static_cast<u16>(GetTexel((u64*)pSrc, tx, 0, pTexture->palette));
 		}
 	}
 
-	if ((config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 && gDP.colorImage.address == gDP.depthImageAddress) {
+	if (bDepthTexture) {
 		_loadDepthTexture(pTexture, (u16*)pDest);
 		free(pDest);
 		free(pSwapped);
@@ -829,9 +897,7 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 	}
 
 	bool bLoaded = false;
-	if ((config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0 &&
-			config.textureFilter.txFilterIgnoreBG == 0 &&
-			TFH.isInited()) {
+	if (bFilter) {
 		GHQTexInfo ghqTexInfo;
 		if (txfilter_filter((u8*)pDest, pTexture->realWidth, pTexture->realHeight,
 				(u16)u32(glInternalFormat), (uint64)pTexture->crc, &ghqTexInfo) != 0 &&
@@ -870,8 +936,15 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 		params.format = colorFormat::RGBA;
 		params.internalFormat = gfxContext.convertInternalTextureFormat(u32(glInternalFormat));
 		params.dataType = glType;
-		params.data = pDest;
-		gfxContext.init2DTexture(params);
+		if (pTexels != pDest) {
+			PixelBufferBinder<PixelWriteBuffer> binder(m_uploadBuffer.get());
+			params.data = m_uploadBuffer->getData();
+			gfxContext.init2DTexture(params);
+			m_uploadBuffer->closeWriteBuffer();
+		} else {
+			params.data = pDest;
+			gfxContext.init2DTexture(params);
+		}
 	}
 	if (m_curUnpackAlignment > 1)
 		gfxContext.setTextureUnpackAlignment(m_curUnpackAlignment);
@@ -948,18 +1021,7 @@ bool TextureCache::_loadHiresTexture(u32 _tile, CachedTexture *_pTexture, u64 &
 	if (txfilter_hirestex(_pTexture->crc, _ricecrc, palette, &ghqTexInfo) &&
 		ghqTexInfo.width != 0 && ghqTexInfo.height != 0) {
 		ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
-		Context::InitTextureParams params;
-		params.handle = _pTexture->name;
-		params.mipMapLevel = 0;
-		params.msaaLevel = 0;
-		params.width = ghqTexInfo.width;
-		params.height = ghqTexInfo.height;
-		params.internalFormat = InternalColorFormatParam(ghqTexInfo.format);
-		params.format = ColorFormatParam(ghqTexInfo.texture_format);
-		params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
-		params.data = ghqTexInfo.data;
-		params.textureUnitIndex = textureIndices::Tex[_tile];
-		gfxContext.init2DTexture(params);
+		_initHiresTexture(ghqTexInfo, _pTexture->name, _tile);
 		assert(!gfxContext.isError());
 		_updateCachedTexture(ghqTexInfo, _pTexture, f32(ghqTexInfo.width) / f32(width));
 		return true;
@@ -1159,18 +1221,31 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 
 	line = tmptex.line;
 
+	// Texels only read by the driver are decoded straight into the upload buffer
+	const bool bDepthTexture = (config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 &&
+		gDP.colorImage.address == gDP.depthImageAddress;
+	const bool bDump = m_toggleDumpTex &&
+		config.textureFilter.txHiresEnable != 0 &&
+		config.textureFilter.txDump != 0;
+	const bool bFilter = (config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0 &&
+		_pTexture->max_level == 0 &&
+		(config.textureFilter.txFilterIgnoreBG == 0 || (RSP.cmd != G_TEXRECT && RSP.cmd != G_TEXRECTFLIP)) &&
+		TFH.isInited();
+	const bool bUploadBuffer = !bDepthTexture && !bDump && !bFilter;
+
 	while (true) {
-		_getTextureDestData(tmptex, pDest, glInternalFormat, GetTexel, &line);
+		u32 * pTexels = bUploadBuffer ?
+			_getUploadBuffer(pDest, (tmptex.realWidth * tmptex.realHeight) << sizeShift) :
+			pDest;
+		_getTextureDestData(tmptex, pTexels, glInternalFormat, GetTexel, &line);
 
-		if ((config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 && gDP.colorImage.address == gDP.depthImageAddress) {
+		if (bDepthTexture) {
 			_loadDepthTexture(_pTexture, (u16*)pDest);
 			free(pDest);
 			return;
 		}
 
-		if (m_toggleDumpTex &&
-				config.textureFilter.txHiresEnable != 0 &&
-				config.textureFilter.txDump != 0) {
+		if (bDump) {
 			txfilter_dmptx((u8*)pDest, tmptex.realWidth, tmptex.realHeight,
 					tmptex.realWidth, (u16)u32(glInternalFormat),
 					(unsigned short)(_pTexture->format << 8 | _pTexture->size),
@@ -1178,11 +1253,7 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 		}
 
 		bool bLoaded = false;
-		if ((config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0 &&
-				_pTexture->max_level == 0 &&
-				(config.textureFilter.txFilterIgnoreBG == 0 || (RSP.cmd != G_TEXRECT && RSP.cmd != G_TEXRECTFLIP)) &&
-				TFH.isInited())
-		{
+		if (bFilter) {
 			GHQTexInfo ghqTexInfo;
 			if (txfilter_filter((u8*)pDest, tmptex.realWidth, tmptex.realHeight,
 							(u16)u32(glInternalFormat), (uint64)_pTexture->crc,
@@ -1220,8 +1291,15 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 			params.internalFormat = gfxContext.convertInternalTextureFormat(u32(glInternalFormat));
 			params.format = colorFormat::RGBA;
 			params.dataType = glType;
-			params.data = pDest;
-			gfxContext.init2DTexture(params);
+			if (pTexels != pDest) {
+				PixelBufferBinder<PixelWriteBuffer> binder(m_uploadBuffer.get());
+				params.data = m_uploadBuffer->getData();
+				gfxContext.init2DTexture(params);
+				m_uploadBuffer->closeWriteBuffer();
+			} else {
+				params.data = pDest;
+				gfxContext.init2DTexture(params);
+			}
 		}
 		if (mipLevel == _pTexture->max_level)
 			break;
@@ -4,11 +4,13 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <memory>
 
 #include "CRC.h"
 #include "convert.h"
 #include "Graphics/ObjectHandle.h"
 #include "Graphics/Parameter.h"
+#include "Graphics/PixelBuffer.h"
 
 typedef u32 (*GetTexelFunc)( u64 *src, u16 x, u16 i, u8 palette );
 
@@ -44,6 +46,9 @@ struct CachedTexture
 		fbMultiSample = 2
 	} frameBufferTexture;
 	bool bHDTexture;
+	u32		atlasGeneration = 0;	  // TexrectAtlas generation of the atlas place
+	u16		atlasX = 0, atlasY = 0;	  // Atlas place, inside its border
+	u8		atlasPage = 0;
 };
 
 
@@ -88,6 +93,7 @@ private:
 	void _clear();
 	void _initDummyTexture(CachedTexture * _pDummy);
 	void _getTextureDestData(CachedTexture& tmptex, u32* pDest, graphics::Parameter glInternalFormat, GetTexelFunc GetTexel, u16* pLine);
+	u32 * _getUploadBuffer(u32 * _pDest, u32 _bytes);
 
 	typedef std::list<CachedTexture> Textures;
 	typedef std::unordered_map<u32, Textures::iterator> Texture_Locations;
@@ -100,6 +106,7 @@ private:
 	u32 m_hits, m_misses;
 	s32 m_curUnpackAlignment;
 	bool m_toggleDumpTex;
+	std::unique_ptr<graphics::PixelWriteBuffer> m_uploadBuffer;
 #ifdef VC
 	const size_t m_maxCacheSize = 1500;
 #else
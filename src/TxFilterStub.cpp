@@ -2,6 +2,7 @@
 
 TAPI boolean TAPIENTRY
 txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+	int hirescachesize, int diskcachesize, int dumpcompression,
 	const wchar_t *txCachePath, const wchar_t *txDumpPath, const wchar_t * texPackPath,
 	const wchar_t* ident, dispInfoFuncExt callback)
 {
@@ -46,3 +47,7 @@ txfilter_reloadhirestex()
 TAPI void TAPIENTRY
 txfilter_dumpcache(void)
 {}
+
+TAPI void TAPIENTRY
+txfilter_cachestats(GHQCacheStats *texcache, GHQCacheStats *hirescache)
+{}
@@ -112,7 +112,6 @@ void VI_UpdateScreen()
 		return;
 	if (wnd.resizeWindow())
 		return;
-	wnd.saveScreenshot();
 	g_debugger.checkDebugState();
 
 	if (isKeyPressed(G64_VK_G, 0x0001)) {
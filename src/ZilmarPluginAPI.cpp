@@ -6,6 +6,7 @@
 
 #include "PluginAPI.h"
 #include "N64.h"
+#include "Log.h"
 
 extern "C" {
 
@@ -23,6 +24,7 @@ EXPORT void CALL CaptureScreen ( char * Directory )
 EXPORT void CALL CloseDLL (void)
 {
 	api().CloseDLL();
+	closeLog();
 }
 
 EXPORT void CALL DllAbout ( HWND hParent )
@@ -16,6 +16,7 @@
 #include <FrameBufferInfo.h>
 #include <TextureFilterHandler.h>
 #include <Log.h>
+#include <GBITrace.h>
 #include "Graphics/Context.h"
 #include <DisplayWindow.h>
 
@@ -28,41 +29,58 @@ PluginAPI & PluginAPI::get()
 #ifdef RSPTHREAD
 class APICommand {
 public:
+	APICommand() : m_done(false) {}
+	virtual ~APICommand() {}
 	virtual bool run() = 0;
+
+	bool isDone() const { return m_done; }
+	void setDone() { m_done = true; }
+
+private:
+	bool m_done;
 };
 
-void RSP_ThreadProc(std::mutex * _pRspThreadMtx, std::mutex * _pPluginThreadMtx, std::condition_variable_any * _pRspThreadCv, std::condition_variable_any * _pPluginThreadCv, APICommand ** _pCommand)
+void PluginAPI::_rspThreadProc()
 {
-	_pRspThreadMtx->lock();
-	RSP_Init();
-	GBI.init();
-	Config_LoadConfig();
-	dwnd().start();
-	assert(!gfxContext.isError());
-
+	std::unique_lock<std::mutex> lock(m_rspThreadMtx);
 	while (true) {
-		_pPluginThreadMtx->lock();
-		_pPluginThreadCv->notify_one();
-		_pPluginThreadMtx->unlock();
-		_pRspThreadCv->wait(*_pRspThreadMtx);
-		if (*_pCommand != nullptr && !(*_pCommand)->run())
-			return;
+		m_rspThreadCv.wait(lock, [this] { return !m_commands.empty(); });
+		APICommand * pCommand = m_commands.front();
+		m_commands.pop_front();
+		lock.unlock();
+
+		const bool bContinue = pCommand->run();
 		assert(!gfxContext.isError());
+
+		lock.lock();
+		pCommand->setDone();
+		m_pluginThreadCv.notify_all();
+		if (!bContinue)
+			return;
 	}
 }
 
 void PluginAPI::_callAPICommand(APICommand & _command)
 {
-	m_pCommand = &_command;
-	m_pluginThreadMtx.lock();
-	m_rspThreadMtx.lock();
+	// The caller waits until the command is done, so the RSP thread never runs
+	// while the emulator changes RDRAM or registers.
+	std::unique_lock<std::mutex> lock(m_rspThreadMtx);
+	m_commands.push_back(&_command);
 	m_rspThreadCv.notify_one();
-	m_rspThreadMtx.unlock();
-	m_pluginThreadCv.wait(m_pluginThreadMtx);
-	m_pluginThreadMtx.unlock();
-	m_pCommand = nullptr;
+	m_pluginThreadCv.wait(lock, [&_command] { return _command.isDone(); });
 }
 
+class RomOpenCommand : public APICommand {
+public:
+	bool run() {
+		RSP_Init();
+		GBI.init();
+		Config_LoadConfig();
+		dwnd().start();
+		return true;
+	}
+};
+
 class ProcessDListCommand : public APICommand {
 public:
 	bool run() {
@@ -119,34 +137,70 @@ private:
 	long * m_height;
 };
 
-class RomClosedCommand : public APICommand {
+class ReadScreen2Command : public APICommand {
+public:
+	ReadScreen2Command(void * _dest, int * _width, int * _height, int _front)
+		: m_dest(_dest)
+		, m_width(_width)
+		, m_height(_height)
+		, m_front(_front) {
+	}
+
+	bool run() {
+		dwnd().readScreen2(m_dest, m_width, m_height, m_front);
+		return true;
+	}
+
+private:
+	void * m_dest;
+	int * m_width;
+	int * m_height;
+	int m_front;
+};
+
+class FBWListCommand : public APICommand {
 public:
-	RomClosedCommand(std::mutex * _pRspThreadMtx,
-		std::mutex * _pPluginThreadMtx,
-		std::condition_variable_any * _pRspThreadCv,
-		std::condition_variable_any * _pPluginThreadCv)
-		: m_pRspThreadMtx(_pRspThreadMtx)
-		, m_pPluginThreadMtx(_pPluginThreadMtx)
-		, m_pRspThreadCv(_pRspThreadCv)
-		, m_pPluginThreadCv(_pPluginThreadCv) {
+	FBWListCommand(FBInfo::FrameBufferModifyEntry * _plist, u32 _size) : m_plist(_plist), m_size(_size) {
 	}
 
+	bool run() {
+		FBInfo::fbInfo.WriteList(m_plist, m_size);
+		return true;
+	}
+private:
+	FBInfo::FrameBufferModifyEntry * m_plist;
+	u32 m_size;
+};
+
+class FBGetFrameBufferInfoCommand : public APICommand {
+public:
+	FBGetFrameBufferInfoCommand(void * _pinfo) : m_pinfo(_pinfo) {
+	}
+
+	bool run() {
+		FBInfo::fbInfo.GetInfo(m_pinfo);
+		return true;
+	}
+private:
+	void * m_pinfo;
+};
+
+class ChangeWindowCommand : public APICommand {
+public:
+	bool run() {
+		dwnd().setToggleFullscreen();
+		return true;
+	}
+};
+
+class RomClosedCommand : public APICommand {
+public:
 	bool run() {
 		TFH.dumpcache();
 		dwnd().stop();
 		GBI.destroy();
-		m_pRspThreadMtx->unlock();
-		m_pPluginThreadMtx->lock();
-		m_pPluginThreadCv->notify_one();
-		m_pPluginThreadMtx->unlock();
 		return false;
 	}
-
-private:
-	std::mutex * m_pRspThreadMtx;
-	std::mutex * m_pPluginThreadMtx;
-	std::condition_variable_any * m_pRspThreadCv;
-	std::condition_variable_any * m_pPluginThreadCv;
 };
 #endif
 
@@ -154,7 +208,8 @@ void PluginAPI::ProcessDList()
 {
 	LOG(LOG_APIFUNC, "ProcessDList\n");
 #ifdef RSPTHREAD
-	_callAPICommand(ProcessDListCommand());
+	ProcessDListCommand command;
+	_callAPICommand(command);
 #else
 	RSP_ProcessDList();
 #endif
@@ -164,7 +219,8 @@ void PluginAPI::ProcessRDPList()
 {
 	LOG(LOG_APIFUNC, "ProcessRDPList\n");
 #ifdef RSPTHREAD
-	_callAPICommand(ProcessRDPListCommand());
+	ProcessRDPListCommand command;
+	_callAPICommand(command);
 #else
 	RDP_ProcessRDPList();
 #endif
@@ -175,12 +231,9 @@ void PluginAPI::RomClosed()
 	LOG(LOG_APIFUNC, "RomClosed\n");
 	m_bRomOpen = false;
 #ifdef RSPTHREAD
-	_callAPICommand(RomClosedCommand(
-					&m_rspThreadMtx,
-					&m_pluginThreadMtx,
-					&m_rspThreadCv,
-					&m_pluginThreadCv)
-	);
+	RomClosedCommand romClosed;
+	_callAPICommand(romClosed);
+	m_pRspThread->join();
 	delete m_pRspThread;
 	m_pRspThread = nullptr;
 #else
@@ -188,17 +241,17 @@ void PluginAPI::RomClosed()
 	dwnd().stop();
 	GBI.destroy();
 #endif
+	gbiTrace().stop();
+	flushLog();
 }
 
 void PluginAPI::RomOpen()
 {
 	LOG(LOG_APIFUNC, "RomOpen\n");
 #ifdef RSPTHREAD
-	m_pluginThreadMtx.lock();
-	m_pRspThread = new std::thread(RSP_ThreadProc, &m_rspThreadMtx, &m_pluginThreadMtx, &m_rspThreadCv, &m_pluginThreadCv, &m_pCommand);
-	m_pRspThread->detach();
-	m_pluginThreadCv.wait(m_pluginThreadMtx);
-	m_pluginThreadMtx.unlock();
+	m_pRspThread = new std::thread(&PluginAPI::_rspThreadProc, this);
+	RomOpenCommand romOpen;
+	_callAPICommand(romOpen);
 #else
 	RSP_Init();
 	GBI.init();
@@ -217,7 +270,8 @@ void PluginAPI::UpdateScreen()
 {
 	LOG(LOG_APIFUNC, "UpdateScreen\n");
 #ifdef RSPTHREAD
-	_callAPICommand(ProcessUpdateScreenCommand());
+	ProcessUpdateScreenCommand command;
+	_callAPICommand(command);
 #else
 	VI_UpdateScreen();
 #endif
@@ -262,20 +316,30 @@ void PluginAPI::_initiateGFX(const GFX_INFO & _gfxInfo) const {
 void PluginAPI::ChangeWindow()
 {
 	LOG(LOG_APIFUNC, "ChangeWindow\n");
+#ifdef RSPTHREAD
+	if (m_pRspThread != nullptr) {
+		ChangeWindowCommand command;
+		_callAPICommand(command);
+	} else
+		dwnd().setToggleFullscreen();
+#else
 	dwnd().setToggleFullscreen();
+#endif
 	if (!m_bRomOpen)
 		dwnd().closeWindow();
 }
 
 void PluginAPI::FBWrite(unsigned int _addr, unsigned int _size)
 {
+	// Called for every CPU write. The RSP thread is idle between commands, so it is not queued.
 	FBInfo::fbInfo.Write(_addr, _size);
 }
 
 void PluginAPI::FBRead(unsigned int _addr)
 {
 #ifdef RSPTHREAD
-	_callAPICommand(FBReadCommand(_addr));
+	FBReadCommand command(_addr);
+	_callAPICommand(command);
 #else
 	FBInfo::fbInfo.Read(_addr);
 #endif
@@ -283,21 +347,44 @@ void PluginAPI::FBRead(unsigned int _addr)
 
 void PluginAPI::FBGetFrameBufferInfo(void * _pinfo)
 {
+#ifdef RSPTHREAD
+	FBGetFrameBufferInfoCommand command(_pinfo);
+	_callAPICommand(command);
+#else
 	FBInfo::fbInfo.GetInfo(_pinfo);
+#endif
 }
 
 #ifndef MUPENPLUSAPI
 void PluginAPI::FBWList(FrameBufferModifyEntry * _plist, unsigned int _size)
 {
+#ifdef RSPTHREAD
+	FBWListCommand command(reinterpret_cast<FBInfo::FrameBufferModifyEntry*>(_plist), _size);
+	_callAPICommand(command);
+#else
 	FBInfo::fbInfo.WriteList(reinterpret_cast<FBInfo::FrameBufferModifyEntry*>(_plist), _size);
+#endif
 }
 
 void PluginAPI::ReadScreen(void **_dest, long *_width, long *_height)
 {
 #ifdef RSPTHREAD
-	_callAPICommand(ReadScreenCommand(_dest, _width, _height));
+	ReadScreenCommand command(_dest, _width, _height);
+	_callAPICommand(command);
 #else
 	dwnd().readScreen(_dest, _width, _height);
 #endif
 }
+#else
+void PluginAPI::ReadScreen2(void * _dest, int * _width, int * _height, int _front)
+{
+#ifdef RSPTHREAD
+	if (m_pRspThread != nullptr) {
+		ReadScreen2Command command(_dest, _width, _height, _front);
+		_callAPICommand(command);
+		return;
+	}
+#endif
+	dwnd().readScreen2(_dest, _width, _height, _front);
+}
 #endif
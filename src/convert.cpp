@@ -1,5 +1,17 @@
+#include <algorithm>
 #include "convert.h"
 
+#if defined(__SSSE3__)
+#define CONVERT_SSSE3
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONVERT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
 const volatile unsigned char Five2Eight[32] =
 {
 	  0, // 00000 = 00000000
@@ -99,6 +111,118 @@ const volatile unsigned char One2Eight[2] =
 	255, // 1 = 11111111
 };
 
+// Reverse the bytes of every dword (_unswap16) or qword (_reverse16) in 16 bytes.
+#if defined(CONVERT_SSSE3)
+static inline void _unswap16(const u8 *src, u8 *dest)
+{
+	const __m128i mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	const __m128i v = _mm_loadu_si128((const __m128i*)src);
+	_mm_storeu_si128((__m128i*)dest, _mm_shuffle_epi8(v, mask));
+}
+
+static inline void _reverse16(const u8 *src, u8 *dest)
+{
+	const __m128i mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	const __m128i v = _mm_loadu_si128((const __m128i*)src);
+	_mm_storeu_si128((__m128i*)dest, _mm_shuffle_epi8(v, mask));
+}
+#elif defined(CONVERT_SSE2)
+static inline __m128i _swapBytes16(__m128i v)
+{
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline void _unswap16(const u8 *src, u8 *dest)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)src);
+	v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	_mm_storeu_si128((__m128i*)dest, _swapBytes16(v));
+}
+
+static inline void _reverse16(const u8 *src, u8 *dest)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)src);
+	v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+	_mm_storeu_si128((__m128i*)dest, _swapBytes16(v));
+}
+#elif defined(CONVERT_NEON)
+static inline void _unswap16(const u8 *src, u8 *dest)
+{
+	vst1q_u8(dest, vrev32q_u8(vld1q_u8(src)));
+}
+
+static inline void _reverse16(const u8 *src, u8 *dest)
+{
+	vst1q_u8(dest, vrev64q_u8(vld1q_u8(src)));
+}
+#else
+static inline void _unswap16(const u8 *src, u8 *dest)
+{
+	for (u32 i = 0; i < 16; i += 4) {
+		dest[i + 0] = src[i + 3];
+		dest[i + 1] = src[i + 2];
+		dest[i + 2] = src[i + 1];
+		dest[i + 3] = src[i + 0];
+	}
+}
+
+static inline void _reverse16(const u8 *src, u8 *dest)
+{
+	for (u32 i = 0; i < 16; ++i)
+		dest[i] = src[i ^ 7];
+}
+#endif
+
+static inline bool _isWrapMask(u32 _mask)
+{
+	return (_mask & (_mask + 1)) == 0;
+}
+
+// Copies numDWords dwords from a dword aligned src, reversing the bytes of each,
+// to dest + destIdx wrapped by destMask. The copy is split at the wrap point.
+static void _unswapDWords(const u8 *src, u8 *dest, u32 destIdx, u32 destMask, u32 numDWords)
+{
+	if (!_isWrapMask(destMask)) {
+		while (numDWords--) {
+			dest[(destIdx + 3) & destMask] = *src++;
+			dest[(destIdx + 2) & destMask] = *src++;
+			dest[(destIdx + 1) & destMask] = *src++;
+			dest[(destIdx + 0) & destMask] = *src++;
+			destIdx += 4;
+		}
+		return;
+	}
+
+	while (numDWords != 0) {
+		destIdx &= destMask;
+		const u32 spanBytes = destMask + 1 - destIdx;
+		u32 spanDWords = std::min(numDWords, spanBytes >> 2);
+		numDWords -= spanDWords;
+
+		u8 *pDest = dest + destIdx;
+		destIdx += spanDWords << 2;
+		for (; spanDWords >= 4; spanDWords -= 4, src += 16, pDest += 16)
+			_unswap16(src, pDest);
+		for (; spanDWords > 0; --spanDWords, src += 4, pDest += 4) {
+			pDest[0] = src[3];
+			pDest[1] = src[2];
+			pDest[2] = src[1];
+			pDest[3] = src[0];
+		}
+
+		// a dword straddling the wrap point
+		if (numDWords != 0 && (spanBytes & 3) != 0) {
+			dest[(destIdx + 3) & destMask] = src[0];
+			dest[(destIdx + 2) & destMask] = src[1];
+			dest[(destIdx + 1) & destMask] = src[2];
+			dest[(destIdx + 0) & destMask] = src[3];
+			destIdx += 4;
+			src += 4;
+			--numDWords;
+		}
+	}
+}
+
 void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes)
 {
 	// copy leading bytes
@@ -119,14 +243,10 @@ void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMa
 	}
 
 	// copy dwords
-	int numDWords = numBytes >> 2;
-	while (numDWords--) {
-		dest[(destIdx + 3) & destMask] = src[srcIdx++];
-		dest[(destIdx + 2) & destMask] = src[srcIdx++];
-		dest[(destIdx + 1) & destMask] = src[srcIdx++];
-		dest[(destIdx + 0) & destMask] = src[srcIdx++];
-		destIdx += 4;
-	}
+	const u32 numDWords = numBytes >> 2;
+	_unswapDWords(src + srcIdx, dest, destIdx, destMask, numDWords);
+	srcIdx += numDWords << 2;
+	destIdx += numDWords << 2;
 
 	// copy trailing bytes
 	int trailingBytes = numBytes & 3;
@@ -143,6 +263,33 @@ void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMa
 void DWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords)
 {
 	u32 p0, idx0, idx1;
+	if ((srcIdx & 1) == 0 && srcMask != 0 && _isWrapMask(srcMask)) {
+		// qwords do not straddle the wrap point
+		while (numQWords != 0) {
+			srcIdx &= srcMask;
+			u32 spanQWords = std::min(numQWords, (srcMask + 1 - srcIdx) >> 1);
+			numQWords -= spanQWords;
+
+			u32 *pSrc = src + srcIdx;
+			srcIdx += spanQWords << 1;
+#if defined(CONVERT_SSE2) || defined(CONVERT_SSSE3)
+			for (; spanQWords >= 2; spanQWords -= 2, pSrc += 4) {
+				const __m128i v = _mm_loadu_si128((const __m128i*)pSrc);
+				_mm_storeu_si128((__m128i*)pSrc, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+			}
+#elif defined(CONVERT_NEON)
+			for (; spanQWords >= 2; spanQWords -= 2, pSrc += 4)
+				vst1q_u32(pSrc, vrev64q_u32(vld1q_u32(pSrc)));
+#endif
+			for (; spanQWords > 0; --spanQWords, pSrc += 2) {
+				p0 = pSrc[0];
+				pSrc[0] = pSrc[1];
+				pSrc[1] = p0;
+			}
+		}
+		return;
+	}
+
 	while (numQWords--)	{
 		idx0 = srcIdx++ & srcMask;
 		idx1 = srcIdx++ & srcMask;
@@ -151,3 +298,40 @@ void DWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords)
 		src[idx1] = p0;
 	}
 }
+
+void UnswapCopyInterleaveWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes, u32 numQWords)
+{
+	// Unswapping and swapping the dwords of a qword together reverse its bytes.
+	// Copies which may overwrite themselves take the two pass path.
+	if ((srcIdx & 3) != 0 || (destIdx & 7) != 0 || destMask < 7 || !_isWrapMask(destMask) ||
+		numBytes > destMask + 1 || (numQWords << 3) > destMask + 1) {
+		UnswapCopyWrap(src, srcIdx, dest, destIdx, destMask, numBytes);
+		DWordInterleaveWrap((u32*)dest, destIdx >> 2, destMask >> 2, numQWords);
+		return;
+	}
+
+	u32 qwords = std::min(numBytes >> 3, numQWords);
+	const u8 *pSrc = src + srcIdx;
+	numBytes -= qwords << 3;
+	numQWords -= qwords;
+	srcIdx += qwords << 3;
+
+	while (qwords != 0) {
+		destIdx &= destMask;
+		u32 spanQWords = std::min(qwords, (destMask + 1 - destIdx) >> 3);
+		qwords -= spanQWords;
+
+		u8 *pDest = dest + destIdx;
+		destIdx += spanQWords << 3;
+		for (; spanQWords >= 2; spanQWords -= 2, pSrc += 16, pDest += 16)
+			_reverse16(pSrc, pDest);
+		for (; spanQWords > 0; --spanQWords, pSrc += 8, pDest += 8) {
+			for (u32 i = 0; i < 8; ++i)
+				pDest[i] = pSrc[i ^ 7];
+		}
+	}
+
+	// the rest of a line which is shorter or longer than the copy
+	UnswapCopyWrap(src, srcIdx, dest, destIdx, destMask, numBytes);
+	DWordInterleaveWrap((u32*)dest, destIdx >> 2, destMask >> 2, numQWords);
+}
@@ -15,6 +15,9 @@ void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMa
 
 void DWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords);
 
+// UnswapCopyWrap followed by DWordInterleaveWrap((u32*)dest, destIdx >> 2, destMask >> 2, numQWords) in one pass
+void UnswapCopyInterleaveWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes, u32 numQWords);
+
 inline u16 swapword( u16 value )
 {
 #ifdef WIN32_ASM
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <stddef.h>
 #include <algorithm>
 #include "N64.h"
 #include "GLideN64.h"
@@ -30,6 +31,15 @@ using namespace graphics;
 #define VEC_OPT 1U
 #endif
 
+// Layout described at SPVertex
+static_assert(offsetof(SPVertex, clip) < 20 && offsetof(SPVertex, flag) < 20, "clip test fields are not in the first 20 bytes");
+static_assert(offsetof(SPVertex, modify) < 48 && offsetof(SPVertex, a) < 48 && offsetof(SPVertex, t) < 48,
+	"smooth shading fields are not in the first 48 bytes");
+static_assert(sizeof(SPVertex) == 64, "SPVertex does not fill one cache line");
+
+// Normals of the vertices being loaded, indexed like the vertex buffer
+static SPNormal vertexNormals[VERTBUFF_SIZE];
+
 static bool g_ConkerUcode;
 
 void gSPFlushTriangles()
@@ -66,19 +76,41 @@ void gSPCombineMatrices(u32 _mode)
 	DebugMsg(DEBUG_NORMAL, "gSPCombineMatrices();\n");
 }
 
-void gSPTriangle(s32 v0, s32 v1, s32 v2)
+// Tests the triangles together and adds those the GPU would draw
+static
+void _gSPTriangles(const s32 * _v, u32 _num)
 {
 	GraphicsDrawer & drawer = dwnd().getDrawer();
-	if ((v0 < INDEXMAP_SIZE) && (v1 < INDEXMAP_SIZE) && (v2 < INDEXMAP_SIZE)) {
-		if (drawer.isClipped(v0, v1, v2)) {
-			DebugMsg(DEBUG_NORMAL, "Triangle clipped (%i, %i, %i)\n", v0, v1, v2);
-			return;
+	s32 v[12];
+	u32 num = 0;
+	for (u32 i = 0; i < _num; ++i) {
+		const s32 * tri = _v + i * 3;
+		if ((tri[0] < INDEXMAP_SIZE) && (tri[1] < INDEXMAP_SIZE) && (tri[2] < INDEXMAP_SIZE)) {
+			v[num * 3] = tri[0];
+			v[num * 3 + 1] = tri[1];
+			v[num * 3 + 2] = tri[2];
+			++num;
+		}
+	}
+
+	const u32 rejected = drawer.rejectTriangles(v, num);
+	for (u32 i = 0; i < num; ++i) {
+		const s32 v0 = v[i * 3], v1 = v[i * 3 + 1], v2 = v[i * 3 + 2];
+		if ((rejected & (1U << i)) != 0) {
+			DebugMsg(DEBUG_NORMAL, "Triangle rejected (%i, %i, %i)\n", v0, v1, v2);
+			continue;
 		}
 		drawer.addTriangle(v0, v1, v2);
 		DebugMsg(DEBUG_NORMAL, "Triangle #%i added (%i, %i, %i)\n", gSP.tri_num++, v0, v1, v2);
 	}
 }
 
+void gSPTriangle(s32 v0, s32 v1, s32 v2)
+{
+	const s32 v[] = { v0, v1, v2 };
+	_gSPTriangles(v, 1);
+}
+
 void gSP1Triangle( const s32 v0, const s32 v1, const s32 v2)
 {
 	DebugMsg(DEBUG_NORMAL, "gSP1Triangle (%i, %i, %i)\n", v0, v1, v2);
@@ -92,8 +124,8 @@ void gSP2Triangles(const s32 v00, const s32 v01, const s32 v02, const s32 flag0,
 {
 	DebugMsg(DEBUG_NORMAL, "gSP2Triangle (%i, %i, %i)-(%i, %i, %i)\n", v00, v01, v02, v10, v11, v12);
 
-	gSPTriangle( v00, v01, v02);
-	gSPTriangle( v10, v11, v12);
+	const s32 v[] = { v00, v01, v02, v10, v11, v12 };
+	_gSPTriangles(v, 2);
 	gSPFlushTriangles();
 }
 
@@ -105,10 +137,8 @@ void gSP4Triangles(const s32 v00, const s32 v01, const s32 v02,
 	DebugMsg(DEBUG_NORMAL, "gSP4Triangle (%i, %i, %i)-(%i, %i, %i)-(%i, %i, %i)-(%i, %i, %i)\n",
 			 v00, v01, v02, v10, v11, v12, v20, v21, v22, v30, v31, v32);
 
-	gSPTriangle(v00, v01, v02);
-	gSPTriangle(v10, v11, v12);
-	gSPTriangle(v20, v21, v22);
-	gSPTriangle(v30, v31, v32);
+	const s32 v[] = { v00, v01, v02, v10, v11, v12, v20, v21, v22, v30, v31, v32 };
+	_gSPTriangles(v, 4);
 	gSPFlushTriangles();
 }
 
@@ -470,7 +500,7 @@ void gSPInverseTransformVector_default(float vec[3], float mtx[4][4])
 }
 
 template <u32 VNUM>
-void gSPLightVertexStandard(u32 v, SPVertex * spVtx)
+void gSPLightVertexStandard(u32 v, SPVertex * spVtx, SPNormal * spNorm)
 {
 #ifndef __NEON_OPT
 	if (!isHWLightingAllowed()) {
@@ -482,7 +512,7 @@ void gSPLightVertexStandard(u32 v, SPVertex * spVtx)
 			vtx.HWLight = 0;
 
 			for (u32 i = 0; i < gSP.numLights; ++i) {
-				const f32 intensity = DotProduct( &vtx.nx, gSP.lights.i_xyz[i] );
+				const f32 intensity = DotProduct( &spNorm[v+j].x, gSP.lights.i_xyz[i] );
 				if (intensity > 0.0f) {
 					vtx.r += gSP.lights.rgb[i][R] * intensity;
 					vtx.g += gSP.lights.rgb[i][G] * intensity;
@@ -501,8 +531,8 @@ void gSPLightVertexStandard(u32 v, SPVertex * spVtx)
 		}
 	}
 #else
-	void gSPLightVertex_NEON(u32 vnum, u32 v, SPVertex * spVtx);
-	gSPLightVertex_NEON(VNUM, v, spVtx);
+	void gSPLightVertex_NEON(u32 vnum, u32 v, SPVertex * spVtx, SPNormal * spNorm);
+	gSPLightVertex_NEON(VNUM, v, spVtx, spNorm);
 #endif
 }
 
@@ -541,25 +571,26 @@ void gSPLightVertexCBFD(u32 v, SPVertex * spVtx)
 }
 
 template <u32 VNUM>
-void gSPLightVertex(u32 _v, SPVertex * _spVtx)
+void gSPLightVertex(u32 _v, SPVertex * _spVtx, SPNormal * _spNorm)
 {
 	if (g_ConkerUcode)
 		gSPLightVertexCBFD<VNUM>(_v, _spVtx);
 	else
-		gSPLightVertexStandard<VNUM>(_v, _spVtx);
+		gSPLightVertexStandard<VNUM>(_v, _spVtx, _spNorm);
 }
 
-void gSPLightVertex(SPVertex & _vtx)
+void gSPLightVertex(SPVertex & _vtx, SPNormal & _normal)
 {
-	gSPLightVertex<1>(0, &_vtx);
+	gSPLightVertex<1>(0, &_vtx, &_normal);
 }
 
 template <u32 VNUM>
-void gSPPointLightVertexZeldaMM(u32 v, float _vecPos[VNUM][4], SPVertex * spVtx)
+void gSPPointLightVertexZeldaMM(u32 v, float _vecPos[VNUM][4], SPVertex * spVtx, SPNormal * spNorm)
 {
 	f32 intensity = 0.0f;
 	for (int j = 0; j < VNUM; ++j) {
 		SPVertex & vtx = spVtx[v + j];
+		const SPNormal & nrm = spNorm[v + j];
 		vtx.HWLight = 0;
 		vtx.r = gSP.lights.rgb[gSP.numLights][R];
 		vtx.g = gSP.lights.rgb[gSP.numLights][G];
@@ -588,7 +619,7 @@ void gSPPointLightVertexZeldaMM(u32 v, float _vecPos[VNUM][4], SPVertex * spVtx)
 						lvec[i] = 1.0f;
 				}
 
-				f32 V = lvec[0] * vtx.nx + lvec[1] * vtx.ny + lvec[2] * vtx.nz;
+				f32 V = lvec[0] * nrm.x + lvec[1] * nrm.y + lvec[2] * nrm.z;
 				if (V < -1.0f)
 					V = -1.0f;
 				if (V > 1.0f)
@@ -599,7 +630,7 @@ void gSPPointLightVertexZeldaMM(u32 v, float _vecPos[VNUM][4], SPVertex * spVtx)
 				intensity = V / D;
 			} else {
 				// Standard lighting
-				intensity = DotProduct(&vtx.nx, gSP.lights.i_xyz[l]);
+				intensity = DotProduct(&nrm.x, gSP.lights.i_xyz[l]);
 			}
 			if (intensity > 0.0f) {
 				vtx.r += gSP.lights.rgb[l][R] * intensity;
@@ -614,17 +645,18 @@ void gSPPointLightVertexZeldaMM(u32 v, float _vecPos[VNUM][4], SPVertex * spVtx)
 }
 
 template <u32 VNUM>
-void gSPPointLightVertexCBFD(u32 v, SPVertex * spVtx)
+void gSPPointLightVertexCBFD(u32 v, SPVertex * spVtx, SPNormal * spNorm)
 {
 	f32 intensity = 0.0f;
 	for (int j = 0; j < VNUM; ++j) {
 		SPVertex & vtx = spVtx[v + j];
+		const SPNormal & nrm = spNorm[v + j];
 		f32 r = gSP.lights.rgb[gSP.numLights][R];
 		f32 g = gSP.lights.rgb[gSP.numLights][G];
 		f32 b = gSP.lights.rgb[gSP.numLights][B];
 
 		for (u32 l = 0; l < gSP.numLights - 1; ++l) {
-			intensity = DotProduct(&vtx.nx, gSP.lights.xyz[l]);
+			intensity = DotProduct(&nrm.x, gSP.lights.xyz[l]);
 			if ((gSP.lights.rgb[l][R] == 0.0f && gSP.lights.rgb[l][G] == 0.0f && gSP.lights.rgb[l][B] == 0.0f) || intensity < 0.0f)
 				continue;
 			if (gSP.lights.ca[l] > 0.0f) {
@@ -642,7 +674,7 @@ void gSPPointLightVertexCBFD(u32 v, SPVertex * spVtx)
 			b += gSP.lights.rgb[l][B] * intensity;
 		}
 
-		intensity = DotProduct(&vtx.nx, gSP.lights.i_xyz[gSP.numLights - 1]);
+		intensity = DotProduct(&nrm.x, gSP.lights.i_xyz[gSP.numLights - 1]);
 		if ((gSP.lights.i_xyz[gSP.numLights - 1][R] != 0.0 || gSP.lights.i_xyz[gSP.numLights - 1][G] != 0.0 || gSP.lights.i_xyz[gSP.numLights - 1][B] != 0.0) && intensity > 0) {
 			r += gSP.lights.rgb[gSP.numLights - 1][R] * intensity;
 			g += gSP.lights.rgb[gSP.numLights - 1][G] * intensity;
@@ -661,12 +693,12 @@ void gSPPointLightVertexCBFD(u32 v, SPVertex * spVtx)
 }
 
 template <u32 VNUM>
-void gSPPointLightVertex(u32 _v, float _vecPos[VNUM][4], SPVertex * _spVtx)
+void gSPPointLightVertex(u32 _v, float _vecPos[VNUM][4], SPVertex * _spVtx, SPNormal * _spNorm)
 {
 	if (g_ConkerUcode)
-		gSPPointLightVertexCBFD<VNUM>(_v, _spVtx);
+		gSPPointLightVertexCBFD<VNUM>(_v, _spVtx, _spNorm);
 	else
-		gSPPointLightVertexZeldaMM<VNUM>(_v, _vecPos, _spVtx);
+		gSPPointLightVertexZeldaMM<VNUM>(_v, _vecPos, _spVtx, _spNorm);
 }
 
 template <u32 VNUM>
@@ -766,7 +798,7 @@ void gSPTransformVertex(u32 v, SPVertex * spVtx, float mtx[4][4])
 }
 
 template <u32 VNUM>
-void gSPProcessVertex(u32 v, SPVertex * spVtx)
+void gSPProcessVertex(u32 v, SPVertex * spVtx, SPNormal * spNorm)
 {
 	if (gSP.changed & CHANGED_MATRIX)
 		_gSPCombineMatrices();
@@ -812,9 +844,9 @@ void gSPProcessVertex(u32 v, SPVertex * spVtx)
 
 	if (gSP.geometryMode & G_LIGHTING) {
 		if (gSP.geometryMode & G_POINT_LIGHTING)
-			gSPPointLightVertex<VNUM>(v, vPos, spVtx);
+			gSPPointLightVertex<VNUM>(v, vPos, spVtx, spNorm);
 		else
-			gSPLightVertex<VNUM>(v, spVtx);
+			gSPLightVertex<VNUM>(v, spVtx, spNorm);
 
 		if (gSP.geometryMode & G_ACCLAIM_LIGHTING)
 			gSPPointLightVertexAcclaim<VNUM>(v, spVtx);
@@ -823,7 +855,8 @@ void gSPProcessVertex(u32 v, SPVertex * spVtx)
 			if (GBI.getMicrocodeType() != F3DFLX2) {
 				for(int i = 0; i < VNUM; ++i) {
 					SPVertex & vtx = spVtx[v+i];
-					f32 fLightDir[3] = {vtx.nx, vtx.ny, vtx.nz};
+					const SPNormal & nrm = spNorm[v+i];
+					f32 fLightDir[3] = {nrm.x, nrm.y, nrm.z};
 					f32 x, y;
 					if (gSP.lookatEnable) {
 						x = DotProduct(gSP.lookat.i_xyz[0], fLightDir);
@@ -851,7 +884,7 @@ void gSPProcessVertex(u32 v, SPVertex * spVtx)
 			} else {
 				for(int i = 0; i < VNUM; ++i) {
 					SPVertex & vtx = spVtx[v+i];
-					const f32 intensity = DotProduct(gSP.lookat.i_xyz[0], &vtx.nx) * 128.0f;
+					const f32 intensity = DotProduct(gSP.lookat.i_xyz[0], &spNorm[v+i].x) * 128.0f;
 					const s16 index = static_cast<s16>(intensity);
 					vtx.a = _FIXED2FLOATCOLOR(RDRAM[(gSP.DMAIO_address + 128 + index) ^ 3], 8);
 				}
@@ -886,9 +919,10 @@ u32 gSPLoadVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi, u3
 			vtx.t = _FIXED2FLOAT( orgVtx->t, 5 );
 
 			if (gSP.geometryMode & G_LIGHTING) {
-				vtx.nx = _FIXED2FLOATCOLOR(orgVtx->normal.x, 7);
-				vtx.ny = _FIXED2FLOATCOLOR(orgVtx->normal.y, 7);
-				vtx.nz = _FIXED2FLOATCOLOR(orgVtx->normal.z, 7);
+				SPNormal & nrm = vertexNormals[vi+j];
+				nrm.x = _FIXED2FLOATCOLOR(orgVtx->normal.x, 7);
+				nrm.y = _FIXED2FLOATCOLOR(orgVtx->normal.y, 7);
+				nrm.z = _FIXED2FLOATCOLOR(orgVtx->normal.z, 7);
 				if (isHWLightingAllowed()) {
 					vtx.r = orgVtx->normal.x;
 					vtx.g = orgVtx->normal.y;
@@ -903,7 +937,7 @@ u32 gSPLoadVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi, u3
 
 			++orgVtx;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 	}
 	return vi;
 }
@@ -956,9 +990,10 @@ u32 gSPLoadCIVertexData(const PDVertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi
 			u8 *color = &RDRAM[gSP.vertexColorBase + (orgVtx->ci & 0xff)];
 
 			if (gSP.geometryMode & G_LIGHTING) {
-				vtx.nx = _FIXED2FLOATCOLOR((s8)color[3], 7);
-				vtx.ny = _FIXED2FLOATCOLOR((s8)color[2], 7);
-				vtx.nz = _FIXED2FLOATCOLOR((s8)color[1], 7);
+				SPNormal & nrm = vertexNormals[vi+j];
+				nrm.x = _FIXED2FLOATCOLOR((s8)color[3], 7);
+				nrm.y = _FIXED2FLOATCOLOR((s8)color[2], 7);
+				nrm.z = _FIXED2FLOATCOLOR((s8)color[1], 7);
 				if (isHWLightingAllowed()) {
 					vtx.r = (s8)color[3];
 					vtx.g = (s8)color[2];
@@ -973,7 +1008,7 @@ u32 gSPLoadCIVertexData(const PDVertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi
 
 			++orgVtx;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 	}
 	return vi;
 }
@@ -1028,7 +1063,7 @@ u32 gSPLoadDMAVertexData(u32 address, SPVertex * spVtx, u32 v0, u32 vi, u32 n)
 
 			address += 10;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 	}
 	return vi;
 }
@@ -1068,9 +1103,10 @@ u32 gSPLoadCBFDVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi
 			vtx.t = _FIXED2FLOAT( orgVtx->t, 5 );
 			if (gSP.geometryMode & G_LIGHTING) {
 				const u32 normaleAddrOffset = ((vi+j)<<1);
-				vtx.nx = _FIXED2FLOATCOLOR(((s8*)RDRAM)[(gSP.vertexNormalBase + normaleAddrOffset + 0) ^ 3], 7);
-				vtx.ny = _FIXED2FLOATCOLOR(((s8*)RDRAM)[(gSP.vertexNormalBase + normaleAddrOffset + 1) ^ 3], 7);
-				vtx.nz = _FIXED2FLOATCOLOR((s8)(orgVtx->flag & 0xFF), 7);
+				SPNormal & nrm = vertexNormals[vi+j];
+				nrm.x = _FIXED2FLOATCOLOR(((s8*)RDRAM)[(gSP.vertexNormalBase + normaleAddrOffset + 0) ^ 3], 7);
+				nrm.y = _FIXED2FLOATCOLOR(((s8*)RDRAM)[(gSP.vertexNormalBase + normaleAddrOffset + 1) ^ 3], 7);
+				nrm.z = _FIXED2FLOATCOLOR((s8)(orgVtx->flag & 0xFF), 7);
 			}
 			vtx.r = _FIXED2FLOATCOLOR(orgVtx->color.r, 8);
 			vtx.g = _FIXED2FLOATCOLOR(orgVtx->color.g, 8);
@@ -1078,7 +1114,7 @@ u32 gSPLoadCBFDVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 vi
 			vtx.a = _FIXED2FLOATCOLOR(orgVtx->color.a, 8);
 			++orgVtx;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 	}
 	return vi;
 }
@@ -1143,9 +1179,10 @@ u32 gSPLoadF3DAMVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 v
 			//vtx.flag = orgVtx->flag;
 			calcF3DAMTexCoords(orgVtx, vtx);
 			if (gSP.geometryMode & G_LIGHTING) {
-				vtx.nx = _FIXED2FLOATCOLOR( orgVtx->normal.x, 7 );
-				vtx.ny = _FIXED2FLOATCOLOR( orgVtx->normal.y, 7 );
-				vtx.nz = _FIXED2FLOATCOLOR( orgVtx->normal.z, 7 );
+				SPNormal & nrm = vertexNormals[vi+j];
+				nrm.x = _FIXED2FLOATCOLOR( orgVtx->normal.x, 7 );
+				nrm.y = _FIXED2FLOATCOLOR( orgVtx->normal.y, 7 );
+				nrm.z = _FIXED2FLOATCOLOR( orgVtx->normal.z, 7 );
 				vtx.a = _FIXED2FLOATCOLOR(orgVtx->color.a,8);
 			} else {
 				vtx.r = _FIXED2FLOATCOLOR(orgVtx->color.r,8);
@@ -1155,7 +1192,7 @@ u32 gSPLoadF3DAMVertexData(const Vertex *orgVtx, SPVertex * spVtx, u32 v0, u32 v
 			}
 			++orgVtx;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 	}
 	return vi;
 }
@@ -1205,7 +1242,7 @@ u32 gSPLoadSWVertexData(const SWVertex *orgVtx, SPVertex * spVtx, u32 vi, u32 n)
 			vtx.z = orgVtx->z;
 			++orgVtx;
 		}
-		gSPProcessVertex<VNUM>(vi, spVtx);
+		gSPProcessVertex<VNUM>(vi, spVtx, vertexNormals);
 		for (u32 j = 0; j < VNUM; ++j) {
 			SPVertex & vtx = spVtx[vi+j];
 			vtx.y = -vtx.y;
@@ -1284,7 +1321,7 @@ void gSPT3DUXVertex(u32 a, u32 n, u32 ci)
 			vertex++;
 			color++;
 		}
-		gSPProcessVertex<4>(v, spVtx);
+		gSPProcessVertex<4>(v, spVtx, vertexNormals);
 	}
 #endif
 	for (; i < n; ++i) {
@@ -1298,7 +1335,7 @@ void gSPT3DUXVertex(u32 a, u32 n, u32 ci)
 		vtx.g = _FIXED2FLOATCOLOR(color->g, 8);
 		vtx.b = _FIXED2FLOATCOLOR(color->b, 8);
 		vtx.a = _FIXED2FLOATCOLOR(color->a, 8);
-		gSPProcessVertex<1>(i, spVtx);
+		gSPProcessVertex<1>(i, spVtx, vertexNormals);
 		vertex++;
 		color++;
 	}
@@ -1493,8 +1530,8 @@ void gSPDMATriangles( u32 tris, u32 n ){
 
 void gSP1Quadrangle( s32 v0, s32 v1, s32 v2, s32 v3 )
 {
-	gSPTriangle( v0, v1, v2);
-	gSPTriangle( v0, v2, v3);
+	const s32 v[] = { v0, v1, v2, v0, v2, v3 };
+	_gSPTriangles(v, 2);
 	gSPFlushTriangles();
 
 	DebugMsg(DEBUG_NORMAL, "gSP1Quadrangle( %i, %i, %i, %i );\n", v0, v1, v2, v3 );
@@ -33,17 +33,27 @@
 enum Component { R, G, B };
 enum Axis { X ,Y, Z, W };
 
+// Fields are ordered by use. The clip test and culling read the first 20 bytes,
+// a draw of smooth shaded triangles reads the first 48 bytes.
+// A vertex fills one 64 byte cache line.
 struct SPVertex
 {
 	f32 x, y, z, w;
-	f32 nx, ny, nz, __pad0;
-	f32 r, g, b, a;
-	f32 flat_r, flat_g, flat_b, flat_a;
-	f32 s, t;
-	u32 modify;
-	u8 HWLight;
 	u8 clip;
+	u8 HWLight;
 	s16 flag;
+	u32 modify;
+	f32 r, g, b, a;
+	f32 s, t;
+	// Flat shading only
+	f32 flat_r, flat_g, flat_b, flat_a;
+};
+
+// Vertex normal. Only lighting and texture coordinate generation read it,
+// so it is kept out of SPVertex, in a buffer indexed like the vertices.
+struct SPNormal
+{
+	f32 x, y, z, __pad0;
 };
 
 struct gSPInfo
@@ -205,7 +215,7 @@ void gSP4Triangles(const s32 v00, const s32 v01, const s32 v02,
 					const s32 v20, const s32 v21, const s32 v22,
 					const s32 v30, const s32 v31, const s32 v32 );
 
-void gSPLightVertex(SPVertex & _vtx);
+void gSPLightVertex(SPVertex & _vtx, SPNormal & _normal);
 
 extern void (*gSPTransformVector)(float vtx[4], float mtx[4][4]);
 extern void (*gSPInverseTransformVector)(float vec[3], float mtx[4][4]);
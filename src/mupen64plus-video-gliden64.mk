@@ -31,7 +31,9 @@ MY_LOCAL_SRC_FILES :=
     $(SRCDIR)/DisplayLoadProgress.cpp                                              \
     $(SRCDIR)/FrameBuffer.cpp                                                      \
     $(SRCDIR)/FrameBufferInfo.cpp                                                  \
+    $(SRCDIR)/FrameCapture.cpp                                                     \
     $(SRCDIR)/GBI.cpp                                                              \
+    $(SRCDIR)/GBITrace.cpp                                                         \
     $(SRCDIR)/gDP.cpp                                                              \
     $(SRCDIR)/GLideN64.cpp                                                         \
     $(SRCDIR)/GraphicsDrawer.cpp                                                   \
@@ -46,7 +48,9 @@ MY_LOCAL_SRC_FILES :=
     $(SRCDIR)/PostProcessor.cpp                                                    \
     $(SRCDIR)/RDP.cpp                                                              \
     $(SRCDIR)/RSP.cpp                                                              \
+    $(SRCDIR)/ScreenReadback.cpp                                                   \
     $(SRCDIR)/SoftwareRender.cpp                                                   \
+    $(SRCDIR)/TexrectAtlas.cpp                                                     \
     $(SRCDIR)/TexrectDrawer.cpp                                                    \
     $(SRCDIR)/TextDrawer.cpp                                                       \
     $(SRCDIR)/TextureFilterHandler.cpp                                             \
@@ -78,6 +82,7 @@ MY_LOCAL_SRC_FILES :=
     $(SRCDIR)/Graphics/OpenGLContext/opengl_ContextImpl.cpp                        \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_GLInfo.cpp                             \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_Parameters.cpp                         \
+    $(SRCDIR)/Graphics/OpenGLContext/opengl_PixelWriteBufferWithBufferStorage.cpp  \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_TextureManipulationObjectFactory.cpp   \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_UnbufferedDrawer.cpp                   \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_Utils.cpp                              \
@@ -85,6 +90,7 @@ MY_LOCAL_SRC_FILES :=
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerProgramBuilder.cpp          \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerProgramImpl.cpp             \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerProgramUniformFactory.cpp   \
+    $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerUniformBlocks.cpp           \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_FXAA.cpp                            \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_ShaderStorage.cpp                   \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_SpecialShadersFactory.cpp           \
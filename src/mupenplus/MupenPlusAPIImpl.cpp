@@ -2,6 +2,7 @@
 #include "../PluginAPI.h"
 #include "../GLideN64.h"
 #include "../Config.h"
+#include "../Log.h"
 #include <DisplayWindow.h>
 
 #ifdef OS_WINDOWS
@@ -104,10 +105,10 @@ m64p_error PluginAPI::PluginStartup(m64p_dynlib_handle _CoreLibHandle)
 m64p_error PluginAPI::PluginShutdown()
 {
 #ifdef RSPTHREAD
-	_callAPICommand(acRomClosed);
-	delete m_pRspThread;
-	m_pRspThread = nullptr;
+	if (m_pRspThread != nullptr)
+		RomClosed();
 #endif
+	closeLog();
 	return M64ERR_SUCCESS;
 }
 
@@ -149,8 +150,3 @@ void PluginAPI::ResizeVideoOutput(int _Width, int _Height)
 {
 	dwnd().setWindowSize(_Width, _Height);
 }
-
-void PluginAPI::ReadScreen2(void * _dest, int * _width, int * _height, int _front)
-{
-	dwnd().readScreen2(_dest, _width, _height, _front);
-}
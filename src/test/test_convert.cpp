@@ -0,0 +1,179 @@
+// Compares the TMEM loaders of convert.cpp with their original scalar versions
+// on random sizes, offsets and masks, including unaligned heads and tails.
+// Usage: test_convert [iterations [seed]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "convert.h"
+
+static const u32 srcSize = 0x2000;
+static const u32 destSize = 0x1000;
+
+static
+void refUnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes)
+{
+	// copy leading bytes
+	u32 leadingBytes = srcIdx & 3;
+	if (leadingBytes != 0) {
+		leadingBytes = 4 - leadingBytes;
+		if ((u32)leadingBytes > numBytes)
+			leadingBytes = numBytes;
+		numBytes -= leadingBytes;
+
+		srcIdx ^= 3;
+		for (u32 i = 0; i < leadingBytes; i++) {
+			dest[destIdx&destMask] = src[srcIdx];
+			++destIdx;
+			--srcIdx;
+		}
+		srcIdx += 5;
+	}
+
+	// copy dwords
+	int numDWords = numBytes >> 2;
+	while (numDWords--) {
+		dest[(destIdx + 3) & destMask] = src[srcIdx++];
+		dest[(destIdx + 2) & destMask] = src[srcIdx++];
+		dest[(destIdx + 1) & destMask] = src[srcIdx++];
+		dest[(destIdx + 0) & destMask] = src[srcIdx++];
+		destIdx += 4;
+	}
+
+	// copy trailing bytes
+	int trailingBytes = numBytes & 3;
+	if (trailingBytes) {
+		srcIdx ^= 3;
+		for (int i = 0; i < trailingBytes; i++) {
+			dest[destIdx&destMask] = src[srcIdx];
+			++destIdx;
+			--srcIdx;
+		}
+	}
+}
+
+static
+void refDWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords)
+{
+	u32 p0, idx0, idx1;
+	while (numQWords--)	{
+		idx0 = srcIdx++ & srcMask;
+		idx1 = srcIdx++ & srcMask;
+		p0 = src[idx0];
+		src[idx0] = src[idx1];
+		src[idx1] = p0;
+	}
+}
+
+static u64 randState;
+
+static
+u32 nextRand()
+{
+	randState ^= randState >> 12;
+	randState ^= randState << 25;
+	randState ^= randState >> 27;
+	return u32((randState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Mostly the TMEM mask, sometimes a smaller power of two or any value
+static
+u32 randomMask(u32 _max)
+{
+	switch (nextRand() % 4) {
+	case 0:
+		return nextRand() % (_max + 1);
+	case 1:
+		return (_max >> (nextRand() % 8));
+	default:
+		return _max;
+	}
+}
+
+// Odd sizes and tails are more likely than whole blocks
+static
+u32 randomSize(u32 _max)
+{
+	switch (nextRand() % 4) {
+	case 0:
+		return nextRand() % 33;
+	case 1:
+		return (nextRand() % (_max >> 4)) << 4;
+	default:
+		return nextRand() % (_max + 1);
+	}
+}
+
+static
+void fill(std::vector<u8> & _buf)
+{
+	for (u8 & b : _buf)
+		b = u8(nextRand());
+}
+
+static
+bool check(const char * _name, u32 _iteration, const std::vector<u8> & _ref, const std::vector<u8> & _test,
+	u32 _srcIdx, u32 _destIdx, u32 _mask, u32 _numBytes, u32 _numQWords)
+{
+	if (memcmp(_ref.data(), _test.data(), _ref.size()) == 0)
+		return true;
+	u32 i = 0;
+	while (_ref[i] == _test[i])
+		++i;
+	printf("%s mismatch at iteration %u: srcIdx=%u destIdx=%u mask=0x%x numBytes=%u numQWords=%u, first difference at byte %u\n",
+		_name, _iteration, _srcIdx, _destIdx, _mask, _numBytes, _numQWords, i);
+	return false;
+}
+
+int main(int argc, char * argv[])
+{
+	const u32 iterations = argc > 1 ? u32(strtoul(argv[1], nullptr, 0)) : 200000;
+	randState = argc > 2 ? strtoull(argv[2], nullptr, 0) : 0x9E3779B97F4A7C15ULL;
+	if (randState == 0)
+		randState = 1;
+
+	std::vector<u8> src(srcSize + 16);
+	std::vector<u8> dest(destSize);
+	std::vector<u8> refDest(destSize);
+	u32 failures = 0;
+
+	for (u32 n = 0; n < iterations && failures < 10; ++n) {
+		fill(src);
+		fill(dest);
+		refDest = dest;
+
+		const u32 srcIdx = nextRand() % (srcSize / 2);
+		const u32 numBytes = randomSize(srcSize / 2);
+		const u32 destIdx = nextRand() % (destSize * 2);
+		const u32 destMask = randomMask(destSize - 1);
+		const u32 numQWords = randomSize(destSize / 8);
+
+		switch (n % 3) {
+		case 0:
+			refUnswapCopyWrap(src.data(), srcIdx, refDest.data(), destIdx, destMask, numBytes);
+			UnswapCopyWrap(src.data(), srcIdx, dest.data(), destIdx, destMask, numBytes);
+			if (!check("UnswapCopyWrap", n, refDest, dest, srcIdx, destIdx, destMask, numBytes, 0))
+				++failures;
+			break;
+		case 1:
+			refDWordInterleaveWrap((u32*)refDest.data(), destIdx >> 2, destMask >> 2, numQWords);
+			DWordInterleaveWrap((u32*)dest.data(), destIdx >> 2, destMask >> 2, numQWords);
+			if (!check("DWordInterleaveWrap", n, refDest, dest, 0, destIdx >> 2, destMask >> 2, 0, numQWords))
+				++failures;
+			break;
+		case 2:
+			refUnswapCopyWrap(src.data(), srcIdx, refDest.data(), destIdx, destMask, numBytes);
+			refDWordInterleaveWrap((u32*)refDest.data(), destIdx >> 2, destMask >> 2, numQWords);
+			UnswapCopyInterleaveWrap(src.data(), srcIdx, dest.data(), destIdx, destMask, numBytes, numQWords);
+			if (!check("UnswapCopyInterleaveWrap", n, refDest, dest, srcIdx, destIdx, destMask, numBytes, numQWords))
+				++failures;
+			break;
+		}
+	}
+
+	if (failures != 0)
+		return 1;
+	printf("%u iterations passed\n", iterations);
+	return 0;
+}
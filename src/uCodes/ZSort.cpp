@@ -256,13 +256,14 @@ void ZSort_Lighting( u32 _w0, u32 _w1 )
 	SPVertex * pVtx = drawer.getDMAVerticesData();
 	for (u32 i = 0; i < num; i++) {
 		SPVertex & vtx = pVtx[i];
-
-		vtx.nx = ((s8*)DMEM)[(nsrs++)^3];
-		vtx.ny = ((s8*)DMEM)[(nsrs++)^3];
-		vtx.nz = ((s8*)DMEM)[(nsrs++)^3];
-		TransformVectorNormalize( &vtx.nx, gSP.matrix.modelView[gSP.matrix.modelViewi] );
-		gSPLightVertex(vtx);
-		f32 fLightDir[3] = {vtx.nx, vtx.ny, vtx.nz};
+		SPNormal normal;
+
+		normal.x = ((s8*)DMEM)[(nsrs++)^3];
+		normal.y = ((s8*)DMEM)[(nsrs++)^3];
+		normal.z = ((s8*)DMEM)[(nsrs++)^3];
+		TransformVectorNormalize( &normal.x, gSP.matrix.modelView[gSP.matrix.modelViewi] );
+		gSPLightVertex(vtx, normal);
+		f32 fLightDir[3] = {normal.x, normal.y, normal.z};
 		TransformVectorNormalize(fLightDir, gSP.matrix.projection);
 		f32 x, y;
 		if (gSP.lookatEnable) {
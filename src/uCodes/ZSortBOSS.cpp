@@ -520,15 +520,16 @@ void ZSortBOSS_Lighting( u32 _w0, u32 _w1 )
 
 	for(u32 i = 0; i < num; i++) {
 		SPVertex & vtx = pVtx[i];
+		SPNormal normal;
 
-		vtx.nx = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
-		vtx.ny = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
-		vtx.nz = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
+		normal.x = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
+		normal.y = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
+		normal.z = _FIXED2FLOAT(((s8*)DMEM)[(nsrs++)^3],8);
 
 		// TODO: implement light vertex if ever needed
-		//gSPLightVertex(vtx);
+		//gSPLightVertex(vtx, normal);
 
-		f32 fLightDir[3] = {vtx.nx, vtx.ny, vtx.nz};
+		f32 fLightDir[3] = {normal.x, normal.y, normal.z};
 		f32 x, y;
 		x = DotProduct(gSP.lookat.xyz[0], fLightDir);
 		y = DotProduct(gSP.lookat.xyz[1], fLightDir);